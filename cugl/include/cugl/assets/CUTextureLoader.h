@@ -47,6 +47,8 @@
 #define __CU_TEXTURE_LOADER_H__
 #include <cugl/assets/CULoader.h>
 #include <cugl/render/CUTexture.h>
+#include <cugl/math/CURect.h>
+#include <vector>
 
 namespace cugl {
 
@@ -100,6 +102,49 @@ protected:
      * @param texture   The texture loaded for this asset
      */
     void parseAtlas(const std::shared_ptr<JsonValue>& json, const std::shared_ptr<Texture>& texture);
+
+    /**
+     * Loads and packs the images of a texture pack into a single page surface.
+     *
+     * A texture pack is a directory entry with a "pack" attribute in place of
+     * "file".  The pack maps asset keys to image files.  This method decodes
+     * every image and places them on shelves (tallest first) inside a page
+     * no larger than the "size" attribute (4096 by default), separated by
+     * "padding" transparent pixels (2 by default).  The page is only as large
+     * as the packed images require.
+     *
+     * Like {@link preload}, this method does not use OpenGL and is safe to
+     * call outside the main thread.  The pixel bounds of each image (with
+     * the origin at the top left) are stored in regions.
+     *
+     * @param json      The asset directory entry
+     * @param regions   The key and pixel bounds of each packed image
+     *
+     * @return the SDL_Surface with the page, or nullptr if packing failed
+     */
+    SDL_Surface* preloadPack(const std::shared_ptr<JsonValue>& json,
+                             std::vector<std::pair<std::string,Rect>>& regions);
+    
+    /**
+     * Creates an OpenGL texture for a packed page, together with its regions.
+     *
+     * This method finishes the asset loading started in {@link preloadPack}.
+     * The page is assigned the key of the directory entry, while each region
+     * is a subtexture of the page assigned the key of its packed image.  As
+     * all regions share the same texture buffer, the sprite batch can draw
+     * them without flushing.
+     *
+     * This method supports an optional callback function which reports whether
+     * the asset was successfully materialized.
+     *
+     * @param json      The asset directory entry
+     * @param surface   The SDL_Surface with the page (may be nullptr)
+     * @param regions   The key and pixel bounds of each packed image
+     * @param callback  An optional callback for asynchronous loading
+     */
+    void materializePack(const std::shared_ptr<JsonValue>& json, SDL_Surface* surface,
+                         const std::vector<std::pair<std::string,Rect>>& regions,
+                         LoaderCallback callback);
     
     /**
      * Loads the portion of this asset that is safe to load outside the main thread.
@@ -209,6 +254,10 @@ protected:
      *      "wrapS":        The s-coord wrap rule ("clamp", "repeat", or "mirrored")
      *      "wrapT":        The t-coord wrap rule ("clamp", "repeat", or "mirrored")
      *
+     * Alternatively, the entry may have a "pack" in place of a "file".  This
+     * is a map from asset keys to image files, which are packed into a single
+     * page at load time (see {@link preloadPack}).
+     *
      * @param json      The directory entry for the asset
      * @param callback  An optional callback for asynchronous loading
      * @param async     Whether the asset was loaded asynchronously
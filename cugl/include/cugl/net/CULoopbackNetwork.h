@@ -0,0 +1,407 @@
+//
+//  CULoopbackNetwork.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an in-process transport for NetworkConnection. A host
+//  and any number of clients can share a single loopback network, and talk to
+//  each other without the NAT punchthrough server or a network at all. The
+//  network delivers the packets after a simulated latency, and can add jitter,
+//  packet loss and reordering, so that netcode can be tested and measured under
+//  poor network conditions on a single machine.
+//
+//  The network has its own clock, which only advances with calls to update. So
+//  a scripted test can run any number of simulated seconds as fast as it likes,
+//  and the results are repeatable for a given random seed.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+#ifndef __CU_LOOPBACK_NETWORK_H__
+#define __CU_LOOPBACK_NETWORK_H__
+
+#include <bitset>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <slikenet/PacketPriority.h>
+
+namespace cugl {
+
+/**
+ * This class is an in-process network shared by a host and its clients.
+ *
+ * A {@link NetworkConnection} allocated with a loopback network sends its
+ * packets through this object instead of Slikenet. The network is a star, as
+ * the real one is: the host talks to every client, and a client only talks
+ * to the host (which relays the messages meant for everyone).
+ *
+ * Every link between the host and a client has its own network conditions,
+ * which default to the conditions of the network. A packet is delivered after
+ * the latency of its link, plus a random amount of jitter. Unreliable packets
+ * may be lost, while reliable ones are resent after a timeout, which delays
+ * them instead. Ordered packets are never delivered before the packets sent
+ * ahead of them on their channel, and sequenced packets are dropped if a newer
+ * one on their channel was delivered first. Reordering holds a packet back for
+ * an extra latency, so that the packets sent after it overtake it.
+ *
+ * The network has a single room, and its clock only advances with calls to
+ * {@link #update}. The owner of the network must call that method every frame
+ * (or every simulated frame in a test).
+ */
+class LoopbackNetwork {
+#pragma mark Support Structures
+public:
+    /**
+     * The simulated conditions of a link between the host and a client.
+     *
+     * All times are one way, so a round trip takes twice the latency.
+     */
+    struct Conditions {
+        /** The time (in seconds) a packet takes to arrive */
+        float latency;
+        /** The largest extra time (in seconds) a packet may take, chosen uniformly */
+        float jitter;
+        /** The probability that a packet is lost (or must be resent, if reliable) */
+        float loss;
+        /** The probability that a packet is held back, so that later packets overtake it */
+        float reorder;
+
+        /**
+         * Creates the conditions of a perfect link
+         */
+        Conditions() : latency(0), jitter(0), loss(0), reorder(0) {}
+
+        /**
+         * Creates the conditions of a link with the given properties
+         *
+         * @param latency   The time (in seconds) a packet takes to arrive
+         * @param jitter    The largest extra time (in seconds) a packet may take
+         * @param loss      The probability that a packet is lost
+         * @param reorder   The probability that a packet is held back
+         */
+        Conditions(float latency, float jitter, float loss, float reorder) :
+        latency(latency), jitter(jitter), loss(loss), reorder(reorder) {}
+    };
+
+    /**
+     * The traffic counted by the network since it was initialized
+     */
+    struct Stats {
+        /** The number of packets sent */
+        size_t sent;
+        /** The number of packets delivered */
+        size_t delivered;
+        /** The number of unreliable packets lost */
+        size_t lost;
+        /** The number of sequenced packets dropped for arriving after a newer one */
+        size_t superseded;
+        /** The number of times a reliable packet was resent */
+        size_t resent;
+        /** The number of bytes delivered */
+        size_t bytes;
+
+        /**
+         * Creates empty traffic counts
+         */
+        Stats() : sent(0), delivered(0), lost(0), superseded(0), resent(0), bytes(0) {}
+    };
+
+    /**
+     * A packet as it is delivered by the network.
+     */
+    struct Packet {
+        /** The player ID of the sender */
+        uint8_t from;
+        /** The player ID of the receiver */
+        uint8_t to;
+        /** The packet type, which the network does not interpret */
+        uint8_t type;
+        /** The packet reliability */
+        PacketReliability reliability;
+        /** The ordering channel */
+        uint8_t channel;
+        /** The packet contents */
+        std::vector<uint8_t> data;
+        /** The network time that the packet arrives at */
+        float arrival;
+        /** The order the packet was sent in, which breaks ties in arrival */
+        size_t order;
+        /** The position of the packet in its sequenced stream */
+        size_t sequence;
+    };
+
+private:
+    /** A stream of packets, by sender, receiver and channel */
+    typedef std::tuple<uint8_t, uint8_t, uint8_t> Stream;
+
+    /** The current network time (in seconds) */
+    float _time;
+    /** The random number generator for the simulated conditions */
+    std::mt19937 _random;
+    /** The conditions of every link without its own conditions */
+    Conditions _conditions;
+    /** The conditions of the link to each client (by player ID) */
+    std::unordered_map<uint8_t, Conditions> _links;
+    /** The traffic counted since initialization */
+    Stats _stats;
+
+    /** The room ID, or empty if there is no host */
+    std::string _roomID;
+    /** The maximum number of players (including the host) */
+    uint32_t _maxPlayers;
+    /** Whether the game has started, so that no more clients may join */
+    bool _started;
+    /** The players that are currently connected */
+    std::bitset<256> _players;
+
+    /** The packets that have not arrived yet */
+    std::vector<Packet> _inflight;
+    /** The number of packets sent, used to order them */
+    size_t _order;
+    /** The last sequence number sent on each stream */
+    std::map<Stream, size_t> _sentSequence;
+    /** The newest sequence number delivered on each stream */
+    std::map<Stream, size_t> _deliveredSequence;
+    /** The arrival time of the last ordered packet sent on each stream */
+    std::map<Stream, float> _orderedArrival;
+
+#pragma mark Constructors
+public:
+    /**
+     * Creates a degenerate loopback network.
+     *
+     * The network has no random seed and cannot be used.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    LoopbackNetwork();
+
+    /**
+     * Deletes this loopback network, disposing all resources
+     */
+    ~LoopbackNetwork() { dispose(); }
+
+    /**
+     * Disposes all of the resources used by this loopback network.
+     *
+     * Any packets in flight are lost, and every player is disconnected.
+     */
+    void dispose();
+
+    /**
+     * Initializes a loopback network with perfect links.
+     *
+     * The seed determines the simulated conditions, so that a test run
+     * with the same seed (and the same traffic) behaves the same way.
+     *
+     * @param seed  The random seed of the simulated conditions
+     *
+     * @return true if initialization was successful
+     */
+    bool init(uint32_t seed = 0);
+
+    /**
+     * Returns a newly allocated loopback network with perfect links.
+     *
+     * The seed determines the simulated conditions, so that a test run
+     * with the same seed (and the same traffic) behaves the same way.
+     *
+     * @param seed  The random seed of the simulated conditions
+     *
+     * @return a newly allocated loopback network with perfect links.
+     */
+    static std::shared_ptr<LoopbackNetwork> alloc(uint32_t seed = 0) {
+        std::shared_ptr<LoopbackNetwork> result = std::make_shared<LoopbackNetwork>();
+        return (result->init(seed) ? result : nullptr);
+    }
+
+#pragma mark Network Conditions
+    /**
+     * Returns the conditions of every link without its own conditions
+     *
+     * @return the conditions of every link without its own conditions
+     */
+    const Conditions& getConditions() const { return _conditions; }
+
+    /**
+     * Sets the conditions of every link without its own conditions
+     *
+     * This only affects the packets sent from now on.
+     *
+     * @param conditions    The conditions of every link without its own conditions
+     */
+    void setConditions(const Conditions& conditions) { _conditions = conditions; }
+
+    /**
+     * Returns the conditions of the link between the host and a client
+     *
+     * @param playerID  The player ID of the client
+     *
+     * @return the conditions of the link between the host and a client
+     */
+    const Conditions& getConditions(uint8_t playerID) const;
+
+    /**
+     * Sets the conditions of the link between the host and a client
+     *
+     * This only affects the packets sent from now on.
+     *
+     * @param playerID      The player ID of the client
+     * @param conditions    The conditions of the link
+     */
+    void setConditions(uint8_t playerID, const Conditions& conditions) { _links[playerID] = conditions; }
+
+    /**
+     * Returns the traffic counted since initialization
+     *
+     * @return the traffic counted since initialization
+     */
+    const Stats& getStats() const { return _stats; }
+
+    /**
+     * Returns the current network time (in seconds)
+     *
+     * @return the current network time (in seconds)
+     */
+    float getTime() const { return _time; }
+
+    /**
+     * Advances the network time, so that the packets due by then can be received
+     *
+     * @param timestep  The time (in seconds) to advance
+     */
+    void update(float timestep) { _time += timestep; }
+
+#pragma mark Connections
+    /**
+     * Returns the room ID of the host, or the empty string if there is none
+     *
+     * @return the room ID of the host, or the empty string if there is none
+     */
+    const std::string& getRoomID() const { return _roomID; }
+
+    /**
+     * Opens the room of a new host, returning its room ID
+     *
+     * The host is always player 0. This method fails (returning the empty
+     * string) if the network already has a host.
+     *
+     * @param maxPlayers    The maximum number of players (including the host)
+     *
+     * @return the room ID of the host, or the empty string on failure
+     */
+    std::string host(uint32_t maxPlayers);
+
+    /**
+     * Joins the room with the given ID, returning the assigned player ID
+     *
+     * This fails if there is no such room, if the room is full, or if the
+     * game has already started.
+     *
+     * @param roomID    The room ID of the host
+     *
+     * @return the assigned player ID, or empty on failure
+     */
+    std::optional<uint8_t> join(const std::string& roomID);
+
+    /**
+     * Disconnects a player, losing every packet to or from it
+     *
+     * If the player is the host, the room closes and every client is
+     * disconnected too.
+     *
+     * @param playerID  The player to disconnect
+     */
+    void leave(uint8_t playerID);
+
+    /**
+     * Marks the game as started, so that no more clients may join
+     */
+    void start() { _started = true; }
+
+    /**
+     * Returns the players that are currently connected
+     *
+     * @return the players that are currently connected
+     */
+    const std::bitset<256>& getPlayers() const { return _players; }
+
+#pragma mark Packets
+    /**
+     * Sends a packet from one player to another
+     *
+     * One of the players must be the host, as the network is a star. The
+     * packet arrives after the simulated conditions of their link.
+     *
+     * @param from          The player ID of the sender
+     * @param to            The player ID of the receiver
+     * @param type          The packet type, which the network does not interpret
+     * @param data          The packet contents
+     * @param reliability   The packet reliability
+     * @param channel       The ordering channel
+     */
+    void send(uint8_t from, uint8_t to, uint8_t type, const std::vector<uint8_t>& data,
+              PacketReliability reliability, uint8_t channel);
+
+    /**
+     * Receives the next packet that has arrived for a player
+     *
+     * Packets arrive in the order of their arrival times, and sequenced
+     * packets that arrive after a newer one are dropped here.
+     *
+     * @param playerID  The player ID of the receiver
+     * @param packet    The packet to store the result in
+     *
+     * @return true if a packet was received
+     */
+    bool receive(uint8_t playerID, Packet& packet);
+
+private:
+    /**
+     * Returns a uniform random number in [0,1)
+     *
+     * @return a uniform random number in [0,1)
+     */
+    float random();
+};
+
+}
+
+#endif /* __CU_LOOPBACK_NETWORK_H__ */
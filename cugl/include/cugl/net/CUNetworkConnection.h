@@ -61,6 +61,10 @@ namespace SLNet {
 }
 
 namespace cugl {
+
+// Forward declarations
+class LoopbackNetwork;
+
 /**
  * A class to support a connection to other players with a peer-to-peer interface.
  *
@@ -296,6 +300,9 @@ private:
     
     /** The default reliability of this connetion */
     PacketReliability _reliability;
+
+    /** The in-process network replacing Slikenet, or nullptr for a real connection */
+    std::shared_ptr<LoopbackNetwork> _loopback;
     
 #pragma mark Constructors
 public:
@@ -393,6 +400,78 @@ public:
         return (result->init(config, roomID) ? result : nullptr);
     }
 
+    /**
+     * Initializes a new network connection as host on a loopback network.
+     *
+     * The connection sends its packets through the given in-process network
+     * instead of Slikenet, so the punchthrough server address in the config
+     * is ignored. Unlike a real connection, it is CONNECTED (with its room ID)
+     * as soon as this method returns.
+     *
+     * @param setup     Connection config
+     * @param loopback  The loopback network to host a room on
+     *
+     * @return true if initialization was successful
+     */
+    bool init(ConnectionConfig config, const std::shared_ptr<LoopbackNetwork>& loopback);
+
+    /**
+     * Initializes a new network connection as a client on a loopback network.
+     *
+     * The connection sends its packets through the given in-process network
+     * instead of Slikenet, so the punchthrough server address in the config
+     * is ignored. Unlike a real connection, it is CONNECTED (or has failed to
+     * find the room) as soon as this method returns.
+     *
+     * @param setup     Connection config
+     * @param loopback  The loopback network of the host
+     * @param roomID    Host's assigned Room ID
+     *
+     * @return true if initialization was successful
+     */
+    bool init(ConnectionConfig config, const std::shared_ptr<LoopbackNetwork>& loopback,
+              const std::string roomID);
+
+    /**
+     * Returns a newly allocated network connection as host on a loopback network.
+     *
+     * The connection sends its packets through the given in-process network
+     * instead of Slikenet, so the punchthrough server address in the config
+     * is ignored. Unlike a real connection, it is CONNECTED (with its room ID)
+     * as soon as this method returns.
+     *
+     * @param setup     Connection config
+     * @param loopback  The loopback network to host a room on
+     *
+     * @return a newly allocated network connection as host on a loopback network.
+     */
+    static std::shared_ptr<NetworkConnection> alloc(ConnectionConfig config,
+                                                    const std::shared_ptr<LoopbackNetwork>& loopback) {
+        std::shared_ptr<NetworkConnection> result = std::make_shared<NetworkConnection>();
+        return (result->init(config, loopback) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated network connection as a client on a loopback network.
+     *
+     * The connection sends its packets through the given in-process network
+     * instead of Slikenet, so the punchthrough server address in the config
+     * is ignored. Unlike a real connection, it is CONNECTED (or has failed to
+     * find the room) as soon as this method returns.
+     *
+     * @param setup     Connection config
+     * @param loopback  The loopback network of the host
+     * @param roomID    Host's assigned Room ID
+     *
+     * @return a newly allocated network connection as a client on a loopback network.
+     */
+    static std::shared_ptr<NetworkConnection> alloc(ConnectionConfig config,
+                                                    const std::shared_ptr<LoopbackNetwork>& loopback,
+                                                    const std::string roomID) {
+        std::shared_ptr<NetworkConnection> result = std::make_shared<NetworkConnection>();
+        return (result->init(config, loopback, roomID) ? result : nullptr);
+    }
+
 
 #pragma mark Main Networking Methods
     /**
@@ -428,6 +507,41 @@ public:
      */
     void sendOnlyToHost(const std::vector<uint8_t>& msg);
 
+    /**
+     * Sends a byte array to all other players with the given reliability.
+     *
+     * This is the same as {@link #send}, except that the reliability is chosen
+     * for this message alone instead of using the connection reliability. This
+     * allows a game to send frequent state updates (which may be lost, as a newer
+     * one will follow) as UNRELIABLE_SEQUENCED, while still sending important
+     * events as RELIABLE_ORDERED. The unreliable types are only permitted once
+     * the connection is established.
+     *
+     * Messages are ordered or sequenced only relative to other messages on the
+     * same ordering channel (0-31), so that a lost packet on one channel does not
+     * delay the messages on another. The connection reliability uses channel 1.
+     * The host relays a message with the same reliability and channel that the
+     * sender chose.
+     *
+     * @param msg           The byte array to send.
+     * @param reliability   The packet reliability of this message
+     * @param channel       The ordering channel of this message
+     */
+    void send(const std::vector<uint8_t>& msg, PacketReliability reliability, uint8_t channel = 1);
+
+    /**
+     * Sends a byte array to the host only with the given reliability.
+     *
+     * This is the same as {@link #sendOnlyToHost}, except that the reliability
+     * and ordering channel are chosen for this message alone. See the three
+     * argument version of {@link #send} for details.
+     *
+     * @param msg           The byte array to send.
+     * @param reliability   The packet reliability of this message
+     * @param channel       The ordering channel of this message
+     */
+    void sendOnlyToHost(const std::vector<uint8_t>& msg, PacketReliability reliability, uint8_t channel = 1);
+
     /**
      * Receives incoming network messages.
      *
@@ -463,7 +577,8 @@ public:
      * to one of RELIABLE, RELIABLE_ORDERED, or RELIABLE_SEQUENCED. The
      * value RELIABLE_ORDERED is the default. Note that changing this
      * value will only effect future calls to {@link #send} and
-     * {@link #sendOnlyToHost}.
+     * {@link #sendOnlyToHost} that do not
+     * specify their own reliability.
      *
      * RELIABLE: Packets are all received, but not necessarily in order.
      * So if A is sent before B, B may come first, with A coming after.
@@ -498,7 +613,8 @@ public:
      * to one of RELIABLE, RELIABLE_ORDERED, or RELIABLE_SEQUENCED. The
      * value RELIABLE_ORDERED is the default. Note that changing this
      * value will only effect future calls to {@link #send} and
-     * {@link #sendOnlyToHost}.
+     * {@link #sendOnlyToHost} that do not
+     * specify their own reliability.
      *
      * RELIABLE: Packets are all received, but not necessarily in order.
      * So if A is sent before B, B may come first, with A coming after.
@@ -620,21 +736,30 @@ private:
      * @param packetType Packet type from RakNet
      * @param msg The message to send
      * @param ignore The address to not send to
+     * @param reliability The packet reliability
+     * @param channel The ordering channel
      */
     void broadcast(const std::vector<uint8_t>& msg,
                    SLNet::SystemAddress& ignore,
-                   CustomDataPackets packetType = Standard);
+                   CustomDataPackets packetType,
+                   PacketReliability reliability,
+                   uint8_t channel);
 
     /**
      * Sends a message to all connected players
      *
-     * This method can be called by either connection.
+     * This method can be called by either connection. Standard messages end
+     * with their reliability and channel, so that the host can relay them.
      *
      * @param msg The message to send
-     * @param ignore The address to not send to
+     * @param packetType The type of custom data packet
+     * @param reliability The packet reliability
+     * @param channel The ordering channel
      */
     void send(const std::vector<uint8_t>& msg,
-              CustomDataPackets packetType);
+              CustomDataPackets packetType,
+              PacketReliability reliability,
+              uint8_t channel);
 
     /**
      * Sends a message to just one connection.
@@ -647,6 +772,32 @@ private:
                     CustomDataPackets packetType,
                     SLNet::SystemAddress dest);
 
+    /**
+     * Sends a message through the loopback network.
+     *
+     * The host sends the message to every client, while a client sends it
+     * to the host (which relays standard messages to everyone else).
+     *
+     * @param msg The message to send
+     * @param packetType The type of custom data packet
+     * @param reliability The packet reliability
+     * @param channel The ordering channel
+     */
+    void sendLoopback(const std::vector<uint8_t>& msg,
+                      CustomDataPackets packetType,
+                      PacketReliability reliability,
+                      uint8_t channel);
+
+    /**
+     * Receives the messages that have arrived through the loopback network.
+     *
+     * The connected players are taken from the loopback network, as there
+     * is no handshake to announce them.
+     *
+     * @param dispatcher    The function to process received data
+     */
+    void receiveLoopback(const std::function<void(const std::vector<uint8_t>&)>& dispatcher);
+
     /**
      * Attempts to reconnect to the host.
      *
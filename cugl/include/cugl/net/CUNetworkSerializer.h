@@ -138,6 +138,10 @@ class NetworkSerializer {
 private:
     /** Buffer of data that has not been written out yet. */
     std::vector<uint8_t> _data;
+    /** Position in the data of the byte receiving packed bits */
+    size_t _bitByte;
+    /** Number of bits already used in the byte receiving packed bits (8 when there is none) */
+    int _bitCount;
 
 public:
     /**
@@ -147,7 +151,7 @@ public:
      * to use an init method. However, we do include a static {@link #alloc} method
      * for creating shared pointers.
      */
-    NetworkSerializer() {} 
+    NetworkSerializer() : _bitByte(0), _bitCount(8) {}
 
     /**
      * Returns a newly created Network Serializer.
@@ -386,6 +390,48 @@ public:
      */
     void writeJsonVector(std::vector<std::shared_ptr<JsonValue>> j);
 
+    /**
+     * Writes the low order bits of an unsigned value.
+     *
+     * Unlike the other write methods, packed values have no type header, and
+     * consecutive packed values share bytes. So a boolean flag only costs a
+     * single bit. They must be read back with {@link NetworkDeserializer#readBits}
+     * using the same bit counts. Packed values never share a byte with any
+     * other value, whether it was written before or after them.
+     *
+     * @param value The value to write
+     * @param bits  The number of bits to write (at most 32)
+     */
+    void writeBits(Uint32 value, int bits);
+    
+    /**
+     * Writes a float quantized to the given number of bits.
+     *
+     * The value is clamped to the range [min,max] and stored as a packed value
+     * (see {@link #writeBits}). It must be read back with
+     * {@link NetworkDeserializer#readQuantized} using the same range and bits.
+     *
+     * @param value The value to write
+     * @param min   The minimum value of the range
+     * @param max   The maximum value of the range
+     * @param bits  The number of bits to write (at most 32)
+     */
+    void writeQuantized(float value, float min, float max, int bits);
+    
+    /**
+     * Returns the integer a float is quantized to by {@link #writeQuantized}.
+     *
+     * This is useful to compare values at the precision they are sent with.
+     *
+     * @param value The value to quantize
+     * @param min   The minimum value of the range
+     * @param max   The maximum value of the range
+     * @param bits  The number of bits (at most 32)
+     *
+     * @return the integer a float is quantized to by {@link #writeQuantized}.
+     */
+    static Uint32 quantize(float value, float min, float max, int bits);
+
     /**
      * Returns a byte vector of all written values suitable for network transit.
      *
@@ -426,6 +472,10 @@ private:
     std::vector<uint8_t> _data;
     /** Position in the data of next byte to read */
     size_t _pos;
+    /** Position in the data of the byte supplying packed bits */
+    size_t _bitByte;
+    /** Number of bits already read from the byte supplying packed bits (8 when there is none) */
+    int _bitCount;
 
 public:
     /**
@@ -467,7 +517,7 @@ public:
      * to use an init method. However, we do include a static {@link #alloc} method
      * for creating shared pointers.
      */
-    NetworkDeserializer() : _pos(0) {}
+    NetworkDeserializer() : _pos(0), _bitByte(0), _bitCount(8) {}
 
     /**
      * Returns a newly created Network Deserializer.
@@ -767,6 +817,47 @@ public:
      */
     std::vector<std::shared_ptr<JsonValue>> readJsonVector();
 
+    /**
+     * Returns an unsigned value written by {@link NetworkSerializer#writeBits}.
+     *
+     * Packed values have no type header, so {@link #nextType} cannot detect
+     * them. The bit counts must match those used to write the values, or the
+     * stream will be corrupted.
+     *
+     * The method advances the read position. If called when no more data is
+     * available, the missing bits are read as 0.
+     *
+     * @param bits  The number of bits to read (at most 32)
+     *
+     * @return an unsigned value written by {@link NetworkSerializer#writeBits}.
+     */
+    Uint32 readBits(int bits);
+    
+    /**
+     * Returns a float written by {@link NetworkSerializer#writeQuantized}.
+     *
+     * The range and bits must match those used to write the value.
+     *
+     * @param min   The minimum value of the range
+     * @param max   The maximum value of the range
+     * @param bits  The number of bits to read (at most 32)
+     *
+     * @return a float written by {@link NetworkSerializer#writeQuantized}.
+     */
+    float readQuantized(float min, float max, int bits);
+    
+    /**
+     * Returns the float for an integer quantized by {@link NetworkSerializer#quantize}.
+     *
+     * @param value The quantized value
+     * @param min   The minimum value of the range
+     * @param max   The maximum value of the range
+     * @param bits  The number of bits (at most 32)
+     *
+     * @return the float for an integer quantized by {@link NetworkSerializer#quantize}.
+     */
+    static float dequantize(Uint32 value, float min, float max, int bits);
+
     /**
      * Clears the buffer and ignore any remaining data in it.
      */
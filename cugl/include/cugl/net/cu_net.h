@@ -28,6 +28,7 @@
 #ifndef __CU_NET_PKG_H__
 #define __CU_NET_PKG_H__
 
+#include "CULoopbackNetwork.h"
 #include "CUNetworkConnection.h"
 #include "CUNetworkSerializer.h"
 
@@ -544,7 +544,7 @@ public:
     virtual void setEnabled(bool value) override {
         if (_realbody != nullptr && _drawbody != nullptr) {
             _realbody->SetEnabled(value);
-            _drawbody->SetEnabled(value);
+            _drawbody->SetEnabled(value && _interpolated);
         }
         else {
             _bodyinfo.enabled = value;
@@ -931,6 +931,19 @@ public:
      */
     virtual void setFilterData(b2Filter value) override;
     
+    /**
+     * Sets the user data stored in the fixtures of this object
+     *
+     * Box2D lets each fixture carry a single integer (or pointer) of user data.
+     * The body user data is reserved for this obstacle, but the fixture user
+     * data is free for the game, and is typically used to identify an object
+     * in a contact callback without searching for it. This only affects the fixtures of
+     * the root body, not those of the composite structure.
+     *
+     * @param value  the user data stored in the fixtures of this object
+     */
+    virtual void setUserData(uintptr_t value) override;
+    
     
 #pragma mark -
 #pragma mark MassData Methods
@@ -1086,7 +1099,7 @@ public:
     *
     * @return a (weak) reference to Box2D body for this obstacle.
     */
-    virtual b2Body* getDrawBody() override { return _realbody; }
+    virtual b2Body* getDrawBody() override { return _drawbody; }
 
     /*
     * Returns the necessary BodyData class in order to update this body in another game instance
@@ -1102,6 +1115,16 @@ public:
     * Syncs the real and draw bodies together.
     */
     virtual void syncBodies() override;
+
+    /**
+     * Sets whether the draw body is simulated for the remaining frame time.
+     *
+     * If this is false, the draw body is disabled, so that it is out of the
+     * broad-phase of the draw world.
+     *
+     * @param value whether the draw body is simulated
+     */
+    virtual void setInterpolated(bool value) override;
     
     /**
      * Returns the collection of component physics objects.
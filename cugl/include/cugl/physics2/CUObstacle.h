@@ -106,6 +106,8 @@ protected:
     unsigned long _id;
     /** (Singular) callback function for state updates */
     std::function<void(Obstacle* obstacle)> _listener;
+    /** Whether the draw body is simulated, or is only a disabled copy of the real body */
+    bool _interpolated;
 
 #pragma mark -
 #pragma mark Scene Graph Internals
@@ -127,6 +129,17 @@ protected:
      */
     virtual void updateDebug();
 
+    /**
+     * Copies the body, fixture and mass settings of the given obstacle.
+     *
+     * This is used by {@link clone} in the subclasses. It does not copy the
+     * shape, the id, the listener, or the debug wireframe. The copy is not
+     * marked for removal and is not dirty.
+     *
+     * @param other The obstacle to copy
+     */
+    void copySettings(const Obstacle& other);
+
     
 private:
     /// Track garbage collection status
@@ -176,6 +189,25 @@ public:
     virtual bool init(const Vec2 vec);
 
     
+#pragma mark -
+#pragma mark Cloning
+    /**
+     * Returns a new obstacle with the same shape and settings as this one.
+     *
+     * The clone is not part of any world and has no debug wireframe. If this
+     * obstacle has a body, the clone starts with the current body state
+     * (position, velocity, and so on). Subclasses share immutable geometry
+     * with the original whenever possible, so cloning is much cheaper than
+     * allocating an obstacle with the same shape.
+     *
+     * This base class has no shape information, so this method returns
+     * nullptr. Subclasses that know their shape override it.
+     *
+     * @return a new obstacle with the same shape and settings as this one.
+     */
+    virtual std::shared_ptr<Obstacle> clone() const { return nullptr; }
+
+    
 #pragma mark -
 #pragma mark BodyDef Methods
     /**
@@ -711,6 +743,30 @@ public:
      */
     virtual void setFilterData(b2Filter value) { _fixture.filter = value; }
     
+    /**
+     * Returns the user data stored in the fixtures of this object
+     *
+     * Box2D lets each fixture carry a single integer (or pointer) of user data.
+     * The body user data is reserved for this obstacle, but the fixture user
+     * data is free for the game, and is typically used to identify an object
+     * in a contact callback without searching for it.
+     *
+     * @return the user data stored in the fixtures of this object
+     */
+    uintptr_t getUserData() const { return _fixture.userData.pointer; }
+    
+    /**
+     * Sets the user data stored in the fixtures of this object
+     *
+     * Box2D lets each fixture carry a single integer (or pointer) of user data.
+     * The body user data is reserved for this obstacle, but the fixture user
+     * data is free for the game, and is typically used to identify an object
+     * in a contact callback without searching for it.
+     *
+     * @param value  the user data stored in the fixtures of this object
+     */
+    virtual void setUserData(uintptr_t value) { _fixture.userData.pointer = value; }
+    
     
 #pragma mark -
 #pragma mark MassData Methods
@@ -879,6 +935,27 @@ public:
      * Syncs the real and draw bodies together.
      */
     virtual void syncBodies() {}
+
+    /**
+     * Returns true if the draw body is simulated for the remaining frame time.
+     *
+     * This is set by the {@link ObstacleWorld}, and is false when the world
+     * does not interpolate.
+     *
+     * @return true if the draw body is simulated for the remaining frame time.
+     */
+    bool isInterpolated() const { return _interpolated; }
+
+    /**
+     * Sets whether the draw body is simulated for the remaining frame time.
+     *
+     * If this is false, the draw body is disabled, so that it is out of the
+     * broad-phase of the draw world. It still follows the real body when the
+     * bodies are synced, so drawing reads the state of the last real step.
+     *
+     * @param value whether the draw body is simulated
+     */
+    virtual void setInterpolated(bool value) { _interpolated = value; }
     
     /**
      * Creates the physics Body(s) for this object, adding them to the world.
@@ -52,6 +52,10 @@
 class b2World;
 
 namespace cugl {
+    // Forward declarations of the network serializers
+    class NetworkSerializer;
+    class NetworkDeserializer;
+
     /**
      * The classes to represent 2-d physics.
      *
@@ -72,6 +76,8 @@ class Obstacle;
 #define DEFAULT_WORLD_POSIT 2
 /** Default number of splits in our time step */
 #define DEFAULT_SPLITS 10;
+/** Default maximum number of mini steps in a single update */
+#define DEFAULT_MAX_STEPS 60
 
 
 #pragma mark -
@@ -99,8 +105,12 @@ protected:
     float _stepssize;
     /** The amount of times to split up our steps */
     int _stepsplits;
+    /** The maximum number of mini steps in a single update */
+    int _maxsteps;
     /** The left over time that needs to be iterated for next frame */
     float _remainingtime;
+    /** Whether the draw world is stepped by the left over time */
+    bool _interpolated;
     /** The number of velocity iterations for the constrain solvers per ministep */
     int _itvelocity;
     /** The number of position iterations for the constrain solvers per ministep*/
@@ -108,10 +118,44 @@ protected:
     /** The current gravitational value of the world */
     Vec2 _gravity;
     
-    /** The list of real objects in this world. This is a hashmap that maps object IDs to Obstacles. */
-    std::unordered_map<unsigned long, std::shared_ptr<Obstacle>> _objects;
-    /** The total number of objects added to this world. This is our IDing function for new obstacles */
-    unsigned long _objectsAdded;
+    /** A slot of the obstacle storage, which retains the obstacle in it */
+    struct Slot {
+        /** The obstacle in this slot, or nullptr if the slot is free */
+        std::shared_ptr<Obstacle> obstacle;
+        /** The generation of this slot, which changes every time it is freed */
+        unsigned long generation;
+        /** The position of the obstacle in its packed list */
+        size_t index;
+        /** Whether the obstacle is in the static list */
+        bool isStatic;
+        /** The body state at the last replication keyframe */
+        BodyNetData baseline;
+        /** Whether the baseline was recorded for the current keyframe */
+        bool hasBaseline;
+        /** Whether the body was in the state message being read */
+        bool received;
+    };
+    /** The obstacle storage. The id of an obstacle is a handle to its slot. */
+    std::vector<Slot> _slots;
+    /** The slots that are free, which are reused before the storage grows */
+    std::vector<unsigned long> _freeslots;
+    /** The obstacles that were not static when added, packed for the per-frame loops */
+    std::vector<Obstacle*> _dynamics;
+    /** The obstacles that were static when added, which the per-frame loops skip */
+    std::vector<Obstacle*> _statics;
+
+    /** The sequence number of the last replication keyframe */
+    Uint8 _keyframeID;
+    /** Whether a replication keyframe has been written or read */
+    bool _hasKeyframe;
+    /** The largest replicated speed; faster bodies are clamped to it */
+    float _stateSpeed;
+    /** The number of bits of each replicated position component */
+    int _positionBits;
+    /** The number of bits of a replicated angle */
+    int _angleBits;
+    /** The number of bits of each replicated velocity component */
+    int _velocityBits;
     
     /** The boundary of the world */
     Rect _bounds;
@@ -122,6 +166,54 @@ protected:
     bool _filters;
     /** Whether or not to activate the destruction listener */
     bool _destroy;
+
+    /**
+     * Returns true if the draw body of the obstacle may differ from its real body.
+     *
+     * The setters of an obstacle write both of its bodies, so only the physics
+     * step can make them differ. A body that is asleep in both worlds was not
+     * moved by it, and neither was a static one.
+     *
+     * @param obj   The obstacle to check
+     *
+     * @return true if the draw body of the obstacle may differ from its real body.
+     */
+    static bool needsSync(Obstacle* obj);
+
+    /**
+     * Returns the slot of the obstacle with the given handle, or nullptr if there is none.
+     *
+     * The handle must match the generation of the slot, so the handle of a
+     * removed obstacle never finds the obstacle that reused its slot.
+     *
+     * @param handle    The handle (id) of an obstacle
+     *
+     * @return the slot of the obstacle with the given handle, or nullptr if there is none.
+     */
+    Slot* findSlot(unsigned long handle);
+
+    /**
+     * Deactivates the obstacle in the given slot and frees the slot.
+     *
+     * The last obstacle of the packed list is moved into the place of the
+     * removed one, so the list stays packed.
+     *
+     * @param slot  The slot to free
+     */
+    void freeSlot(Slot& slot);
+
+    /**
+     * Returns the replicated fields of the body that differ from the baseline.
+     *
+     * The fields are compared at the precision they are sent with, so noise
+     * below the quantization step does not count as a change.
+     *
+     * @param data      The current body state
+     * @param baseline  The body state at the last keyframe
+     *
+     * @return the replicated fields of the body that differ from the baseline.
+     */
+    Uint32 changedFields(const BodyNetData& data, const BodyNetData& baseline) const;
     
     
 #pragma mark -
@@ -251,6 +343,25 @@ public:
      */
     void setStepsize(float step) { _stepssize = step; }
 
+    /**
+     * Returns the maximum number of mini steps in a single update.
+     *
+     * @return the maximum number of mini steps in a single update.
+     */
+    int getMaxSteps() const { return _maxsteps; }
+
+    /**
+     * Sets the maximum number of mini steps in a single update.
+     *
+     * If an update is given more time than this many mini steps cover, as
+     * after a long stall, the extra time is dropped. Otherwise a slow update
+     * would have to simulate even more time the next frame, and never catch
+     * up.
+     *
+     * @param steps the maximum number of mini steps in a single update.
+     */
+    void setMaxSteps(int steps) { _maxsteps = steps; }
+
     /**
      * Returns number of velocity iterations for the constrain solvers
      *
@@ -298,6 +409,29 @@ public:
      * @param  gravity  the global gravity vector.
      */
     void setGravity(const Vec2 gravity);
+
+    /**
+     * Returns true if the draw world is stepped by the left over time.
+     *
+     * @return true if the draw world is stepped by the left over time.
+     */
+    bool isInterpolated() const { return _interpolated; }
+
+    /**
+     * Sets whether the draw world is stepped by the left over time.
+     *
+     * Interpolation steps a copy of every moving body by the time that is left
+     * over after the last full step, so that drawing does not stutter when the
+     * frame rate and the step size disagree. Without it, every draw body is
+     * disabled and the draw world is never stepped. The draw bodies still
+     * follow the real bodies, so drawing shows the state of the last full step.
+     *
+     * This is meant for applications that do not draw, such as a server or a
+     * bot, or whose frames always match the step size.
+     *
+     * @param value whether the draw world is stepped by the left over time
+     */
+    void setInterpolated(bool value);
     
     /**
      * Executes a single step of the physics engine.
@@ -337,11 +471,38 @@ public:
 #pragma mark -
 #pragma mark Object Management
     /**
-     * Returns a read-only reference to the list of active obstacles.
+     * Returns a read-only reference to the list of active non-static obstacles.
      *
-     * @return a read-only reference to the list of active obstacles.
+     * An obstacle is filed as static if its body type is static when it is
+     * added. The list is packed, so its order changes as obstacles are removed.
+     *
+     * @return a read-only reference to the list of active non-static obstacles.
+     */
+    const std::vector<Obstacle*>& getDynamicObstacles() const { return _dynamics; }
+
+    /**
+     * Returns a read-only reference to the list of active static obstacles.
+     *
+     * An obstacle is filed as static if its body type is static when it is
+     * added. The list is packed, so its order changes as obstacles are removed.
+     *
+     * @return a read-only reference to the list of active static obstacles.
+     */
+    const std::vector<Obstacle*>& getStaticObstacles() const { return _statics; }
+
+    /**
+     * Returns the obstacle with the given id, or nullptr if it is not in this world.
+     *
+     * The id of an obstacle is a handle that this world assigns when it is
+     * added. A slot only reuses a handle after it has been freed thousands of
+     * times, so the id of a removed obstacle does not find a later obstacle
+     * in its place.
+     *
+     * @param id    The id of an obstacle
+     *
+     * @return the obstacle with the given id, or nullptr if it is not in this world.
      */
-    const std::unordered_map<unsigned long, std::shared_ptr<Obstacle>>& getObstacles() { return _objects; }
+    Obstacle* getObstacle(unsigned long id);
 
     /**
      * Immediately adds the obstacle to the physics world
@@ -406,6 +567,84 @@ public:
      * Updates the physics world given a vector of BodyNetData structs. This is used when data from the network is received.
      */
     void updateFromState(std::vector<BodyNetData> data);
+
+    /**
+     * Returns a snapshot of every non-static obstacle in this world.
+     *
+     * The snapshot can be passed to {@link restore} to rewind the world to
+     * this moment without removing or reallocating any obstacles.
+     *
+     * @return a snapshot of every non-static obstacle in this world.
+     */
+    std::vector<BodyNetData> snapshot() const;
+
+    /**
+     * Rewinds the obstacles in this world to a snapshot, in place.
+     *
+     * Every obstacle in the snapshot that is still in this world has its body
+     * state restored, its angular velocity zeroed and its forces cleared.
+     * Obstacles that were removed since the snapshot are skipped, and
+     * obstacles added since the snapshot are left untouched.
+     *
+     * @param snapshot  A snapshot returned by {@link snapshot}
+     */
+    void restore(const std::vector<BodyNetData>& snapshot);
+
+#pragma mark -
+#pragma mark State Replication
+    /**
+     * Sets the precision of the replicated state.
+     *
+     * Positions are quantized over the bounds of this world, angles over a
+     * full turn, and velocities over [-speed,speed]. Both ends of a replicated
+     * stream must use the same precision.
+     *
+     * @param speed     The largest replicated speed
+     * @param position  The number of bits of each position component
+     * @param angle     The number of bits of an angle
+     * @param velocity  The number of bits of each velocity component
+     */
+    void setStatePrecision(float speed, int position, int angle, int velocity);
+
+    /**
+     * Writes the state of the non-static obstacles to the serializer.
+     *
+     * A keyframe writes every body in full, and becomes the baseline of the
+     * messages after it. Any other message only writes the bodies, and the
+     * fields of those bodies, that differ from the baseline. An obstacle added
+     * since the keyframe is written in full. The first message is always a
+     * keyframe.
+     *
+     * The receiver must have the same obstacles in the same slots, which is
+     * the case when both worlds add and remove the same obstacles in the same
+     * order. A keyframe should be sent reliably, as the receiver drops the
+     * deltas against a keyframe that it missed.
+     *
+     * @param serializer    The serializer to write to
+     * @param keyframe      Whether to write a keyframe
+     *
+     * @return true if a keyframe was written
+     */
+    bool writeState(NetworkSerializer& serializer, bool keyframe);
+
+    /**
+     * Reads a state message and applies it to the non-static obstacles.
+     *
+     * The bodies in the message take its values, and the bodies left out of
+     * a delta take the values of its keyframe. A delta against a keyframe that
+     * was missed is read and dropped, as its fields only make sense on top of
+     * that keyframe. The bodies keep their state until the next keyframe.
+     *
+     * @param deserializer  The deserializer to read from
+     *
+     * @return true if the message was applied
+     */
+    bool readState(NetworkDeserializer& deserializer);
+
+    /**
+     * Forgets the replication keyframe, so that the next message is a keyframe.
+     */
+    void resetState();
     
 #pragma mark -
 #pragma mark Collision Callback Functions
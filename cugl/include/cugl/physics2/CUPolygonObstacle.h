@@ -70,10 +70,10 @@ namespace cugl {
  */
 class PolygonObstacle : public SimpleObstacle {
 protected:
-    /** The polygon vertices (for resizing) */
-    Poly2 _polygon;
-    /** Shape information for this physics object */
-    b2PolygonShape* _shapes;
+    /** The polygon vertices (for resizing; shared with clones until changed) */
+    std::shared_ptr<Poly2> _polygon;
+    /** Shape information for this physics object (shared with clones) */
+    std::shared_ptr<b2PolygonShape> _shapes;
     /** A cache value for the fixtures (for resizing) */
     b2Fixture** _realgeoms;
     /** A cache value for the fixtures (for resizing) */
@@ -121,7 +121,9 @@ public:
      * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
      * the heap, use one of the static constructors instead.
      */
-    PolygonObstacle(void) : SimpleObstacle(), _shapes(nullptr), _realgeoms(nullptr), _drawgeoms(nullptr) { }
+    PolygonObstacle(void) : SimpleObstacle(), _shapes(nullptr), _realgeoms(nullptr), _drawgeoms(nullptr), _fixCount(0) {
+        _polygon = std::make_shared<Poly2>();
+    }
     
     /**
      * Deletes this physics object and all of its resources.
@@ -176,6 +178,21 @@ public:
      */
     virtual bool initWithAnchor(const Poly2& poly, const Vec2 anchor);
 
+    /**
+     * Initializes a copy of the given polygon obstacle
+     *
+     * The copy shares the polygon and the triangle shapes with the original,
+     * so no shape is recomputed. Shared data is only copied if either obstacle
+     * later changes its polygon. The copy has the same body, fixture and mass
+     * settings as the original (see {@link Obstacle#clone}), but it is not part
+     * of any world.
+     *
+     * @param  other    The polygon obstacle to copy
+     *
+     * @return true if the obstacle is initialized properly, false otherwise.
+     */
+    virtual bool initWithClone(const PolygonObstacle& other);
+
     
 #pragma mark -
 #pragma mark Static Constructors
@@ -228,6 +245,37 @@ public:
         std::shared_ptr<PolygonObstacle> result = std::make_shared<PolygonObstacle>();
         return (result->initWithAnchor(poly,anchor) ? result : nullptr);
     }
+
+    /**
+     * Returns a copy of the given polygon obstacle
+     *
+     * The copy shares the polygon and the triangle shapes with the original,
+     * so no shape is recomputed. Shared data is only copied if either obstacle
+     * later changes its polygon. The copy has the same body, fixture and mass
+     * settings as the original (see {@link Obstacle#clone}), but it is not part
+     * of any world.
+     *
+     * @param  other    The polygon obstacle to copy
+     *
+     * @return a copy of the given polygon obstacle
+     */
+    static std::shared_ptr<PolygonObstacle> allocWithClone(const PolygonObstacle& other) {
+        std::shared_ptr<PolygonObstacle> result = std::make_shared<PolygonObstacle>();
+        return (result->initWithClone(other) ? result : nullptr);
+    }
+
+    /**
+     * Returns a new obstacle with the same shape and settings as this one.
+     *
+     * The clone shares the polygon and the triangle shapes with this obstacle.
+     * It is not part of any world and has no debug wireframe. If this obstacle
+     * has a body, the clone starts with the current body state.
+     *
+     * @return a new obstacle with the same shape and settings as this one.
+     */
+    virtual std::shared_ptr<Obstacle> clone() const override {
+        return allocWithClone(*this);
+    }
     
     
 #pragma mark -
@@ -237,7 +285,7 @@ public:
      *
      * @return the dimensions of the bounding box
      */
-    const Size getSize() const { return _polygon.getBounds().size; }
+    const Size getSize() const { return _polygon->getBounds().size; }
     
     /**
      * Sets the dimensions of the bounding box
@@ -263,7 +311,7 @@ public:
      *
      * @return the bounding box width
      */
-    float getWidth() const { return _polygon.getBounds().size.width; }
+    float getWidth() const { return _polygon->getBounds().size.width; }
     
     /**
      * Sets the bounding box width
@@ -281,7 +329,7 @@ public:
      *
      * @return the bounding box height
      */
-    float getHeight() const { return _polygon.getBounds().size.height; }
+    float getHeight() const { return _polygon->getBounds().size.height; }
     
     /**
      * Sets the bounding box height
@@ -336,7 +384,7 @@ public:
      *
      * @return the polygon defining this object
      */
-    const Poly2& getPolygon() const { return _polygon; }
+    const Poly2& getPolygon() const { return *_polygon; }
     
     /**
      * Sets the polygon defining this object
@@ -455,7 +455,7 @@ public:
     virtual void setEnabled(bool value) override {
         if (_realbody != nullptr && _drawbody != nullptr) {
             _realbody->SetEnabled(value);
-            _drawbody->SetEnabled(value);
+            _drawbody->SetEnabled(value && _interpolated);
         } else {
             _bodyinfo.enabled = value;
         }
@@ -781,6 +781,18 @@ public:
      */
     virtual void setFilterData(b2Filter value) override;
     
+    /**
+     * Sets the user data stored in the fixtures of this object
+     *
+     * Box2D lets each fixture carry a single integer (or pointer) of user data.
+     * The body user data is reserved for this obstacle, but the fixture user
+     * data is free for the game, and is typically used to identify an object
+     * in a contact callback without searching for it.
+     *
+     * @param value  the user data stored in the fixtures of this object
+     */
+    virtual void setUserData(uintptr_t value) override;
+    
     
 #pragma mark -
 #pragma mark MassData Methods
@@ -913,7 +925,7 @@ public:
      *
      * @return a (weak) reference to Box2D body for this obstacle.
      */
-    virtual b2Body* getDrawBody() override { return _realbody; }
+    virtual b2Body* getDrawBody() override { return _drawbody; }
 
     /**
      * Returns the necessary BodyData class in order to update this body in another game instance
@@ -930,6 +942,16 @@ public:
      */
     virtual void syncBodies() override;
 
+    /**
+     * Sets whether the draw body is simulated for the remaining frame time.
+     *
+     * If this is false, the draw body is disabled, so that it is out of the
+     * broad-phase of the draw world.
+     *
+     * @param value whether the draw body is simulated
+     */
+    virtual void setInterpolated(bool value) override;
+
     /**
      * Creates the physics Body(s) for this object, adding them to the world.
      *
@@ -1062,6 +1084,16 @@ protected:
      * the texture (e.g. a circular shape attached to a square texture).
      */
     virtual void updateDebug() override;
+
+    /**
+     * Copies the body, fixture, mass and snap settings of the given obstacle.
+     *
+     * If the other obstacle has a body, this copies its current body state
+     * as well. This is used by {@link clone} in the subclasses.
+     *
+     * @param other The obstacle to copy
+     */
+    void copySettings(const SimpleObstacle& other);
 };
     }
 }
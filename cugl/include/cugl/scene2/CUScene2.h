@@ -87,6 +87,15 @@ protected:
 
     /** Whether or note this scene is still active */
     bool _active;
+    
+    /** Whether to skip cullable nodes that are off camera */
+    bool _culling;
+    /** The camera view in world coordinates (for culling) */
+    Rect _cullRect;
+    /** The number of nodes drawn in the last render */
+    Uint32 _drawCount;
+    /** The number of nodes (with their children) culled in the last render */
+    Uint32 _culledCount;
 
 #pragma mark -
 #pragma mark Constructors
@@ -749,6 +758,48 @@ public:
      */
     virtual void removeAllChildren();
     
+#pragma mark -
+#pragma mark Culling
+    /**
+     * Returns true if this scene skips cullable nodes that are off camera
+     *
+     * Culling is opt-in for each node (see {@link scene2::SceneNode#setCullable}).
+     * When it is enabled, a cullable node whose bounding box does not intersect
+     * the camera view is not drawn, and neither are its children. The default
+     * value is false.
+     *
+     * @return true if this scene skips cullable nodes that are off camera
+     */
+    bool isCulling() const { return _culling; }
+    
+    /**
+     * Sets whether this scene skips cullable nodes that are off camera
+     *
+     * Culling is opt-in for each node (see {@link scene2::SceneNode#setCullable}).
+     * When it is enabled, a cullable node whose bounding box does not intersect
+     * the camera view is not drawn, and neither are its children. The default
+     * value is false.
+     *
+     * @param value whether this scene skips cullable nodes that are off camera
+     */
+    void setCulling(bool value) { _culling = value; }
+    
+    /**
+     * Returns the number of nodes drawn in the last render
+     *
+     * @return the number of nodes drawn in the last render
+     */
+    Uint32 getDrawCount() const { return _drawCount; }
+    
+    /**
+     * Returns the number of nodes culled in the last render
+     *
+     * A culled node is counted once, regardless of how many children it has.
+     *
+     * @return the number of nodes culled in the last render
+     */
+    Uint32 getCulledCount() const { return _culledCount; }
+    
 #pragma mark -
 #pragma mark Scene Logic
     /**
@@ -129,6 +129,14 @@ protected:
     bool  _hasParentColor;
     /** Whether this node is visible */
     bool  _isVisible;
+    /** Whether this node (and its children) may be skipped when off camera */
+    bool  _isCullable;
+    /** Whether the cached culling bounds must be recomputed */
+    bool  _cullDirty;
+    /** The global transform used to compute the culling bounds */
+    Affine2 _cullTransform;
+    /** The cached bounding box of this node in global coordinates */
+    Rect  _cullBounds;
     
     /** An optional scissor value */
     std::shared_ptr<Scissor> _scissor;
@@ -1044,6 +1052,32 @@ public:
      */
     void setVisible(bool visible) { _isVisible = visible; }
     
+    /**
+     * Returns true if the node may be skipped when it is off camera.
+     *
+     * A cullable node is not drawn if its bounding box does not intersect the
+     * camera view of its scene, and neither are its children. Hence a node
+     * should only be cullable if its children lie inside its content bounds.
+     * Culling must also be enabled in the scene (see {@link Scene2#setCulling}).
+     * The default value is false.
+     *
+     * @return true if the node may be skipped when it is off camera.
+     */
+    bool isCullable() const { return _isCullable; }
+    
+    /**
+     * Sets whether the node may be skipped when it is off camera.
+     *
+     * A cullable node is not drawn if its bounding box does not intersect the
+     * camera view of its scene, and neither are its children. Hence a node
+     * should only be cullable if its children lie inside its content bounds.
+     * Culling must also be enabled in the scene (see {@link Scene2#setCulling}).
+     * The default value is false.
+     *
+     * @param value true if the node may be skipped when it is off camera.
+     */
+    void setCullable(bool value) { _isCullable = value; _cullDirty = true; }
+    
     /**
      * Returns true if this node is tinted by its parent.
      *
@@ -1642,7 +1676,7 @@ public:
      *
      * @param child A child node.
      */
-    void addChild(const std::shared_ptr<SceneNode>& child);
+    virtual void addChild(const std::shared_ptr<SceneNode>& child);
     
     
     /**
@@ -1692,6 +1726,29 @@ public:
      */
     void swapChild(const std::shared_ptr<SceneNode>& child1, const std::shared_ptr<SceneNode>& child2, bool inherit=false);
     
+    /**
+     * Moves the child at position from to position to.
+     *
+     * The children in between shift over by one to make room, so this takes
+     * time proportional to the distance moved. Unlike removing and re-adding
+     * a child, the child never leaves the scene graph. This allows subclasses
+     * to keep their children sorted incrementally.
+     *
+     * @param from  The current position of the child
+     * @param to    The new position of the child
+     */
+    void moveChild(unsigned int from, unsigned int to);
+    
+    /**
+     * Returns the position of this node among the children of its parent.
+     *
+     * This value is -1 if the node has no parent. Adding or removing a
+     * sibling may alter this position, so it is unsafe to cache it.
+     *
+     * @return the position of this node among the children of its parent.
+     */
+    int getChildOffset() const { return _childOffset; }
+    
     /**
      * Returns a (weak) pointer to the parent node.
      *
@@ -46,6 +46,8 @@
 #include <cugl/assets/CUTextureLoader.h>
 #include <cugl/base/CUApplication.h>
 #include <SDL/SDL_image.h>
+#include <algorithm>
+#include <numeric>
 
 using namespace cugl;
 
@@ -58,6 +60,10 @@ using namespace cugl;
 #define UNKNOWN_MAGFLT  "linear"
 /** The default wrap rule */
 #define UNKNOWN_WRAP    "clamp"
+/** The default maximum size of a texture pack page */
+#define DEFAULT_PAGE    4096
+/** The default padding between images in a texture pack */
+#define DEFAULT_PADDING 2
 
 /**
  * Returns the OpenGL enum for the given min filter name
@@ -375,6 +381,24 @@ bool TextureLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback
     }
     _queue.emplace(key);
     
+    if (json->has("pack")) {
+        if (_loader == nullptr || !async) {
+            std::vector<std::pair<std::string,Rect>> regions;
+            SDL_Surface* surface = preloadPack(json,regions);
+            materializePack(json,surface,regions,nullptr);
+            return _assets.find(key) != _assets.end();
+        }
+        _loader->addTask([=](void) {
+            auto regions = std::make_shared<std::vector<std::pair<std::string,Rect>>>();
+            SDL_Surface* surface = this->preloadPack(json,*regions);
+            Application::get()->schedule([=](void){
+                this->materializePack(json,surface,*regions,callback);
+                return false;
+            });
+        });
+        return false;
+    }
+    
     std::string source = json->getString("file",UNKNOWN_SOURCE);
     bool success = false;
     if (_loader == nullptr || !async) {
@@ -440,8 +464,19 @@ bool TextureLoader::purge(const std::shared_ptr<JsonValue>& json) {
     }
     _assets.erase(it);
     
-    JsonValue* child = json->get("atlas").get();
     bool success = true;
+    JsonValue* pack = json->get("pack").get();
+    if (pack) {
+        for(int ii = 0; ii < pack->size(); ii++) {
+            auto jt = _assets.find(pack->get(ii)->key());
+            success = (jt != _assets.end()) && success;
+            if (jt != _assets.end()) {
+                _assets.erase(jt);
+            }
+        }
+    }
+    
+    JsonValue* child = json->get("atlas").get();
     if (child) {
         for(int ii = 0; ii < child->size(); ii++) {
             JsonValue* item = child->get(ii).get();
@@ -486,3 +521,157 @@ void TextureLoader::parseAtlas(const std::shared_ptr<JsonValue>& json, const std
     }
 }
 
+#pragma mark -
+#pragma mark Pack Support
+/**
+ * Loads and packs the images of a texture pack into a single page surface.
+ *
+ * A texture pack is a directory entry with a "pack" attribute in place of
+ * "file".  The pack maps asset keys to image files.  This method decodes
+ * every image and places them on shelves (tallest first) inside a page
+ * no larger than the "size" attribute (4096 by default), separated by
+ * "padding" transparent pixels (2 by default).  The page is only as large
+ * as the packed images require.
+ *
+ * Like {@link preload}, this method does not use OpenGL and is safe to
+ * call outside the main thread.  The pixel bounds of each image (with
+ * the origin at the top left) are stored in regions.
+ *
+ * @param json      The asset directory entry
+ * @param regions   The key and pixel bounds of each packed image
+ *
+ * @return the SDL_Surface with the page, or nullptr if packing failed
+ */
+SDL_Surface* TextureLoader::preloadPack(const std::shared_ptr<JsonValue>& json,
+                                        std::vector<std::pair<std::string,Rect>>& regions) {
+    JsonValue* pack = json->get("pack").get();
+    int maxsize = json->getInt("size",DEFAULT_PAGE);
+    int padding = json->getInt("padding",DEFAULT_PADDING);
+    
+    // Decode every image first, as the layout depends on all of the sizes
+    std::vector<SDL_Surface*> images;
+    bool success = pack->size() > 0;
+    for(int ii = 0; success && ii < pack->size(); ii++) {
+        SDL_Surface* image = preload(pack->get(ii)->asString());
+        if (image == nullptr) {
+            CULogError("Could not load %s for texture pack %s",
+                       pack->get(ii)->key().c_str(), json->key().c_str());
+            success = false;
+        } else {
+            images.push_back(image);
+        }
+    }
+    
+    // Shelf packing: place the tallest images first, each on the first shelf with room
+    struct Shelf { int y, height, width; };
+    std::vector<Shelf> shelves;
+    std::vector<SDL_Rect> bounds(images.size());
+    std::vector<size_t> order(images.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (images[a]->h != images[b]->h) return images[a]->h > images[b]->h;
+        return images[a]->w > images[b]->w;
+    });
+    
+    int width  = 0;
+    int height = 0;
+    for(auto it = order.begin(); success && it != order.end(); ++it) {
+        SDL_Surface* image = images[*it];
+        Shelf* shelf = nullptr;
+        for(auto jt = shelves.begin(); shelf == nullptr && jt != shelves.end(); ++jt) {
+            if (image->h <= jt->height && jt->width+image->w <= maxsize) {
+                shelf = &(*jt);
+            }
+        }
+        if (shelf == nullptr) {
+            if (image->w > maxsize || height+image->h > maxsize) {
+                CULogError("Texture pack %s does not fit in a %d page",json->key().c_str(),maxsize);
+                success = false;
+                break;
+            }
+            shelves.push_back({height,image->h,0});
+            shelf = &shelves.back();
+            height += image->h+padding;
+        }
+        bounds[*it] = {shelf->width,shelf->y,image->w,image->h};
+        shelf->width += image->w+padding;
+        width = std::max(width,shelf->width);
+    }
+    
+    SDL_Surface* page = nullptr;
+    if (success) {
+        // New surfaces are zeroed, so the padding is transparent
+        page = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, images[0]->format->format);
+        for(size_t ii = 0; page != nullptr && ii < images.size(); ii++) {
+            SDL_SetSurfaceBlendMode(images[ii], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(images[ii], nullptr, page, &bounds[ii]);
+            regions.push_back(std::make_pair(pack->get((int)ii)->key(),
+                                             Rect((float)bounds[ii].x,(float)bounds[ii].y,
+                                                  (float)bounds[ii].w,(float)bounds[ii].h)));
+        }
+    }
+    
+    for(auto it = images.begin(); it != images.end(); ++it) {
+        SDL_FreeSurface(*it);
+    }
+    return page;
+}
+
+/**
+ * Creates an OpenGL texture for a packed page, together with its regions.
+ *
+ * This method finishes the asset loading started in {@link preloadPack}.
+ * The page is assigned the key of the directory entry, while each region
+ * is a subtexture of the page assigned the key of its packed image.  As
+ * all regions share the same texture buffer, the sprite batch can draw
+ * them without flushing.
+ *
+ * This method supports an optional callback function which reports whether
+ * the asset was successfully materialized.
+ *
+ * @param json      The asset directory entry
+ * @param surface   The SDL_Surface with the page (may be nullptr)
+ * @param regions   The key and pixel bounds of each packed image
+ * @param callback  An optional callback for asynchronous loading
+ */
+void TextureLoader::materializePack(const std::shared_ptr<JsonValue>& json, SDL_Surface* surface,
+                                    const std::vector<std::pair<std::string,Rect>>& regions,
+                                    LoaderCallback callback) {
+    std::string key = json->key();
+    std::shared_ptr<Texture> texture = nullptr;
+    if (surface != nullptr) {
+        texture = Texture::allocWithData(surface->pixels, surface->w, surface->h);
+        SDL_FreeSurface(surface);
+    }
+    
+    bool success = false;
+    if (texture != nullptr) {
+        GLuint minflt = decodeMinFilter(json->getString("minfilter",UNKNOWN_MINFLT));
+        GLuint magflt = decodeMagFilter(json->getString("magfilter",UNKNOWN_MAGFLT));
+        bool mipmaps = json->getBool("mipmaps",false);
+        
+        _assets[key] = texture;
+        texture->bind();
+        if (mipmaps) { texture->buildMipMaps(); }
+        texture->setMinFilter(minflt);
+        texture->setMagFilter(magflt);
+        texture->setWrapS(GL_CLAMP_TO_EDGE);
+        texture->setWrapT(GL_CLAMP_TO_EDGE);
+        texture->unbind();
+        
+        Size size = texture->getSize();
+        for(auto it = regions.begin(); it != regions.end(); ++it) {
+            const Rect& bounds = it->second;
+            _assets[it->first] = texture->getSubTexture(bounds.getMinX()/size.width,
+                                                        bounds.getMaxX()/size.width,
+                                                        bounds.getMinY()/size.height,
+                                                        bounds.getMaxY()/size.height);
+        }
+        success = true;
+    }
+    
+    if (callback != nullptr) {
+        callback(key,success);
+    }
+    _queue.erase(key);
+}
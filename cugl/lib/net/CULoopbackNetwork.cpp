@@ -0,0 +1,316 @@
+//
+//  CULoopbackNetwork.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides an in-process transport for NetworkConnection. A host
+//  and any number of clients can share a single loopback network, and talk to
+//  each other without the NAT punchthrough server or a network at all. The
+//  network delivers the packets after a simulated latency, and can add jitter,
+//  packet loss and reordering, so that netcode can be tested and measured under
+//  poor network conditions on a single machine.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+#include <cugl/net/CULoopbackNetwork.h>
+#include <cugl/util/CUDebug.h>
+#include <algorithm>
+
+using namespace cugl;
+
+/** The shortest time (in seconds) before a lost reliable packet is resent */
+constexpr float RESEND_TIMEOUT = 0.1f;
+
+/** The most times a reliable packet is resent, so that a lossy link cannot stall forever */
+constexpr int RESEND_LIMIT = 10;
+
+/** The smallest room ID, so that every room ID has five digits like the real ones */
+constexpr uint32_t ROOM_MIN = 10000;
+
+/** The number of possible room IDs */
+constexpr uint32_t ROOM_RANGE = 90000;
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates a degenerate loopback network.
+ *
+ * The network has no random seed and cannot be used.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+LoopbackNetwork::LoopbackNetwork() :
+_time(0),
+_maxPlayers(0),
+_started(false),
+_order(0) {
+}
+
+/**
+ * Disposes all of the resources used by this loopback network.
+ *
+ * Any packets in flight are lost, and every player is disconnected.
+ */
+void LoopbackNetwork::dispose() {
+    _inflight.clear();
+    _sentSequence.clear();
+    _deliveredSequence.clear();
+    _orderedArrival.clear();
+    _links.clear();
+    _players.reset();
+    _roomID.clear();
+    _started = false;
+    _stats = Stats();
+}
+
+/**
+ * Initializes a loopback network with perfect links.
+ *
+ * The seed determines the simulated conditions, so that a test run
+ * with the same seed (and the same traffic) behaves the same way.
+ *
+ * @param seed  The random seed of the simulated conditions
+ *
+ * @return true if initialization was successful
+ */
+bool LoopbackNetwork::init(uint32_t seed) {
+    _random.seed(seed);
+    _time = 0;
+    _order = 0;
+    _conditions = Conditions();
+    return true;
+}
+
+#pragma mark -
+#pragma mark Network Conditions
+/**
+ * Returns the conditions of the link between the host and a client
+ *
+ * @param playerID  The player ID of the client
+ *
+ * @return the conditions of the link between the host and a client
+ */
+const LoopbackNetwork::Conditions& LoopbackNetwork::getConditions(uint8_t playerID) const {
+    auto link = _links.find(playerID);
+    return link == _links.end() ? _conditions : link->second;
+}
+
+#pragma mark -
+#pragma mark Connections
+/**
+ * Opens the room of a new host, returning its room ID
+ *
+ * The host is always player 0. This method fails (returning the empty
+ * string) if the network already has a host.
+ *
+ * @param maxPlayers    The maximum number of players (including the host)
+ *
+ * @return the room ID of the host, or the empty string on failure
+ */
+std::string LoopbackNetwork::host(uint32_t maxPlayers) {
+    if (!_roomID.empty()) {
+        return "";
+    }
+    _roomID = std::to_string(ROOM_MIN + _random() % ROOM_RANGE);
+    _maxPlayers = maxPlayers;
+    _started = false;
+    _players.reset();
+    _players.set(0);
+    return _roomID;
+}
+
+/**
+ * Joins the room with the given ID, returning the assigned player ID
+ *
+ * This fails if there is no such room, if the room is full, or if the
+ * game has already started.
+ *
+ * @param roomID    The room ID of the host
+ *
+ * @return the assigned player ID, or empty on failure
+ */
+std::optional<uint8_t> LoopbackNetwork::join(const std::string& roomID) {
+    if (_roomID.empty() || roomID != _roomID || _started) {
+        return std::nullopt;
+    }
+    for (uint32_t player = 1; player < _maxPlayers && player < _players.size(); player++) {
+        if (!_players.test(player)) {
+            _players.set(player);
+            return (uint8_t)player;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * Disconnects a player, losing every packet to or from it
+ *
+ * If the player is the host, the room closes and every client is
+ * disconnected too.
+ *
+ * @param playerID  The player to disconnect
+ */
+void LoopbackNetwork::leave(uint8_t playerID) {
+    if (!_players.test(playerID)) {
+        return;
+    }
+    _players.reset(playerID);
+    if (playerID == 0) {
+        _players.reset();
+        _roomID.clear();
+    }
+    _inflight.erase(std::remove_if(_inflight.begin(), _inflight.end(), [this](const Packet& packet) {
+        return !_players.test(packet.from) || !_players.test(packet.to);
+    }), _inflight.end());
+}
+
+#pragma mark -
+#pragma mark Packets
+/**
+ * Sends a packet from one player to another
+ *
+ * One of the players must be the host, as the network is a star. The
+ * packet arrives after the simulated conditions of their link.
+ *
+ * @param from          The player ID of the sender
+ * @param to            The player ID of the receiver
+ * @param type          The packet type, which the network does not interpret
+ * @param data          The packet contents
+ * @param reliability   The packet reliability
+ * @param channel       The ordering channel
+ */
+void LoopbackNetwork::send(uint8_t from, uint8_t to, uint8_t type, const std::vector<uint8_t>& data,
+                           PacketReliability reliability, uint8_t channel) {
+    CUAssertLog(from == 0 || to == 0, "Clients may only send packets to the host");
+    if (!_players.test(from) || !_players.test(to)) {
+        return;
+    }
+    _stats.sent++;
+
+    const Conditions& link = getConditions(from == 0 ? to : from);
+    bool reliable = reliability >= RELIABLE && reliability <= RELIABLE_SEQUENCED;
+    bool sequenced = reliability == UNRELIABLE_SEQUENCED || reliability == RELIABLE_SEQUENCED;
+    Stream stream(from, to, channel);
+
+    // The sequence number is used even if the packet is lost, as it is on a real link
+    size_t sequence = sequenced ? ++_sentSequence[stream] : 0;
+    float arrival = _time + link.latency + link.jitter * random();
+    if (random() < link.reorder) {
+        arrival += link.latency + link.jitter;
+    }
+
+    // A lost reliable packet is resent once the sender notices it was not acknowledged
+    for (int attempt = 0; random() < link.loss; attempt++) {
+        if (!reliable) {
+            _stats.lost++;
+            return;
+        }
+        if (attempt == RESEND_LIMIT) {
+            break;
+        }
+        arrival += std::max(RESEND_TIMEOUT, 2 * link.latency + link.jitter);
+        _stats.resent++;
+    }
+
+    // An ordered packet waits for every packet sent ahead of it on its channel
+    if (reliability == RELIABLE_ORDERED) {
+        float& last = _orderedArrival[stream];
+        arrival = std::max(arrival, last);
+        last = arrival;
+    }
+
+    Packet packet;
+    packet.from = from;
+    packet.to = to;
+    packet.type = type;
+    packet.reliability = reliability;
+    packet.channel = channel;
+    packet.data = data;
+    packet.arrival = arrival;
+    packet.order = _order++;
+    packet.sequence = sequence;
+    _inflight.push_back(std::move(packet));
+}
+
+/**
+ * Receives the next packet that has arrived for a player
+ *
+ * Packets arrive in the order of their arrival times, and sequenced
+ * packets that arrive after a newer one are dropped here.
+ *
+ * @param playerID  The player ID of the receiver
+ * @param packet    The packet to store the result in
+ *
+ * @return true if a packet was received
+ */
+bool LoopbackNetwork::receive(uint8_t playerID, Packet& packet) {
+    while (true) {
+        auto next = _inflight.end();
+        for (auto it = _inflight.begin(); it != _inflight.end(); ++it) {
+            if (it->to != playerID || it->arrival > _time) {
+                continue;
+            }
+            if (next == _inflight.end() || it->arrival < next->arrival ||
+                (it->arrival == next->arrival && it->order < next->order)) {
+                next = it;
+            }
+        }
+        if (next == _inflight.end()) {
+            return false;
+        }
+
+        packet = std::move(*next);
+        _inflight.erase(next);
+        if (packet.sequence > 0) {
+            size_t& newest = _deliveredSequence[Stream(packet.from, packet.to, packet.channel)];
+            if (packet.sequence <= newest) {
+                _stats.superseded++;
+                continue;
+            }
+            newest = packet.sequence;
+        }
+        _stats.delivered++;
+        _stats.bytes += packet.data.size();
+        return true;
+    }
+}
+
+/**
+ * Returns a uniform random number in [0,1)
+ *
+ * @return a uniform random number in [0,1)
+ */
+float LoopbackNetwork::random() {
+    return std::uniform_real_distribution<float>(0.0f, 1.0f)(_random);
+}
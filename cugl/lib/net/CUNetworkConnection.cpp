@@ -38,6 +38,7 @@
 // for beta testing this class.
 //
 #include <cugl/net/CUNetworkConnection.h>
+#include <cugl/net/CULoopbackNetwork.h>
 #include <cugl/cugl.h>
 #include <utility>
 
@@ -72,6 +73,15 @@ using namespace cugl;
 /** The maximum byte vector size.  1430 (VPN Max) - 40 (IP HEADER) - 6 (CUGL HEADER) */
 constexpr unsigned int MAX_PACKET = 1384;
 
+/** The ordering channel used by the connection reliability */
+constexpr uint8_t DEFAULT_CHANNEL = 1;
+
+/** The number of ordering channels (NUMBER_OF_ORDERED_STREAMS in Slikenet) */
+constexpr uint8_t CHANNEL_COUNT = 32;
+
+/** The number of bytes that end a standard message (reliability and channel) */
+constexpr size_t STANDARD_TRAILER = 2;
+
 /** Length of room IDs */
 constexpr uint8_t ROOM_LENGTH = 5;
 
@@ -141,8 +151,7 @@ _maxPlayers(1) {
  * Deletes this network connection, disposing all resources
  */
 NetworkConnection::~NetworkConnection() {
-    _peer->Shutdown(SHUTDOWN_BLOCK);
-    SLNet::RakPeerInterface::DestroyInstance(_peer.release());
+    dispose();
 }
 
 /**
@@ -151,8 +160,16 @@ NetworkConnection::~NetworkConnection() {
  * A disposed network connection can be safely reinitialized.
  */
 void NetworkConnection::dispose() {
-    _peer->Shutdown(SHUTDOWN_BLOCK);
-    SLNet::RakPeerInterface::DestroyInstance(_peer.release());
+    if (_loopback != nullptr) {
+        if (_playerID.has_value()) {
+            _loopback->leave(*_playerID);
+        }
+        _loopback = nullptr;
+    }
+    if (_peer != nullptr) {
+        _peer->Shutdown(SHUTDOWN_BLOCK);
+        SLNet::RakPeerInterface::DestroyInstance(_peer.release());
+    }
 }
 
 /**
@@ -218,6 +235,81 @@ bool NetworkConnection::init(ConnectionConfig config, std::string roomID) {
     return false;
 }
 
+/**
+ * Initializes a new network connection as host on a loopback network.
+ *
+ * The connection sends its packets through the given in-process network
+ * instead of Slikenet, so the punchthrough server address in the config
+ * is ignored. Unlike a real connection, it is CONNECTED (with its room ID)
+ * as soon as this method returns.
+ *
+ * @param setup     Connection config
+ * @param loopback  The loopback network to host a room on
+ *
+ * @return true if initialization was successful
+ */
+bool NetworkConnection::init(ConnectionConfig config, const std::shared_ptr<LoopbackNetwork>& loopback) {
+    if (_peer || _loopback || loopback == nullptr) {
+        return false;
+    }
+    _roomID = loopback->host(config.maxNumPlayers);
+    if (_roomID.empty()) {
+        return false;
+    }
+    _loopback = loopback;
+    _status = NetStatus::Connected;
+    _apiVer = config.apiVersion;
+    _numPlayers = 1;
+    _maxPlayers = 1;
+    _playerID = 0;
+    _config = config;
+    _connectedPlayers.set(0);
+    _remotePeer = HostPeers(config.maxNumPlayers);
+    if (_debug) {
+        CULog("Got loopback room ID: %s; Accepting Connections Now", _roomID.c_str());
+    }
+    return true;
+}
+
+/**
+ * Initializes a new network connection as a client on a loopback network.
+ *
+ * The connection sends its packets through the given in-process network
+ * instead of Slikenet, so the punchthrough server address in the config
+ * is ignored. Unlike a real connection, it is CONNECTED (or has failed to
+ * find the room) as soon as this method returns.
+ *
+ * @param setup     Connection config
+ * @param loopback  The loopback network of the host
+ * @param roomID    Host's assigned Room ID
+ *
+ * @return true if initialization was successful
+ */
+bool NetworkConnection::init(ConnectionConfig config, const std::shared_ptr<LoopbackNetwork>& loopback,
+                             const std::string roomID) {
+    if (_peer || _loopback || loopback == nullptr) {
+        return false;
+    }
+    _loopback = loopback;
+    _apiVer = config.apiVersion;
+    _config = config;
+    _roomID = roomID;
+    _remotePeer = ClientPeer(roomID);
+    _playerID = _loopback->join(roomID);
+    if (!_playerID.has_value()) {
+        if (_debug) {
+            CULog("Failed to join loopback room");
+        }
+        _status = NetStatus::RoomNotFound;
+        return true;
+    }
+    _connectedPlayers = _loopback->getPlayers();
+    _numPlayers = (uint8_t)_connectedPlayers.count();
+    _maxPlayers = _numPlayers;
+    _status = NetStatus::Connected;
+    return true;
+}
+
 /**
  * Sets the packet reliablity for this network connection.
  *
@@ -225,7 +317,8 @@ bool NetworkConnection::init(ConnectionConfig config, std::string roomID) {
  * to one of RELIABLE, RELIABLE_ORDERED, or RELIABLE_SEQUENCED. The
  * value RELIABLE_ORDERED is the default. Note that changing this
  * value will only effect future calls to {@link #send} and
- * {@link #sendOnlyToHost}.
+ * {@link #sendOnlyToHost} that do not
+ * specify their own reliability.
  *
  * RELIABLE: Packets are all received, but not necessarily in order.
  * So if A is sent before B, B may come first, with A coming after.
@@ -584,7 +677,7 @@ void NetworkConnection::cc7HostGetClientData(HostPeers& h, SLNet::Packet* packet
             }
             _connectedPlayers.set(pID);
             std::vector<uint8_t> joinMsg = { pID };
-            broadcast(joinMsg, packet->systemAddress, PlayerJoined);
+            broadcast(joinMsg, packet->systemAddress, PlayerJoined, _reliability, DEFAULT_CHANNEL);
             _numPlayers++;
 
             return;
@@ -672,36 +765,58 @@ void NetworkConnection::cr2HostGetClientResp(HostPeers& h, SLNet::Packet* packet
  * @param packetType Packet type from RakNet
  * @param msg The message to send
  * @param ignore The address to not send to
+ * @param reliability The packet reliability
+ * @param channel The ordering channel
  */
 void NetworkConnection::broadcast(const std::vector<uint8_t>& msg,
                                   SLNet::SystemAddress& ignore,
-                                  CustomDataPackets packetType) {
+                                  CustomDataPackets packetType,
+                                  PacketReliability reliability,
+                                  uint8_t channel) {
     SLNet::BitStream bs;
     writeBs(bs,ID_USER_PACKET_ENUM + packetType,msg);
-    _peer->Send(&bs, MEDIUM_PRIORITY, _reliability, 1, ignore, true);
+    _peer->Send(&bs, MEDIUM_PRIORITY, reliability, channel, ignore, true);
 }
 
 /**
  * Sends a message to all connected players
  *
- * This method can be called by either connection.
+ * This method can be called by either connection. Standard messages end
+ * with their reliability and channel, so that the host can relay them.
  *
  * @param msg The message to send
- * @param ignore The address to not send to
+ * @param packetType The type of custom data packet
+ * @param reliability The packet reliability
+ * @param channel The ordering channel
  */
-void NetworkConnection::send(const std::vector<uint8_t>& msg, CustomDataPackets packetType) {
+void NetworkConnection::send(const std::vector<uint8_t>& msg, CustomDataPackets packetType,
+                             PacketReliability reliability, uint8_t channel) {
+    if (_loopback != nullptr) {
+        sendLoopback(msg, packetType, reliability, channel);
+        return;
+    }
+
     SLNet::BitStream bs;
-    writeBs(bs,ID_USER_PACKET_ENUM + packetType,msg);
+    if (packetType == Standard) {
+        std::vector<uint8_t> data;
+        data.reserve(msg.size() + STANDARD_TRAILER);
+        data.insert(data.end(), msg.begin(), msg.end());
+        data.push_back(static_cast<uint8_t>(reliability));
+        data.push_back(channel);
+        writeBs(bs,ID_USER_PACKET_ENUM + packetType,data);
+    } else {
+        writeBs(bs,ID_USER_PACKET_ENUM + packetType,msg);
+    }
 
     std::visit(make_visitor(
         [&](HostPeers& /*h*/) {
-            _peer->Send(&bs, MEDIUM_PRIORITY, _reliability, 1, *_natPunchServerAddress, true);
+            _peer->Send(&bs, MEDIUM_PRIORITY, reliability, channel, *_natPunchServerAddress, true);
         },
         [&](ClientPeer& c) {
             if (c.addr == nullptr) {
                 return;
             }
-            _peer->Send(&bs, MEDIUM_PRIORITY, _reliability, 1, *c.addr, false);
+            _peer->Send(&bs, MEDIUM_PRIORITY, reliability, channel, *c.addr, false);
         }), _remotePeer);
 }
 
@@ -720,6 +835,105 @@ void cugl::NetworkConnection::directSend(const std::vector<uint8_t>& msg,
     _peer->Send(&bs, MEDIUM_PRIORITY, _reliability, 1, dest, false);
 }
 
+/**
+ * Sends a message through the loopback network.
+ *
+ * The host sends the message to every client, while a client sends it
+ * to the host (which relays standard messages to everyone else).
+ *
+ * @param msg The message to send
+ * @param packetType The type of custom data packet
+ * @param reliability The packet reliability
+ * @param channel The ordering channel
+ */
+void NetworkConnection::sendLoopback(const std::vector<uint8_t>& msg,
+                                     CustomDataPackets packetType,
+                                     PacketReliability reliability,
+                                     uint8_t channel) {
+    if (!_playerID.has_value()) {
+        return;
+    }
+    std::visit(make_visitor(
+        [&](HostPeers& /*h*/) {
+            for (size_t player = 1; player < _connectedPlayers.size(); player++) {
+                if (_connectedPlayers.test(player)) {
+                    _loopback->send(0, (uint8_t)player, packetType, msg, reliability, channel);
+                }
+            }
+        },
+        [&](ClientPeer& /*c*/) {
+            _loopback->send(*_playerID, 0, packetType, msg, reliability, channel);
+        }), _remotePeer);
+}
+
+/**
+ * Receives the messages that have arrived through the loopback network.
+ *
+ * The connected players are taken from the loopback network, as there
+ * is no handshake to announce them.
+ *
+ * @param dispatcher    The function to process received data
+ */
+void NetworkConnection::receiveLoopback(
+    const std::function<void(const std::vector<uint8_t>&)>& dispatcher) {
+    if (_status != NetStatus::Connected) {
+        return;
+    }
+
+    // A client whose host has left has nobody to reconnect to
+    const std::bitset<256>& players = _loopback->getPlayers();
+    if (!players.test(*_playerID)) {
+        if (_debug) {
+            CULog("Lost connection to loopback host");
+        }
+        _connectedPlayers.reset();
+        _status = NetStatus::Disconnected;
+        return;
+    }
+    _connectedPlayers = players;
+    _numPlayers = (uint8_t)players.count();
+    std::visit(make_visitor(
+        [&](HostPeers& h) {
+            if (!h.started) {
+                _maxPlayers = _numPlayers;
+            }
+        },
+        [&](ClientPeer& /*c*/) {
+            _maxPlayers = std::max(_maxPlayers, _numPlayers);
+        }), _remotePeer);
+
+    LoopbackNetwork::Packet packet;
+    while (_status == NetStatus::Connected && _loopback->receive(*_playerID, packet)) {
+        switch (packet.type) {
+        case Standard:
+            // The host relays a client message to the other clients, as sent
+            std::visit(make_visitor(
+                [&](HostPeers& /*h*/) {
+                    for (size_t player = 1; player < _connectedPlayers.size(); player++) {
+                        if (player != packet.from && _connectedPlayers.test(player)) {
+                            _loopback->send(0, (uint8_t)player, Standard, packet.data,
+                                            packet.reliability, packet.channel);
+                        }
+                    }
+                },
+                [&](ClientPeer& /*c*/) {}), _remotePeer);
+            dispatcher(packet.data);
+            break;
+        case DirectToHost:
+            dispatcher(packet.data);
+            break;
+        case StartGame:
+            startGame();
+            break;
+        default:
+            if (_debug) {
+                CULog("Received unknown loopback message: %d", packet.type);
+            }
+            break;
+        }
+    }
+}
+
 /**
  * Attempts to reconnect to the host.
  *
@@ -777,7 +991,7 @@ void NetworkConnection::attemptReconnect() {
  * @param msg The byte array to send.
  */
 void NetworkConnection::send(const std::vector<uint8_t>& msg) {
-    send(msg, Standard);
+    send(msg, Standard, _reliability, DEFAULT_CHANNEL);
 }
 
 /**
@@ -799,7 +1013,60 @@ void NetworkConnection::sendOnlyToHost(const std::vector<uint8_t>& msg) {
     std::visit(make_visitor(
         [&](HostPeers& /*h*/) {},
         [&](ClientPeer& c) {
-            send(msg, DirectToHost);
+            send(msg, DirectToHost, _reliability, DEFAULT_CHANNEL);
+        }), _remotePeer);
+}
+
+/**
+ * Sends a byte array to all other players with the given reliability.
+ *
+ * This is the same as {@link #send}, except that the reliability is chosen
+ * for this message alone instead of using the connection reliability. This
+ * allows a game to send frequent state updates (which may be lost, as a newer
+ * one will follow) as UNRELIABLE_SEQUENCED, while still sending important
+ * events as RELIABLE_ORDERED. The unreliable types are only permitted once
+ * the connection is established.
+ *
+ * Messages are ordered or sequenced only relative to other messages on the
+ * same ordering channel (0-31), so that a lost packet on one channel does not
+ * delay the messages on another. The connection reliability uses channel 1.
+ * The host relays a message with the same reliability and channel that the
+ * sender chose.
+ *
+ * @param msg           The byte array to send.
+ * @param reliability   The packet reliability of this message
+ * @param channel       The ordering channel of this message
+ */
+void NetworkConnection::send(const std::vector<uint8_t>& msg, PacketReliability reliability,
+                             uint8_t channel) {
+    CUAssertLog(channel < CHANNEL_COUNT, "Ordering channel %d is out of range", channel);
+    CUAssertLog(reliability <= RELIABLE_SEQUENCED, "Unpermitted message priority");
+    CUAssertLog(reliability >= RELIABLE || _status == NetStatus::Connected,
+                "Unreliable messages are only permitted after initial connection.");
+    send(msg, Standard, reliability, channel);
+}
+
+/**
+ * Sends a byte array to the host only with the given reliability.
+ *
+ * This is the same as {@link #sendOnlyToHost}, except that the reliability
+ * and ordering channel are chosen for this message alone. See the three
+ * argument version of {@link #send} for details.
+ *
+ * @param msg           The byte array to send.
+ * @param reliability   The packet reliability of this message
+ * @param channel       The ordering channel of this message
+ */
+void NetworkConnection::sendOnlyToHost(const std::vector<uint8_t>& msg,
+                                       PacketReliability reliability, uint8_t channel) {
+    CUAssertLog(channel < CHANNEL_COUNT, "Ordering channel %d is out of range", channel);
+    CUAssertLog(reliability <= RELIABLE_SEQUENCED, "Unpermitted message priority");
+    CUAssertLog(reliability >= RELIABLE || _status == NetStatus::Connected,
+                "Unreliable messages are only permitted after initial connection.");
+    std::visit(make_visitor(
+        [&](HostPeers& /*h*/) {},
+        [&](ClientPeer& c) {
+            send(msg, DirectToHost, reliability, channel);
         }), _remotePeer);
 }
 
@@ -824,6 +1091,10 @@ void NetworkConnection::sendOnlyToHost(const std::vector<uint8_t>& msg) {
  */
 void NetworkConnection::receive(
     const std::function<void(const std::vector<uint8_t>&)>& dispatcher) {
+    if (_loopback != nullptr) {
+        receiveLoopback(dispatcher);
+        return;
+    }
 
     switch (_status) {
     case NetStatus::Reconnecting:
@@ -913,7 +1184,7 @@ void NetworkConnection::receive(
                                 _numPlayers--;
                                 _connectedPlayers.reset(pID);
                             }
-                            send(disconnMsg, PlayerLeft);
+                            send(disconnMsg, PlayerLeft, _reliability, DEFAULT_CHANNEL);
 
                             if (_peer->GetConnectionState(packet->systemAddress) == SLNet::IS_CONNECTED) {
                                 _peer->CloseConnection(packet->systemAddress, true);
@@ -973,12 +1244,22 @@ void NetworkConnection::receive(
         // Begin Non-SLikeNet Reported Codes
         case ID_USER_PACKET_ENUM + Standard: {
             auto msgConverted = readBs(bts);
-            dispatcher(msgConverted);
+            if (msgConverted.size() < STANDARD_TRAILER) {
+                CULogError("Received standard message without a trailer");
+                break;
+            }
 
+            // Relay the message as it was sent, trailer included
+            auto reliability = static_cast<PacketReliability>(msgConverted[msgConverted.size() - 2]);
+            uint8_t channel = msgConverted.back();
             std::visit(make_visitor(
-                [&](HostPeers& /*h*/) { broadcast(msgConverted, packet->systemAddress); },
+                [&](HostPeers& /*h*/) {
+                    broadcast(msgConverted, packet->systemAddress, Standard, reliability, channel);
+                },
                 [&](ClientPeer& c) {}), _remotePeer);
 
+            msgConverted.resize(msgConverted.size() - STANDARD_TRAILER);
+            dispatcher(msgConverted);
             break;
         }
         case ID_USER_PACKET_ENUM + DirectToHost: {
@@ -1080,7 +1361,13 @@ void NetworkConnection::startGame() {
     }
     std::visit(make_visitor([&](HostPeers& h) {
         h.started = true;
-        broadcast({}, const_cast<SLNet::SystemAddress&>(SLNet::UNASSIGNED_SYSTEM_ADDRESS), StartGame);
+        if (_loopback != nullptr) {
+            _loopback->start();
+            sendLoopback({}, StartGame, _reliability, DEFAULT_CHANNEL);
+            return;
+        }
+        broadcast({}, const_cast<SLNet::SystemAddress&>(SLNet::UNASSIGNED_SYSTEM_ADDRESS), StartGame,
+                  _reliability, DEFAULT_CHANNEL);
         }, [&](ClientPeer& c) {}), _remotePeer);
     _maxPlayers = _numPlayers;
 }
@@ -49,6 +49,7 @@
 //
 #include <cugl/net/CUNetworkSerializer.h>
 #include <cugl/base/CUEndian.h>
+#include <cugl/util/CUDebug.h>
 
 #include <stdexcept>
 #include <sstream>
@@ -446,11 +447,77 @@ const std::vector<uint8_t>& NetworkSerializer::serialize() {
 	return _data;
 }
 
+/**
+ * Writes the low order bits of an unsigned value.
+ *
+ * Unlike the other write methods, packed values have no type header, and
+ * consecutive packed values share bytes. So a boolean flag only costs a
+ * single bit. They must be read back with {@link NetworkDeserializer#readBits}
+ * using the same bit counts. Packed values never share a byte with any
+ * other value, whether it was written before or after them.
+ *
+ * @param value The value to write
+ * @param bits  The number of bits to write (at most 32)
+ */
+void NetworkSerializer::writeBits(Uint32 value, int bits) {
+    CUAssertLog(bits >= 0 && bits <= 32, "Bit count %d is out of range", bits);
+    for (int ii = 0; ii < bits; ii++) {
+        // Start a new byte if the last one is full or was not written by us.
+        // The count starts full, so a value written first never shares its byte.
+        if (_bitCount == 8 || _data.empty() || _bitByte != _data.size()-1) {
+            _data.push_back(0);
+            _bitByte = _data.size()-1;
+            _bitCount = 0;
+        }
+        if ((value >> ii) & 1) {
+            _data[_bitByte] |= (uint8_t)(1 << _bitCount);
+        }
+        _bitCount++;
+    }
+}
+
+/**
+ * Writes a float quantized to the given number of bits.
+ *
+ * The value is clamped to the range [min,max] and stored as a packed value
+ * (see {@link #writeBits}). It must be read back with
+ * {@link NetworkDeserializer#readQuantized} using the same range and bits.
+ *
+ * @param value The value to write
+ * @param min   The minimum value of the range
+ * @param max   The maximum value of the range
+ * @param bits  The number of bits to write (at most 32)
+ */
+void NetworkSerializer::writeQuantized(float value, float min, float max, int bits) {
+    writeBits(quantize(value, min, max, bits), bits);
+}
+
+/**
+ * Returns the integer a float is quantized to by {@link #writeQuantized}.
+ *
+ * This is useful to compare values at the precision they are sent with.
+ *
+ * @param value The value to quantize
+ * @param min   The minimum value of the range
+ * @param max   The maximum value of the range
+ * @param bits  The number of bits (at most 32)
+ *
+ * @return the integer a float is quantized to by {@link #writeQuantized}.
+ */
+Uint32 NetworkSerializer::quantize(float value, float min, float max, int bits) {
+    double steps = (double)((((Uint64)1) << bits) - 1);
+    double t = (max > min ? ((double)value - min) / ((double)max - min) : 0.0);
+    t = (t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t));
+    return (Uint32)(t * steps + 0.5);
+}
+
 /**
  * Clears the input buffer.
  */
 void NetworkSerializer::reset() {
 	_data.clear();
+	_bitByte = 0;
+	_bitCount = 8;
 }
 
 #pragma mark -
@@ -476,6 +543,8 @@ void NetworkSerializer::reset() {
 void NetworkDeserializer::receive(const std::vector<uint8_t>& msg) {
 	_data = msg;
 	_pos = 0;
+	_bitByte = 0;
+	_bitCount = 8;
 }
 
 /**
@@ -1025,10 +1094,74 @@ std::vector<std::shared_ptr<JsonValue>> NetworkDeserializer::readJsonVector() {
     return vv;
 }
 
+/**
+ * Returns an unsigned value written by {@link NetworkSerializer#writeBits}.
+ *
+ * Packed values have no type header, so {@link #nextType} cannot detect
+ * them. The bit counts must match those used to write the values, or the
+ * stream will be corrupted.
+ *
+ * The method advances the read position. If called when no more data is
+ * available, the missing bits are read as 0.
+ *
+ * @param bits  The number of bits to read (at most 32)
+ *
+ * @return an unsigned value written by {@link NetworkSerializer#writeBits}.
+ */
+Uint32 NetworkDeserializer::readBits(int bits) {
+    CUAssertLog(bits >= 0 && bits <= 32, "Bit count %d is out of range", bits);
+    Uint32 result = 0;
+    for (int ii = 0; ii < bits; ii++) {
+        // Mirror the serializer, which starts a new byte after any other value
+        // (and for the first packed value, as the count starts full)
+        if (_bitCount == 8 || _pos == 0 || _bitByte != _pos-1) {
+            _bitByte = _pos++;
+            _bitCount = 0;
+        }
+        if (_bitByte < _data.size() && ((_data[_bitByte] >> _bitCount) & 1)) {
+            result |= ((Uint32)1) << ii;
+        }
+        _bitCount++;
+    }
+    return result;
+}
+
+/**
+ * Returns a float written by {@link NetworkSerializer#writeQuantized}.
+ *
+ * The range and bits must match those used to write the value.
+ *
+ * @param min   The minimum value of the range
+ * @param max   The maximum value of the range
+ * @param bits  The number of bits to read (at most 32)
+ *
+ * @return a float written by {@link NetworkSerializer#writeQuantized}.
+ */
+float NetworkDeserializer::readQuantized(float min, float max, int bits) {
+    return dequantize(readBits(bits), min, max, bits);
+}
+
+/**
+ * Returns the float for an integer quantized by {@link NetworkSerializer#quantize}.
+ *
+ * @param value The quantized value
+ * @param min   The minimum value of the range
+ * @param max   The maximum value of the range
+ * @param bits  The number of bits (at most 32)
+ *
+ * @return the float for an integer quantized by {@link NetworkSerializer#quantize}.
+ */
+float NetworkDeserializer::dequantize(Uint32 value, float min, float max, int bits) {
+    double steps = (double)((((Uint64)1) << bits) - 1);
+    return (float)(min + (value / steps) * ((double)max - min));
+}
+
 /**
  * Clears the buffer and ignore any remaining data in it.
  */
 void NetworkDeserializer::reset() {
 	_pos = 0;
 	_data.clear();
+	_bitByte = 0;
+	_bitCount = 8;
 }
@@ -185,6 +185,29 @@ void ComplexObstacle::setFilterData(b2Filter value) {
     }
 }
 
+/**
+ * Sets the user data stored in the fixtures of this object
+ *
+ * Box2D lets each fixture carry a single integer (or pointer) of user data.
+ * The body user data is reserved for this obstacle, but the fixture user
+ * data is free for the game, and is typically used to identify an object
+ * in a contact callback without searching for it. This only affects the fixtures of
+ * the root body, not those of the composite structure.
+ *
+ * @param value  the user data stored in the fixtures of this object
+ */
+void ComplexObstacle::setUserData(uintptr_t value) {
+    _fixture.userData.pointer = value;
+    if (_realbody != nullptr && _drawbody != nullptr) {
+        for (b2Fixture* f = _realbody->GetFixtureList(); f; f = f->GetNext()) {
+            f->GetUserData().pointer = value;
+        }
+        for (b2Fixture* f = _drawbody->GetFixtureList(); f; f = f->GetNext()) {
+            f->GetUserData().pointer = value;
+        }
+    }
+}
+
 
 #pragma mark -
 #pragma mark Physics Methods
@@ -397,7 +420,7 @@ ComplexObstacle::~ComplexObstacle() {
 void ComplexObstacle::syncBodies() {
     _drawbody->SetType(_realbody->GetType());
     _drawbody->SetTransform(_realbody->GetPosition(), _realbody->GetAngle());
-    _drawbody->SetEnabled(_realbody->IsEnabled());
+    _drawbody->SetEnabled(_interpolated && _realbody->IsEnabled());
     _drawbody->SetAwake(_realbody->IsAwake());
     _drawbody->SetBullet(_realbody->IsBullet());
     _drawbody->SetLinearVelocity(_realbody->GetLinearVelocity());
@@ -408,6 +431,24 @@ void ComplexObstacle::syncBodies() {
     _drawbody->SetLinearDamping(_realbody->GetLinearDamping());
 }
 
+/**
+ * Sets whether the draw body is simulated for the remaining frame time.
+ *
+ * If this is false, the draw body is disabled, so that it is out of the
+ * broad-phase of the draw world.
+ *
+ * @param value whether the draw body is simulated
+ */
+void ComplexObstacle::setInterpolated(bool value) {
+    _interpolated = value;
+    if (_realbody != nullptr && _drawbody != nullptr) {
+        _drawbody->SetEnabled(value && _realbody->IsEnabled());
+    }
+    for(auto it = _bodies.begin(); it != _bodies.end(); ++it) {
+        (*it)->setInterpolated(value);
+    }
+}
+
 BodyNetData ComplexObstacle::getBodyData() {
     BodyNetData data;
     data.id = _id;
@@ -419,7 +460,7 @@ BodyNetData ComplexObstacle::getBodyData() {
     data.bullet = _realbody->IsBullet();
     data.linearVelocity = _realbody->GetLinearVelocity();
     data.sleepingAllowed = _realbody->IsSleepingAllowed();
-    data.fixedRotation = _realbody->GetGravityScale();
+    data.fixedRotation = _realbody->IsFixedRotation();
     data.gravityScale = _realbody->GetGravityScale();
     data.angularDamping = _realbody->GetAngularDamping();
     data.linearDamping = _realbody->GetLinearDamping();
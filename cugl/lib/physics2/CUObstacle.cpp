@@ -90,6 +90,7 @@ Obstacle::~Obstacle() {
 bool Obstacle::init(const Vec2 vec) {
     // Object has yet to be deactivated
     _remove = false;
+    _interpolated = true;
     
     // Allocate the body information
     _bodyinfo.awake  = true;
@@ -126,6 +127,27 @@ void Obstacle::setBodyState(const b2Body& body) {
     _bodyinfo.linearDamping  = body.GetLinearDamping();
 }
 
+/**
+ * Copies the body, fixture and mass settings of the given obstacle.
+ *
+ * This is used by {@link clone} in the subclasses. It does not copy the
+ * shape, the id, the listener, or the debug wireframe. The copy is not
+ * marked for removal and is not dirty.
+ *
+ * @param other The obstacle to copy
+ */
+void Obstacle::copySettings(const Obstacle& other) {
+    _remove = false;
+    _dirty  = false;
+    _interpolated = true;
+    _bodyinfo = other._bodyinfo;
+    _fixture  = other._fixture;
+    _fixture.shape = nullptr;
+    _massdata = other._massdata;
+    _masseffect = other._masseffect;
+    _dcolor = other._dcolor;
+    _tag = other._tag;
+}
 
 #pragma mark -
 #pragma mark MassData Methods
@@ -48,6 +48,8 @@
 #include <box2d/b2_collision.h>
 #include <cugl/physics2/CUObstacleWorld.h>
 #include <cugl/physics2/CUObstacle.h>
+#include <cugl/net/CUNetworkSerializer.h>
+#include <cstring>
 
 using namespace cugl;
 using namespace cugl::physics2;
@@ -56,6 +58,48 @@ using namespace cugl::physics2;
 
 /** The default value of gravity (going down) */
 #define DEFAULT_GRAVITY -9.8f
+/**
+ * The number of low bits of an obstacle handle that hold its slot (the rest hold the generation)
+ *
+ * A handle is an unsigned long, which is only 32 bits on Windows and 32-bit ARM, so the split
+ * is half and half. That allows 65535 obstacles and 65536 generations of each slot there, and
+ * far more on 64-bit platforms. The generation wraps, so a handle held across that many
+ * removals from its slot could find the obstacle that reused it.
+ */
+#define HANDLE_SLOT_BITS (sizeof(unsigned long) * 4)
+/** The mask of the slot bits of an obstacle handle */
+#define HANDLE_SLOT_MASK ((1UL << HANDLE_SLOT_BITS) - 1)
+/** The mask of the generation of a slot, before it is shifted into a handle */
+#define HANDLE_GENERATION_MASK (~0UL >> HANDLE_SLOT_BITS)
+
+/** The default largest replicated speed */
+#define DEFAULT_STATE_SPEED     32.0f
+/** The default number of bits of each replicated position component */
+#define DEFAULT_POSITION_BITS   16
+/** The default number of bits of a replicated angle */
+#define DEFAULT_ANGLE_BITS      10
+/** The default number of bits of each replicated velocity component */
+#define DEFAULT_VELOCITY_BITS   12
+/** The number of bits of a replication keyframe ID */
+#define STATE_ID_BITS           8
+/** The number of bits of the width of a slot number in a state message */
+#define STATE_WIDTH_BITS        5
+/** The number of bits of the body flags (type, enabled, awake, bullet, sleep, rotation) */
+#define STATE_FLAG_BITS         7
+/** The field of a replicated body position */
+#define STATE_POSITION          1
+/** The field of a replicated body angle */
+#define STATE_ANGLE             2
+/** The field of a replicated body velocity */
+#define STATE_VELOCITY          4
+/** The field of the replicated body flags */
+#define STATE_FLAGS             8
+/** The field of the replicated gravity scale and damping */
+#define STATE_SCALES            16
+/** Every replicated field */
+#define STATE_ALL               31
+/** The number of bits of the replicated fields of a body */
+#define STATE_FIELD_BITS        5
 
 #pragma mark -
 #pragma mark Proxy Classes
@@ -168,12 +212,19 @@ _collide(false),
 _filters(false),
 _destroy(false) {
     _stepsplits = DEFAULT_SPLITS;
+    _maxsteps   = DEFAULT_MAX_STEPS;
     _stepssize  = DEFAULT_WORLD_STEP;
     _itvelocity = DEFAULT_WORLD_VELOC;
     _itposition = DEFAULT_WORLD_POSIT;
     _gravity = Vec2(0,DEFAULT_GRAVITY);
-    _objectsAdded = 0;
     _remainingtime = 0;
+    _interpolated = true;
+    _keyframeID = 0;
+    _hasKeyframe = false;
+    _stateSpeed = DEFAULT_STATE_SPEED;
+    _positionBits = DEFAULT_POSITION_BITS;
+    _angleBits = DEFAULT_ANGLE_BITS;
+    _velocityBits = DEFAULT_VELOCITY_BITS;
     
     onBeginContact = nullptr;
     onEndContact   = nullptr;
@@ -266,10 +317,29 @@ bool ObstacleWorld::init(const Rect bounds, const Vec2 gravity) {
  */
 void ObstacleWorld::addObstacle(const std::shared_ptr<Obstacle>& obj) {
     CUAssertLog(inBounds(obj.get()), "Obstacle is not in bounds");
-    obj->setId(_objectsAdded);
-    _objects[obj->getId()] = obj;
+    unsigned long slotnum;
+    if (_freeslots.empty()) {
+        CUAssertLog(_slots.size() <= HANDLE_SLOT_MASK, "Too many obstacles in the world");
+        slotnum = _slots.size();
+        _slots.push_back(Slot());
+        _slots.back().generation = 0;
+    } else {
+        slotnum = _freeslots.back();
+        _freeslots.pop_back();
+    }
+
+    Slot& slot = _slots[slotnum];
+    std::vector<Obstacle*>& list = obj->getBodyType() == b2_staticBody ? _statics : _dynamics;
+    slot.obstacle = obj;
+    slot.isStatic = (&list == &_statics);
+    slot.hasBaseline = false;
+    slot.received = false;
+    slot.index = list.size();
+    list.push_back(obj.get());
+
+    obj->setId((slot.generation << HANDLE_SLOT_BITS) | slotnum);
     obj->activatePhysics(*_realworld, *_drawworld);
-    _objectsAdded++;
+    obj->setInterpolated(_interpolated);
 }
 
 /**
@@ -287,10 +357,11 @@ void ObstacleWorld::addObstacle(const std::shared_ptr<Obstacle>& obj) {
  * @release a reference to the obstacle
  */
 void ObstacleWorld::removeObstacle(Obstacle* obj) {
-    obj->deactivatePhysics(*_realworld, *_drawworld);
-    auto result = _objects.erase(obj->getId());
-    // Result 3 means that zero elements were removed
-    if (result == 3) CUAssertLog(false, "Physics object not present in world");
+    Slot* slot = findSlot(obj->getId());
+    CUAssertLog(slot != nullptr && slot->obstacle.get() == obj, "Physics object not present in world");
+    if (slot != nullptr) {
+        freeSlot(*slot);
+    }
 }
 
 /**
@@ -302,12 +373,13 @@ void ObstacleWorld::removeObstacle(Obstacle* obj) {
  * This method is the efficient, preferred way to remove objects.
  */
 void ObstacleWorld::garbageCollect() {
-    for (auto it : _objects) {
-        if (it.second->isRemoved()) {
-            it.second->deactivatePhysics(*_realworld, *_drawworld);
-            // #TODO This may be unwise. Find a way to use erase instead at some point? Doing this
-            // makes the hash map just get bigger and bigger with longs pointing to null elements (I think?)
-            it.second = nullptr;
+    // Walk backwards, as freeing a slot moves the last obstacle into its place
+    for (std::vector<Obstacle*>* list : { &_dynamics, &_statics }) {
+        for (size_t ii = list->size(); ii > 0; ii--) {
+            Obstacle* obj = (*list)[ii-1];
+            if (obj->isRemoved()) {
+                freeSlot(_slots[obj->getId() & HANDLE_SLOT_MASK]);
+            }
         }
     }
 }
@@ -319,14 +391,75 @@ void ObstacleWorld::garbageCollect() {
  * receive new objects.
  */
 void ObstacleWorld::clear() {
-    for(auto it : _objects) {
-        Obstacle* obj = it.second.get();
-        obj->deactivatePhysics(*_realworld, *_drawworld);
+    for (Slot& slot : _slots) {
+        if (slot.obstacle != nullptr) {
+            freeSlot(slot);
+        }
     }
-    _objects.clear();
     update(0);
 }
 
+/**
+ * Returns the obstacle with the given id, or nullptr if it is not in this world.
+ *
+ * The id of an obstacle is a handle that this world assigns when it is
+ * added. A slot only reuses a handle after it has been freed thousands of
+ * times, so the id of a removed obstacle does not find a later obstacle
+ * in its place.
+ *
+ * @param id    The id of an obstacle
+ *
+ * @return the obstacle with the given id, or nullptr if it is not in this world.
+ */
+Obstacle* ObstacleWorld::getObstacle(unsigned long id) {
+    Slot* slot = findSlot(id);
+    return slot == nullptr ? nullptr : slot->obstacle.get();
+}
+
+/**
+ * Returns the slot of the obstacle with the given handle, or nullptr if there is none.
+ *
+ * The handle must match the generation of the slot, so the handle of a
+ * removed obstacle never finds the obstacle that reused its slot.
+ *
+ * @param handle    The handle (id) of an obstacle
+ *
+ * @return the slot of the obstacle with the given handle, or nullptr if there is none.
+ */
+ObstacleWorld::Slot* ObstacleWorld::findSlot(unsigned long handle) {
+    unsigned long slotnum = handle & HANDLE_SLOT_MASK;
+    if (slotnum >= _slots.size()) {
+        return nullptr;
+    }
+    Slot& slot = _slots[slotnum];
+    if (slot.obstacle == nullptr || (slot.generation << HANDLE_SLOT_BITS) != (handle & ~HANDLE_SLOT_MASK)) {
+        return nullptr;
+    }
+    return &slot;
+}
+
+/**
+ * Deactivates the obstacle in the given slot and frees the slot.
+ *
+ * The last obstacle of the packed list is moved into the place of the
+ * removed one, so the list stays packed.
+ *
+ * @param slot  The slot to free
+ */
+void ObstacleWorld::freeSlot(Slot& slot) {
+    Obstacle* obj = slot.obstacle.get();
+    obj->deactivatePhysics(*_realworld, *_drawworld);
+
+    std::vector<Obstacle*>& list = slot.isStatic ? _statics : _dynamics;
+    Obstacle* last = list.back();
+    list[slot.index] = last;
+    _slots[last->getId() & HANDLE_SLOT_MASK].index = slot.index;
+    list.pop_back();
+
+    _freeslots.push_back(obj->getId() & HANDLE_SLOT_MASK);
+    slot.generation = (slot.generation + 1) & HANDLE_GENERATION_MASK;
+    slot.obstacle = nullptr;
+}
 
 #pragma mark -
 #pragma mark Physics Handling
@@ -371,25 +504,88 @@ void ObstacleWorld::update(float dt) {
     float totaltime = _remainingtime + dt;
     // The total sim time (needed for obj->update)
     float totalsimtime = _remainingtime + dt;
-    while (totaltime > ministep) {
+    int steps = 0;
+    while (totaltime > ministep && steps < _maxsteps) {
         _realworld->Step(ministep, _itvelocity, _itposition);
         totaltime -= ministep;
+        steps++;
+    }
+    // Drop the time the step budget did not cover, so that a stall cannot spiral
+    if (totaltime > ministep) {
+        totaltime -= ministep * floorf(totaltime / ministep);
     }
 
     // Now our real world is in the right state. Make one final step to set up the draw world and remember the remaining time from this frame
     _remainingtime = totaltime;
-    // Sync real body to draw body
-    for (auto it : _objects) {
-        it.second->syncBodies();
+    // Sync real body to draw body, but only for the bodies that can have moved
+    for (Obstacle* obj : _dynamics) {
+        if (needsSync(obj)) {
+            obj->syncBodies();
+        }
     }
     // Step the draw world by the remaining time
-    _drawworld->Step(_remainingtime, _itvelocity, _itposition);
+    if (_interpolated) {
+        _drawworld->Step(_remainingtime, _itvelocity, _itposition);
+    }
     
     // Post process all objects after physics (this updates graphics)
-    for(auto it : _objects) {
-        Obstacle* obj = it.second.get();
+    for (Obstacle* obj : _dynamics) {
         obj->update(totalsimtime);
     }
+    // Static objects only need it to change shape or notify a listener
+    for (Obstacle* obj : _statics) {
+        if (obj->isDirty() || obj->getListener()) {
+            obj->update(totalsimtime);
+        }
+    }
+}
+
+/**
+ * Sets whether the draw world is stepped by the left over time.
+ *
+ * Interpolation steps a copy of every moving body by the time that is left
+ * over after the last full step, so that drawing does not stutter when the
+ * frame rate and the step size disagree. Without it, every draw body is
+ * disabled and the draw world is never stepped. The draw bodies still
+ * follow the real bodies, so drawing shows the state of the last full step.
+ *
+ * This is meant for applications that do not draw, such as a server or a
+ * bot, or whose frames always match the step size.
+ *
+ * @param value whether the draw world is stepped by the left over time
+ */
+void ObstacleWorld::setInterpolated(bool value) {
+    _interpolated = value;
+    for (Obstacle* obj : _dynamics) {
+        obj->setInterpolated(value);
+    }
+    for (Obstacle* obj : _statics) {
+        obj->setInterpolated(value);
+    }
+}
+
+/**
+ * Returns true if the draw body of the obstacle may differ from its real body.
+ *
+ * The setters of an obstacle write both of its bodies, so only the physics
+ * step can make them differ. A body that is asleep in both worlds was not
+ * moved by it, and neither was a static one. The draw body is put to sleep
+ * by the sync after its real body falls asleep, so that it is skipped from
+ * then on.
+ *
+ * @param obj   The obstacle to check
+ *
+ * @return true if the draw body of the obstacle may differ from its real body.
+ */
+bool ObstacleWorld::needsSync(Obstacle* obj) {
+    b2Body* real = obj->getRealBody();
+    b2Body* draw = obj->getDrawBody();
+    if (real == nullptr || draw == nullptr) {
+        return false;
+    } else if (real->GetType() == b2_staticBody && draw->GetType() == b2_staticBody) {
+        return false;
+    }
+    return real->IsAwake() || draw->IsAwake();
 }
 
 /**
@@ -503,17 +699,362 @@ void ObstacleWorld::rayCast(std::function<float(b2Fixture* fixture, const Vec2 p
 }
 
 std::vector<BodyNetData> ObstacleWorld::getState() {
+    return snapshot();
+}
+
+void ObstacleWorld::updateFromState(std::vector<BodyNetData> data) {
+    for (const BodyNetData& body : data) {
+        Obstacle* obj = getObstacle(body.id);
+        if (obj != nullptr) obj->setBodyFromData(body);
+    }
+}
+
+/**
+ * Returns a snapshot of every non-static obstacle in this world.
+ *
+ * The snapshot can be passed to {@link restore} to rewind the world to
+ * this moment without removing or reallocating any obstacles.
+ *
+ * @return a snapshot of every non-static obstacle in this world.
+ */
+std::vector<BodyNetData> ObstacleWorld::snapshot() const {
     std::vector<BodyNetData> state;
-    for (auto it : _objects) {
-        std::shared_ptr<Obstacle> obs = it.second;
-        // Only record non-static bodies. No need to update state on static bodies.
-        if(obs->getBodyType() != b2_staticBody) state.push_back(obs->getBodyData());
+    state.reserve(_dynamics.size());
+    for (Obstacle* obj : _dynamics) {
+        if (obj->getBodyType() != b2_staticBody) {
+            state.push_back(obj->getBodyData());
+        }
     }
     return state;
 }
 
-void ObstacleWorld::updateFromState(std::vector<BodyNetData> data) {
-    for (BodyNetData body : data) {
-        _objects[body.id]->setBodyFromData(body);
+/**
+ * Rewinds the obstacles in this world to a snapshot, in place.
+ *
+ * Every obstacle in the snapshot that is still in this world has its body
+ * state restored, its angular velocity zeroed and its forces cleared.
+ * Obstacles that were removed since the snapshot are skipped, and
+ * obstacles added since the snapshot are left untouched.
+ *
+ * @param snapshot  A snapshot returned by {@link snapshot}
+ */
+void ObstacleWorld::restore(const std::vector<BodyNetData>& snapshot) {
+    for (const BodyNetData& body : snapshot) {
+        Obstacle* obj = getObstacle(body.id);
+        if (obj == nullptr) continue;
+        obj->setBodyFromData(body);
+        obj->setAngularVelocity(0);
+    }
+    _realworld->ClearForces();
+    _drawworld->ClearForces();
+    _remainingtime = 0;
+}
+
+#pragma mark -
+#pragma mark State Replication
+/**
+ * Returns the angle wrapped to [-pi,pi)
+ *
+ * @param angle The angle in radians
+ *
+ * @return the angle wrapped to [-pi,pi)
+ */
+static float wrapAngle(float angle) {
+    float result = fmodf(angle + (float)M_PI, 2 * (float)M_PI);
+    return (result < 0 ? result + 2 * (float)M_PI : result) - (float)M_PI;
+}
+
+/**
+ * Returns the upper end of a range starting at -max in which zero is a quantized value
+ *
+ * @param max   The magnitude of the range
+ * @param bits  The number of bits of the quantized values
+ *
+ * @return the upper end of a range starting at -max in which zero is a quantized value
+ */
+static float symmetricMax(float max, int bits) {
+    float steps = (float)((1UL << bits) - 1);
+    return max * (steps + 1) / (steps - 1);
+}
+
+/**
+ * Returns the boolean state of a body packed into STATE_FLAG_BITS bits
+ *
+ * @param data  The body state
+ *
+ * @return the boolean state of a body packed into STATE_FLAG_BITS bits
+ */
+static Uint32 packFlags(const BodyNetData& data) {
+    return (Uint32)data.type | data.enabled << 2 | data.awake << 3 | data.bullet << 4 |
+           data.sleepingAllowed << 5 | data.fixedRotation << 6;
+}
+
+/**
+ * Writes a float exactly, as a packed value
+ *
+ * @param serializer    The serializer to write to
+ * @param value         The value to write
+ */
+static void writeExact(NetworkSerializer& serializer, float value) {
+    Uint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    serializer.writeBits(bits, 32);
+}
+
+/**
+ * Returns a float written by writeExact
+ *
+ * @param deserializer  The deserializer to read from
+ *
+ * @return a float written by writeExact
+ */
+static float readExact(NetworkDeserializer& deserializer) {
+    Uint32 bits = deserializer.readBits(32);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * Sets the precision of the replicated state.
+ *
+ * Positions are quantized over the bounds of this world, angles over a
+ * full turn, and velocities over [-speed,speed]. Both ends of a replicated
+ * stream must use the same precision.
+ *
+ * @param speed     The largest replicated speed
+ * @param position  The number of bits of each position component
+ * @param angle     The number of bits of an angle
+ * @param velocity  The number of bits of each velocity component
+ */
+void ObstacleWorld::setStatePrecision(float speed, int position, int angle, int velocity) {
+    CUAssertLog(velocity >= 2, "Velocities need at least two bits");
+    _stateSpeed = speed;
+    _positionBits = position;
+    _angleBits = angle;
+    _velocityBits = velocity;
+}
+
+/**
+ * Writes the state of the non-static obstacles to the serializer.
+ *
+ * A keyframe writes every body in full, and becomes the baseline of the
+ * messages after it. Any other message only writes the bodies, and the
+ * fields of those bodies, that differ from the baseline. An obstacle added
+ * since the keyframe is written in full. The first message is always a
+ * keyframe.
+ *
+ * The receiver must have the same obstacles in the same slots, which is
+ * the case when both worlds add and remove the same obstacles in the same
+ * order. A keyframe should be sent reliably, as the receiver drops the
+ * deltas against a keyframe that it missed.
+ *
+ * @param serializer    The serializer to write to
+ * @param keyframe      Whether to write a keyframe
+ *
+ * @return true if a keyframe was written
+ */
+bool ObstacleWorld::writeState(NetworkSerializer& serializer, bool keyframe) {
+    keyframe = keyframe || !_hasKeyframe;
+    if (keyframe) {
+        _keyframeID++;
+        _hasKeyframe = true;
+    }
+    int width = 0;
+    while ((1UL << width) < _slots.size()) width++;
+
+    serializer.writeBits(keyframe, 1);
+    serializer.writeBits(_keyframeID, STATE_ID_BITS);
+    serializer.writeBits(width, STATE_WIDTH_BITS);
+
+    Vec2 min = _bounds.origin;
+    Vec2 max = _bounds.origin + _bounds.size;
+    float speed = symmetricMax(_stateSpeed, _velocityBits);
+    for (Obstacle* obj : _dynamics) {
+        if (obj->getBodyType() == b2_staticBody) continue;
+        unsigned long slotnum = obj->getId() & HANDLE_SLOT_MASK;
+        Slot& slot = _slots[slotnum];
+        BodyNetData data = obj->getBodyData();
+
+        // Leave out whatever matches the keyframe
+        Uint32 fields = STATE_ALL;
+        if (keyframe) {
+            slot.baseline = data;
+            slot.hasBaseline = true;
+        } else if (slot.hasBaseline) {
+            fields = changedFields(data, slot.baseline);
+            if (fields == 0) continue;
+        }
+
+        serializer.writeBits(1, 1);
+        serializer.writeBits((Uint32)slotnum, width);
+        serializer.writeBits(fields, STATE_FIELD_BITS);
+        if (fields & STATE_POSITION) {
+            serializer.writeQuantized(data.position.x, min.x, max.x, _positionBits);
+            serializer.writeQuantized(data.position.y, min.y, max.y, _positionBits);
+        }
+        if (fields & STATE_ANGLE) {
+            serializer.writeQuantized(wrapAngle(data.angle), -M_PI, M_PI, _angleBits);
+        }
+        if (fields & STATE_VELOCITY) {
+            serializer.writeQuantized(data.linearVelocity.x, -_stateSpeed, speed, _velocityBits);
+            serializer.writeQuantized(data.linearVelocity.y, -_stateSpeed, speed, _velocityBits);
+        }
+        if (fields & STATE_FLAGS) {
+            serializer.writeBits(packFlags(data), STATE_FLAG_BITS);
+        }
+        if (fields & STATE_SCALES) {
+            writeExact(serializer, data.gravityScale);
+            writeExact(serializer, data.angularDamping);
+            writeExact(serializer, data.linearDamping);
+        }
+    }
+    serializer.writeBits(0, 1);
+    return keyframe;
+}
+
+/**
+ * Reads a state message and applies it to the non-static obstacles.
+ *
+ * The bodies in the message take its values, and the bodies left out of
+ * a delta take the values of its keyframe. A delta against a keyframe that
+ * was missed is read and dropped, as its fields only make sense on top of
+ * that keyframe. The bodies keep their state until the next keyframe.
+ *
+ * @param deserializer  The deserializer to read from
+ *
+ * @return true if the message was applied
+ */
+bool ObstacleWorld::readState(NetworkDeserializer& deserializer) {
+    bool keyframe = deserializer.readBits(1);
+    Uint8 keyframeID = deserializer.readBits(STATE_ID_BITS);
+    int width = deserializer.readBits(STATE_WIDTH_BITS);
+    bool matched = !keyframe && _hasKeyframe && keyframeID == _keyframeID;
+    bool applied = keyframe || matched;
+    if (keyframe) {
+        _keyframeID = keyframeID;
+        _hasKeyframe = true;
+        for (Slot& slot : _slots) {
+            slot.hasBaseline = false;
+        }
+    }
+
+    Vec2 min = _bounds.origin;
+    Vec2 max = _bounds.origin + _bounds.size;
+    float speed = symmetricMax(_stateSpeed, _velocityBits);
+    Uint32 still = NetworkSerializer::quantize(0, -_stateSpeed, speed, _velocityBits);
+    while (deserializer.readBits(1)) {
+        unsigned long slotnum = deserializer.readBits(width);
+        Uint32 fields = deserializer.readBits(STATE_FIELD_BITS);
+        Slot* slot = nullptr;
+        if (applied && slotnum < _slots.size() && _slots[slotnum].obstacle != nullptr &&
+            !_slots[slotnum].isStatic) {
+            slot = &_slots[slotnum];
+        }
+
+        // Start from the keyframe, or from the body itself if it was added since
+        BodyNetData data;
+        if (slot != nullptr) {
+            data = (matched && slot->hasBaseline ? slot->baseline : slot->obstacle->getBodyData());
+        }
+        if (fields & STATE_POSITION) {
+            data.position.x = deserializer.readQuantized(min.x, max.x, _positionBits);
+            data.position.y = deserializer.readQuantized(min.y, max.y, _positionBits);
+        }
+        if (fields & STATE_ANGLE) {
+            data.angle = deserializer.readQuantized(-M_PI, M_PI, _angleBits);
+        }
+        if (fields & STATE_VELOCITY) {
+            for (int ii = 0; ii < 2; ii++) {
+                Uint32 value = deserializer.readBits(_velocityBits);
+                float velocity = NetworkDeserializer::dequantize(value, -_stateSpeed, speed, _velocityBits);
+                (ii == 0 ? data.linearVelocity.x : data.linearVelocity.y) = (value == still ? 0 : velocity);
+            }
+        }
+        if (fields & STATE_FLAGS) {
+            Uint32 flags = deserializer.readBits(STATE_FLAG_BITS);
+            data.type = (b2BodyType)(flags & 3);
+            data.enabled = flags & 4;
+            data.awake = flags & 8;
+            data.bullet = flags & 16;
+            data.sleepingAllowed = flags & 32;
+            data.fixedRotation = flags & 64;
+        }
+        if (fields & STATE_SCALES) {
+            data.gravityScale = readExact(deserializer);
+            data.angularDamping = readExact(deserializer);
+            data.linearDamping = readExact(deserializer);
+        }
+
+        if (slot != nullptr) {
+            if (keyframe) {
+                slot->baseline = data;
+                slot->hasBaseline = true;
+            }
+            slot->received = true;
+            slot->obstacle->setBodyFromData(data);
+        }
+    }
+
+    // The bodies left out of a delta are as they were at the keyframe
+    for (Obstacle* obj : _dynamics) {
+        Slot& slot = _slots[obj->getId() & HANDLE_SLOT_MASK];
+        if (matched && !slot.received && slot.hasBaseline &&
+            changedFields(obj->getBodyData(), slot.baseline) != 0) {
+            obj->setBodyFromData(slot.baseline);
+        }
+        slot.received = false;
+    }
+    return applied;
+}
+
+/**
+ * Forgets the replication keyframe, so that the next message is a keyframe.
+ */
+void ObstacleWorld::resetState() {
+    _hasKeyframe = false;
+    for (Slot& slot : _slots) {
+        slot.hasBaseline = false;
+    }
+}
+
+/**
+ * Returns the replicated fields of the body that differ from the baseline.
+ *
+ * The fields are compared at the precision they are sent with, so noise
+ * below the quantization step does not count as a change.
+ *
+ * @param data      The current body state
+ * @param baseline  The body state at the last keyframe
+ *
+ * @return the replicated fields of the body that differ from the baseline.
+ */
+Uint32 ObstacleWorld::changedFields(const BodyNetData& data, const BodyNetData& baseline) const {
+    Vec2 min = _bounds.origin;
+    Vec2 max = _bounds.origin + _bounds.size;
+    float speed = symmetricMax(_stateSpeed, _velocityBits);
+    auto differ = [](float a, float b, float min, float max, int bits) {
+        return NetworkSerializer::quantize(a, min, max, bits) != NetworkSerializer::quantize(b, min, max, bits);
+    };
+
+    Uint32 fields = 0;
+    if (differ(data.position.x, baseline.position.x, min.x, max.x, _positionBits) ||
+        differ(data.position.y, baseline.position.y, min.y, max.y, _positionBits)) {
+        fields |= STATE_POSITION;
+    }
+    if (differ(wrapAngle(data.angle), wrapAngle(baseline.angle), -M_PI, M_PI, _angleBits)) {
+        fields |= STATE_ANGLE;
+    }
+    if (differ(data.linearVelocity.x, baseline.linearVelocity.x, -_stateSpeed, speed, _velocityBits) ||
+        differ(data.linearVelocity.y, baseline.linearVelocity.y, -_stateSpeed, speed, _velocityBits)) {
+        fields |= STATE_VELOCITY;
+    }
+    if (packFlags(data) != packFlags(baseline)) {
+        fields |= STATE_FLAGS;
+    }
+    if (data.gravityScale != baseline.gravityScale || data.angularDamping != baseline.angularDamping ||
+        data.linearDamping != baseline.linearDamping) {
+        fields |= STATE_SCALES;
     }
+    return fields;
 }
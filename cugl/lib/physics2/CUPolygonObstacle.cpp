@@ -145,6 +145,32 @@ bool PolygonObstacle::initWithAnchor(const Poly2& poly, const Vec2 anchor) {
     return true;
 }
 
+/**
+ * Initializes a copy of the given polygon obstacle
+ *
+ * The copy shares the polygon and the triangle shapes with the original,
+ * so no shape is recomputed. Shared data is only copied if either obstacle
+ * later changes its polygon. The copy has the same body, fixture and mass
+ * settings as the original (see {@link Obstacle#clone}), but it is not part
+ * of any world.
+ *
+ * @param  other    The polygon obstacle to copy
+ *
+ * @return  true if the obstacle is initialized properly, false otherwise.
+ */
+bool PolygonObstacle::initWithClone(const PolygonObstacle& other) {
+    copySettings(other);
+    _anchor  = other._anchor;
+    _polygon = other._polygon;
+    _shapes  = other._shapes;
+    _fixCount = other._fixCount;
+    _realgeoms = new b2Fixture*[_fixCount];
+    _drawgeoms = new b2Fixture*[_fixCount];
+    for(int ii = 0; ii < _fixCount; ii++) { _realgeoms[ii] = nullptr; }
+    for (int ii = 0; ii < _fixCount; ii++) { _drawgeoms[ii] = nullptr; }
+    return true;
+}
+
 /**
  * Deletes this physics object and all of its resources.
  *
@@ -153,10 +179,6 @@ bool PolygonObstacle::initWithAnchor(const Poly2& poly, const Vec2 anchor) {
  */
 PolygonObstacle::~PolygonObstacle() {
     CUAssertLog(_realbody == nullptr || _drawbody == nullptr, "You must deactive physics before deleting an object");
-    if (_shapes != nullptr) {
-        delete[] _shapes;
-        _shapes = nullptr;
-    }
     if (_realgeoms != nullptr) {
         delete[] _realgeoms;
         _realgeoms = nullptr;
@@ -181,9 +203,10 @@ void PolygonObstacle::resize(const Size size) {
     // Need to do two things:
     // 1. Adjust the polygon.
     // 2. Update the shape information
-    float origwide = _polygon.getBounds().size.width;
-    float orighigh = _polygon.getBounds().size.height;
-    _polygon *= Vec2(size.width/origwide, size.height/orighigh);
+    // The polygon may be shared with a clone, so resize a copy
+    float origwide = _polygon->getBounds().size.width;
+    float orighigh = _polygon->getBounds().size.height;
+    _polygon = std::make_shared<Poly2>(*_polygon * Vec2(size.width/origwide, size.height/orighigh));
     if (_debug != nullptr) {
         resetDebug();
     }
@@ -195,25 +218,24 @@ void PolygonObstacle::resize(const Size size) {
  * This must be called whenever the polygon is resized.
  */
 void PolygonObstacle::resetShapes() {
-    int ntris =  (int)_polygon.indices.size() / 3;
-    if (_shapes != nullptr) {
-        delete[] _shapes;
-    }
+    int ntris =  (int)_polygon->indices.size() / 3;
     
+    // Never modify the old shapes in place, as they may be shared with a clone
     Vec2 pos = getPosition();
-    _shapes = new b2PolygonShape[ntris];
+    b2PolygonShape* shapes = new b2PolygonShape[ntris];
+    _shapes.reset(shapes, std::default_delete<b2PolygonShape[]>());
     b2Vec2 triangle[3];
     int index = 0;
     for(int ii = 0; ii < ntris; ii++) {
         for(int jj = 0; jj < 3; jj++) {
-            Uint32 ind = _polygon.indices[3*ii+jj];
-            Vec2 temp = _polygon.vertices[ind]-pos;
+            Uint32 ind = _polygon->indices[3*ii+jj];
+            Vec2 temp = _polygon->vertices[ind]-pos;
             triangle[jj].x = temp.x;
             triangle[jj].y = temp.y;
         }
         // Only add non-degenerate triangles
         if (valid_shape(triangle, 3)) {
-            _shapes[index++].Set(triangle,3);
+            shapes[index++].Set(triangle,3);
         }
     }
     ntris = index;
@@ -248,9 +270,9 @@ void PolygonObstacle::setAnchor(float x, float y) {
     _anchor.set(x,y);
     
     // Compute the position from the anchor point
-    Vec2 pos = _polygon.getBounds().origin;
-    pos.x += x*_polygon.getBounds().size.width;
-    pos.y += x*_polygon.getBounds().size.height;
+    Vec2 pos = _polygon->getBounds().origin;
+    pos.x += x*_polygon->getBounds().size.width;
+    pos.y += x*_polygon->getBounds().size.height;
     setPosition(pos.x,pos.y);
     resetShapes();
 }
@@ -264,7 +286,8 @@ void PolygonObstacle::setAnchor(float x, float y) {
  * @param value   the polygon defining this object
  */
 void PolygonObstacle::setPolygon(const Poly2& poly) {
-    _polygon.set(poly);
+    // The polygon may be shared with a clone, so never modify it in place
+    _polygon = std::make_shared<Poly2>(poly);
     resetShapes();
 }
 
@@ -280,14 +303,14 @@ void PolygonObstacle::setPolygon(const Poly2& poly) {
  */
 void PolygonObstacle::resetDebug() {
     if (_debug == nullptr) {
-        _debug = scene2::WireNode::allocWithTraversal(_polygon,poly2::Traversal::INTERIOR);
+        _debug = scene2::WireNode::allocWithTraversal(*_polygon,poly2::Traversal::INTERIOR);
         _debug->setColor(_dcolor);
         if (_scene != nullptr) {
             _scene->addChild(_debug);
         }
     } else {
         _debug->setTraversal(poly2::Traversal::INTERIOR);
-        _debug->setPolygon(_polygon);
+        _debug->setPolygon(*_polygon);
     }
     _debug->setAnchor(_anchor);
     _debug->setPosition(getPosition());
@@ -314,7 +337,7 @@ void PolygonObstacle::createFixtures() {
         _drawgeoms = new b2Fixture*[_fixCount];
     }
     for(int ii = 0; ii < _fixCount; ii++) {
-        _fixture.shape = &(_shapes[ii]);
+        _fixture.shape = &(_shapes.get()[ii]);
         _realgeoms[ii] = _realbody->CreateFixture(&_fixture);
         _drawgeoms[ii] = _drawbody->CreateFixture(&_fixture);
     }
@@ -47,6 +47,24 @@
 
 using namespace cugl::physics2;
 
+/**
+ * Copies the body, fixture, mass and snap settings of the given obstacle.
+ *
+ * If the other obstacle has a body, this copies its current body state
+ * as well. This is used by {@link clone} in the subclasses.
+ *
+ * @param other The obstacle to copy
+ */
+void SimpleObstacle::copySettings(const SimpleObstacle& other) {
+    Obstacle::copySettings(other);
+    _posSnap = other._posSnap;
+    _posFact = other._posFact;
+    _angSnap = other._angSnap;
+    _angFact = other._angFact;
+    if (other._realbody != nullptr) {
+        setBodyState(*other._realbody);
+    }
+}
 
 #pragma mark -
 #pragma mark Fixture Methods
@@ -169,6 +187,28 @@ void SimpleObstacle::setFilterData(b2Filter value) {
     }
 }
 
+/**
+ * Sets the user data stored in the fixtures of this object
+ *
+ * Box2D lets each fixture carry a single integer (or pointer) of user data.
+ * The body user data is reserved for this obstacle, but the fixture user
+ * data is free for the game, and is typically used to identify an object
+ * in a contact callback without searching for it.
+ *
+ * @param value  the user data stored in the fixtures of this object
+ */
+void SimpleObstacle::setUserData(uintptr_t value) {
+    _fixture.userData.pointer = value;
+    if (_realbody != nullptr && _drawbody != nullptr) {
+        for (b2Fixture* f = _realbody->GetFixtureList(); f; f = f->GetNext()) {
+            f->GetUserData().pointer = value;
+        }
+        for (b2Fixture* f = _drawbody->GetFixtureList(); f; f = f->GetNext()) {
+            f->GetUserData().pointer = value;
+        }
+    }
+}
+
 
 #pragma mark -
 #pragma mark Physics Methods
@@ -279,7 +319,7 @@ void SimpleObstacle::updateDebug() {
 void SimpleObstacle::syncBodies() {
     _drawbody->SetType(_realbody->GetType());
     _drawbody->SetTransform(_realbody->GetPosition(), _realbody->GetAngle());
-    _drawbody->SetEnabled(_realbody->IsEnabled());
+    _drawbody->SetEnabled(_interpolated && _realbody->IsEnabled());
     _drawbody->SetAwake(_realbody->IsAwake());
     _drawbody->SetBullet(_realbody->IsBullet());
     _drawbody->SetLinearVelocity(_realbody->GetLinearVelocity());
@@ -290,6 +330,21 @@ void SimpleObstacle::syncBodies() {
     _drawbody->SetLinearDamping(_realbody->GetLinearDamping());
 }
 
+/**
+ * Sets whether the draw body is simulated for the remaining frame time.
+ *
+ * If this is false, the draw body is disabled, so that it is out of the
+ * broad-phase of the draw world.
+ *
+ * @param value whether the draw body is simulated
+ */
+void SimpleObstacle::setInterpolated(bool value) {
+    _interpolated = value;
+    if (_realbody != nullptr && _drawbody != nullptr) {
+        _drawbody->SetEnabled(value && _realbody->IsEnabled());
+    }
+}
+
 BodyNetData SimpleObstacle::getBodyData() {
     BodyNetData data;
     data.id = _id;
@@ -301,7 +356,7 @@ BodyNetData SimpleObstacle::getBodyData() {
     data.bullet = _realbody->IsBullet();
     data.linearVelocity = _realbody->GetLinearVelocity();
     data.sleepingAllowed = _realbody->IsSleepingAllowed();
-    data.fixedRotation = _realbody->GetGravityScale();
+    data.fixedRotation = _realbody->IsFixedRotation();
     data.gravityScale = _realbody->GetGravityScale();
     data.angularDamping = _realbody->GetAngularDamping();
     data.linearDamping = _realbody->GetLinearDamping();
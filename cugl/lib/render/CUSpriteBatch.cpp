@@ -578,6 +578,11 @@ const Mat4& SpriteBatch::getPerspective() const {
 void SpriteBatch::setTexture(const std::shared_ptr<Texture>& texture) {
     if (texture == _context->texture) {
         return;
+    } else if (texture != nullptr && _context->texture != nullptr &&
+               texture->getBuffer() == _context->texture->getBuffer()) {
+        // Texture coordinates are baked into the vertices, so sharing a page is free
+        _context->texture = texture;
+        return;
     }
 
     if (_inflight) { record(); }
@@ -564,8 +564,9 @@ std::shared_ptr<Texture> Texture::getSubTexture(GLfloat minS, GLfloat maxS,
     // These values can be left alone.
     
     // Set the size information
-    result->_width  = (unsigned int)((maxS-minS)*source->_width);
-    result->_height = (unsigned int)((maxT-minT)*source->_height);
+    // Round, as pixel coordinates are rarely exact fractions of the size
+    result->_width  = (unsigned int)std::round((maxS-minS)*source->_width);
+    result->_height = (unsigned int)std::round((maxT-minT)*source->_height);
     result->_minS = minS;
     result->_maxS = maxS;
     result->_minT = minT;
@@ -61,7 +61,10 @@ _color(Color4::WHITE),
 _blendEquation(GL_FUNC_ADD),
 _srcFactor(GL_SRC_ALPHA),
 _dstFactor(GL_ONE_MINUS_SRC_ALPHA),
-_active(false)
+_active(false),
+_culling(false),
+_drawCount(0),
+_culledCount(0)
 {}
 
 /**
@@ -371,6 +374,16 @@ void Scene2::render(const std::shared_ptr<SpriteBatch>& batch) {
     batch->setDstBlendFunc(_dstFactor);
     batch->setBlendEquation(_blendEquation);
 
+    // Compute the camera view for culling
+    _drawCount = 0;
+    _culledCount = 0;
+    if (_culling) {
+        Vec2 corner1 = Vec2(-1,-1)*_camera->getInverseProjectView();
+        Vec2 corner2 = Vec2( 1, 1)*_camera->getInverseProjectView();
+        Vec2 origin(std::min(corner1.x,corner2.x),std::min(corner1.y,corner2.y));
+        _cullRect.set(origin.x,origin.y,fabsf(corner2.x-corner1.x),fabsf(corner2.y-corner1.y));
+    }
+
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         (*it)->render(batch, Affine2::IDENTITY, _color);
     }
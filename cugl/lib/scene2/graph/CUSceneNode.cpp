@@ -62,6 +62,8 @@ _hashOfName(0),
 _tintColor(Color4::WHITE),
 _hasParentColor(true),
 _isVisible(true),
+_isCullable(false),
+_cullDirty(true),
 _anchor(Vec2::ANCHOR_BOTTOM_LEFT),
 _scale(Vec2::ONE),
 _angle(0),
@@ -342,6 +344,7 @@ void SceneNode::setPosition(float x, float y) {
 void SceneNode::setContentSize(const Size size) {
     _position += _anchor*(size-_contentSize);
     _contentSize.set(size);
+    _cullDirty = true;
     if (!_useTransform) updateTransform();
     if (_layout) {
         doLayout();
@@ -637,6 +640,32 @@ void SceneNode::swapChild(const std::shared_ptr<SceneNode>& child1,
     }
 }
 
+/**
+ * Moves the child at position from to position to.
+ *
+ * The children in between shift over by one to make room, so this takes
+ * time proportional to the distance moved. Unlike removing and re-adding
+ * a child, the child never leaves the scene graph. This allows subclasses
+ * to keep their children sorted incrementally.
+ *
+ * @param from  The current position of the child
+ * @param to    The new position of the child
+ */
+void SceneNode::moveChild(unsigned int from, unsigned int to) {
+    CUAssertLog(from < _children.size() && to < _children.size(), "Position index out of bounds");
+    std::shared_ptr<SceneNode> child = _children[from];
+    for(unsigned int ii = from; ii < to; ii++) {
+        _children[ii] = _children[ii+1];
+        _children[ii]->_childOffset = ii;
+    }
+    for(unsigned int ii = from; ii > to; ii--) {
+        _children[ii] = _children[ii-1];
+        _children[ii]->_childOffset = ii;
+    }
+    _children[to] = child;
+    child->_childOffset = to;
+}
+
 /**
  * Removes the child at the given position from this Node.
  *
@@ -773,6 +802,20 @@ void SceneNode::render(const std::shared_ptr<SpriteBatch>& batch, const Affine2&
     
     Affine2 matrix;
     Affine2::multiply(_combined,transform,&matrix);
+    
+    // Skip this subtree if it is off camera
+    if (_isCullable && _graph != nullptr && _graph->_culling) {
+        if (_cullDirty || _cullTransform != matrix) {
+            _cullBounds = matrix.transform(Rect(Vec2::ZERO,_contentSize));
+            _cullTransform = matrix;
+            _cullDirty = false;
+        }
+        if (!_graph->_cullRect.doesIntersect(_cullBounds)) {
+            _graph->_culledCount++;
+            return;
+        }
+    }
+    
     Color4 color = _tintColor;
     if (_hasParentColor) {
         color *= tint;
@@ -789,6 +832,9 @@ void SceneNode::render(const std::shared_ptr<SpriteBatch>& batch, const Affine2&
     }
 
     draw(batch,matrix,color);
+    if (_graph != nullptr) {
+        _graph->_drawCount++;
+    }
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         (*it)->render(batch, matrix, color);
     }
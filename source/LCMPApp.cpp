@@ -49,6 +49,23 @@ void LCMPApp::onStartup() {
     
     // Initialize audio
     _audio = make_shared<AudioController>();
+    
+#ifdef COMPILE_LEVELS
+    // Compile the Tiled maps so that games do not have to parse them
+    for (string level : { LEVEL_ONE_FILE, LEVEL_DONUT_KEY, LEVEL_CONVEYOR_KEY }) {
+        string compiled = getSaveDirectory() + filetool::base_name(LevelData::getCompiledPath(level));
+        if (!LevelData::compile(level, compiled)) CULogError("Could not compile %s", level.c_str());
+        else CULog("Compiled %s to %s", level.c_str(), compiled.c_str());
+    }
+#endif
+
+#ifdef BOT_LOAD_TEST
+    // Spin up rooms of headless bots, which run alongside the game on their own thread
+    if (_bots.init(LEVEL_ONE_FILE, BOT_ROOMS, BOT_PLAYERS, (Uint32)time(NULL), BOT_STATS_INTERVAL,
+                   LoopbackNetwork::Conditions(BOT_LATENCY, BOT_JITTER, BOT_LOSS, BOT_REORDER))) {
+        _bots.start(BOT_DURATION, SIMULATION_STEP);
+    }
+#endif
 
     // Attach loaders to the asset manager
     _assets->attach<Font>(FontLoader::alloc()->getHook());
@@ -68,7 +85,6 @@ void LCMPApp::onStartup() {
     _assets->loadDirectoryAsync("json/skins.json",nullptr);
     _assets->loadDirectoryAsync("json/victory.json",nullptr);
     _assets->loadDirectoryAsync("json/pause.json", nullptr);
-    _assets->loadDirectoryAsync(WALL_ASSETS_FILE, nullptr);
     
     // Create a "loading" screen
     _scene = State::LOAD;
@@ -97,6 +113,7 @@ void LCMPApp::onShutdown() {
     
     _loading.dispose();
     _game.dispose();
+    _bots.dispose();
     _audio->dispose();
     _actions = nullptr;
     _assets = nullptr;
@@ -23,6 +23,7 @@
 #include "LCMPVictoryScene.h"
 #include "LCMPShopScene.h"
 #include "LCMPGachaScene.h"
+#include "LCMPBotDriver.h"
 
 /**
  * This class represents the application root for Low Control Mall Patrol
@@ -92,6 +93,8 @@ protected:
     ShopScene _shop;
     /** The scene to show the gacha game */
     GachaScene _gacha;
+    /** The headless bots of the load test (only run with BOT_LOAD_TEST) */
+    BotDriver _bots;
 
     /** The key for which level the game will take place in */
     string _levelKey;
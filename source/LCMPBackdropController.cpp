@@ -0,0 +1,175 @@
+//
+//  LCMPBackdropController.cpp
+//  Low Control Mall Patrol
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#include "LCMPBackdropController.h"
+
+using namespace cugl;
+using namespace std;
+
+//  MARK: - Constructors
+
+/**
+ * Disposes of all resources in this instance of Backdrop Controller, unloading every chunk
+ */
+void BackdropController::dispose() {
+    for (int i = 0; i < _chunks.size(); i++) {
+        if (_chunks[i].state == Loaded) evict(i);
+    }
+
+    // Pending loads are abandoned; their textures are adopted by the next controller
+    _alive = nullptr;
+    _chunks.clear();
+    _node = nullptr;
+    _assets = nullptr;
+    _resident = 0;
+}
+
+/**
+ * Initializes a Backdrop Controller for a grid of chunks listed in the given asset directory
+ *
+ * The grid is as large as the chunk keys in the directory say, so a floor plan cut into
+ * more (or fewer) chunks needs no code change. A chunk missing from the grid is left empty.
+ */
+bool BackdropController::init(const shared_ptr<scene2::SceneNode>& node,
+                              const shared_ptr<AssetManager>& assets,
+                              const string& directory, float scale) {
+    shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(directory);
+    if (reader == nullptr) return false;
+    shared_ptr<JsonValue> textures = reader->readJson()->get("textures");
+    if (textures == nullptr) return false;
+
+    int rows = 0;
+    int cols = 0;
+    for (int i = 0; i < textures->size(); i++) {
+        int row, col;
+        if (sscanf(textures->get(i)->key().c_str(), BACKDROP_CHUNK_KEY, &row, &col) == 2) {
+            rows = max(rows, row);
+            cols = max(cols, col);
+        }
+    }
+    if (rows == 0 || cols == 0) {
+        CULogError("No backdrop chunks in %s", directory.c_str());
+        return false;
+    }
+
+    _node = node;
+    _assets = assets;
+    _alive = make_shared<bool>(true);
+    _rows = rows;
+    _cols = cols;
+    _scale = scale;
+    _chunkSize = BACKDROP_CHUNK_SIZE * scale;
+    _resident = 0;
+
+    _chunks.resize(rows * cols);
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            Chunk& chunk = _chunks[row * cols + col];
+            chunk.key = strtool::format(BACKDROP_CHUNK_KEY, row + 1, col + 1);
+            shared_ptr<JsonValue> entry = textures->get(chunk.key);
+            chunk.file = (entry == nullptr ? "" : entry->getString("file"));
+        }
+    }
+    return true;
+}
+
+//  MARK: - Methods
+
+/**
+ * Loads the chunks near the given view (in node coordinates) and evicts the ones far from it
+ */
+void BackdropController::update(Rect view) {
+    if (_chunkSize <= 0) return;
+    int minCol = (int)floor(view.getMinX() / _chunkSize);
+    int maxCol = (int)floor(view.getMaxX() / _chunkSize);
+    int minRow = (int)floor(view.getMinY() / _chunkSize);
+    int maxRow = (int)floor(view.getMaxY() / _chunkSize);
+
+    for (int row = 0; row < _rows; row++) {
+        for (int col = 0; col < _cols; col++) {
+            // The distance (in chunks) from the chunks in view
+            int dx = max(0, max(minCol - col, col - maxCol));
+            int dy = max(0, max(minRow - row, row - maxRow));
+            int distance = max(dx, dy);
+
+            int index = row * _cols + col;
+            Chunk& chunk = _chunks[index];
+            if (distance <= BACKDROP_PREFETCH) {
+                if (chunk.state == Unloaded) {
+                    request(index);
+                } else if (chunk.state == Loading && _assets->get<Texture>(chunk.key) != nullptr) {
+                    // Another controller finished loading this texture
+                    attach(index);
+                }
+            } else if (distance > BACKDROP_PREFETCH + BACKDROP_HYSTERESIS && chunk.state == Loaded) {
+                evict(index);
+            }
+        }
+    }
+}
+
+//  MARK: - Helpers
+
+/**
+ * Starts loading a chunk, or attaches it if its texture is already loaded
+ */
+void BackdropController::request(int index) {
+    Chunk& chunk = _chunks[index];
+    if (chunk.file.empty()) return;
+    chunk.state = Loading;
+    if (_assets->get<Texture>(chunk.key) != nullptr) {
+        attach(index);
+        return;
+    }
+
+    // The image is decoded on the asset worker, and uploaded on the main thread
+    weak_ptr<bool> alive = _alive;
+    _assets->loadAsync<Texture>(chunk.key, chunk.file, [=](const string& key, bool success) {
+        if (alive.expired()) return;
+        if (!success) {
+            CULogError("Failed to load backdrop chunk %s", key.c_str());
+            _chunks[index].state = Unloaded;
+            return;
+        }
+        if (_chunks[index].state == Loading) attach(index);
+    });
+}
+
+/**
+ * Attaches the node for a chunk whose texture has finished loading
+ */
+void BackdropController::attach(int index) {
+    Chunk& chunk = _chunks[index];
+    shared_ptr<Texture> texture = _assets->get<Texture>(chunk.key);
+    if (texture == nullptr) return;
+
+    int row = index / _cols;
+    int col = index % _cols;
+    chunk.node = scene2::PolygonNode::allocWithTexture(texture);
+    chunk.node->setAnchor(Vec2::ANCHOR_BOTTOM_LEFT);
+    chunk.node->setScale(_scale);
+    chunk.node->setPosition(col * _chunkSize, row * _chunkSize);
+    chunk.node->setCullable(true);
+    _node->addChild(chunk.node);
+    chunk.state = Loaded;
+    _resident++;
+}
+
+/**
+ * Removes the node of a chunk and unloads its texture
+ */
+void BackdropController::evict(int index) {
+    Chunk& chunk = _chunks[index];
+    if (chunk.node != nullptr) {
+        chunk.node->removeFromParent();
+        chunk.node = nullptr;
+    }
+    _assets->unload<Texture>(chunk.key);
+    chunk.state = Unloaded;
+    _resident--;
+}
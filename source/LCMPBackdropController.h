@@ -0,0 +1,117 @@
+//
+//  LCMPBackdropController.h
+//  Low Control Mall Patrol
+//
+//  This class streams the chunks of the floor plan backdrop. Only the chunks
+//  near the camera (plus a prefetch ring) are loaded; they are decoded on the
+//  asset worker thread, and evicted again once the camera moves away.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#ifndef __LCMP_BACKDROP_CONTROLLER_H__
+#define __LCMP_BACKDROP_CONTROLLER_H__
+#include <cugl/cugl.h>
+#include "LCMPConstants.h"
+
+class BackdropController {
+protected:
+    /** The loading state of a chunk */
+    enum State {
+        Unloaded,
+        Loading,
+        Loaded
+    };
+
+    /** A single chunk of the backdrop */
+    struct Chunk {
+        /** The asset key of the chunk texture */
+        std::string key;
+        /** The file of the chunk texture */
+        std::string file;
+        /** The loading state of the chunk */
+        State state = Unloaded;
+        /** The node displaying the chunk, if loaded */
+        std::shared_ptr<cugl::scene2::PolygonNode> node;
+    };
+
+//  MARK: - Properties
+
+    /** Reference to the asset manager that loads the chunk textures */
+    std::shared_ptr<cugl::AssetManager> _assets;
+    /** Reference to the node holding the chunks */
+    std::shared_ptr<cugl::scene2::SceneNode> _node;
+    /** The chunks, stored row major */
+    std::vector<Chunk> _chunks;
+    /** A token that pending loads check to see if this controller is still alive */
+    std::shared_ptr<bool> _alive;
+    /** The number of chunk rows */
+    int _rows;
+    /** The number of chunk columns */
+    int _cols;
+    /** The scale of the chunk textures */
+    float _scale;
+    /** The size of a chunk in node coordinates */
+    float _chunkSize;
+    /** The number of chunks currently loaded */
+    int _resident;
+
+public:
+//  MARK: - Constructors
+
+    /**
+     * Constructs a Backdrop Controller
+     */
+    BackdropController() : _rows(0), _cols(0), _scale(1), _chunkSize(0), _resident(0) {}
+
+    /**
+     * Destructs a Backdrop Controller
+     */
+    ~BackdropController() { dispose(); }
+
+    /**
+     * Disposes of all resources in this instance of Backdrop Controller, unloading every chunk
+     */
+    void dispose();
+
+    /**
+     * Initializes a Backdrop Controller for a grid of chunks listed in the given asset directory
+     */
+    bool init(const std::shared_ptr<cugl::scene2::SceneNode>& node,
+              const std::shared_ptr<cugl::AssetManager>& assets,
+              const std::string& directory, float scale);
+
+//  MARK: - Methods
+
+    /**
+     * Loads the chunks near the given view (in node coordinates) and evicts the ones far from it
+     */
+    void update(cugl::Rect view);
+
+    /**
+     * Returns the number of chunks currently loaded
+     */
+    int getResidentCount() const { return _resident; }
+
+private:
+//  MARK: - Helpers
+
+    /**
+     * Starts loading a chunk, or attaches it if its texture is already loaded
+     */
+    void request(int index);
+
+    /**
+     * Attaches the node for a chunk whose texture has finished loading
+     */
+    void attach(int index);
+
+    /**
+     * Removes the node of a chunk and unloads its texture
+     */
+    void evict(int index);
+
+};
+
+#endif /* __LCMP_BACKDROP_CONTROLLER_H__ */
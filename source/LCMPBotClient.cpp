@@ -0,0 +1,296 @@
+//
+//  LCMPBotClient.cpp
+//  Low Control Mall Patrol
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#include "LCMPBotClient.h"
+#include "LCMPConstants.h"
+
+using namespace cugl;
+using namespace std;
+
+//  MARK: - Constants
+
+/** The shortest time (in seconds) a random walk keeps its direction */
+#define WALK_MIN_TIME       0.25f
+/** The longest time (in seconds) a random walk keeps its direction */
+#define WALK_MAX_TIME       1.5f
+/** The probability that a random walk stands still instead of picking a direction */
+#define WALK_IDLE_CHANCE    0.1f
+/** How close (in world units) the thief must be for a cop to tackle it */
+#define TACKLE_RANGE        3.0f
+/** How often (per second) a cop tackles the thief while it is in range */
+#define TACKLE_CHANCE       1.0f
+
+//  MARK: - Constructors
+
+/**
+ * Disposes of all resources in this instance of Bot Client
+ */
+void BotClient::dispose() {
+    _simulation.dispose();
+    _replication.dispose();
+    _collision.dispose();
+    _game = nullptr;
+    _world = nullptr;
+    if (_network != nullptr) _network->disconnect();
+    _network = nullptr;
+    _loopback = nullptr;
+}
+
+/**
+ * Initializes a Bot Client that hosts a room, and starts the level once enough players join
+ */
+bool BotClient::initHost(const std::shared_ptr<cugl::LoopbackNetwork>& loopback,
+                         const std::string& level, int players, Uint32 seed) {
+    _isHost = true;
+    _level = level;
+    _players = players;
+    _loopback = loopback;
+    _network = make_shared<NetworkController>();
+    _network->setLoopback(loopback);
+    _network->setHost(true);
+    initPolicy(seed);
+    return _network->connect();
+}
+
+/**
+ * Initializes a Bot Client that joins the room with the given ID
+ */
+bool BotClient::initClient(const std::shared_ptr<cugl::LoopbackNetwork>& loopback,
+                           const std::string& room, Uint32 seed) {
+    _isHost = false;
+    _loopback = loopback;
+    _network = make_shared<NetworkController>();
+    _network->setLoopback(loopback);
+    _network->setHost(false);
+    initPolicy(seed);
+    return _network->connect(room);
+}
+
+//  MARK: - Methods
+
+/**
+ * Updates the bot for one frame, in the lobby or in the game
+ *
+ * The frame time covers everything a player's frame does except drawing: the network, the
+ * policy standing in for input, and the physics.
+ */
+void BotClient::update(float timestep) {
+    Timestamp start;
+    if (_game == nullptr) updateLobby();
+    else updateGame(timestep);
+    Timestamp end;
+
+    _frameTime = Timestamp::ellapsedMicros(start, end) / 1000000.0f;
+    _maxFrameTime = max(_maxFrameTime, _frameTime);
+    _totalFrameTime += _frameTime;
+    _frames++;
+}
+
+/**
+ * Uses a random walk as the movement policy
+ */
+void BotClient::setRandomWalk() {
+    _policy = RANDOM_WALK;
+    _movement = Vec2::ZERO;
+    _stepTime = 0;
+}
+
+/**
+ * Uses the given script, repeated forever, as the movement policy
+ */
+void BotClient::setScript(const std::vector<Step>& script) {
+    _policy = SCRIPTED;
+    _script = script;
+    _step = 0;
+    _stepTime = script.empty() ? 0 : script[0].duration;
+}
+
+//  MARK: - Stats
+
+/**
+ * Resets the frame time stats
+ */
+void BotClient::resetStats() {
+    _frameTime = 0;
+    _maxFrameTime = 0;
+    _totalFrameTime = 0;
+    _frames = 0;
+    _replication.resetStats();
+}
+
+/**
+ * Logs the stats of this bot on a single line
+ *
+ * Each connected peer is listed with its round trip time and the packets per second
+ * received from it.
+ */
+void BotClient::logStats() const {
+    int self = _network->getPlayerID() ? *_network->getPlayerID() : 0;
+    string peers;
+    for (int playerID = 0; playerID < 5; playerID++) {
+        if (playerID == self || !_network->isPlayerConnected(playerID)) continue;
+        peers += " " + to_string(playerID) + ":"
+            + strtool::to_string(getRTT(playerID) * 1000, 1) + "ms/"
+            + strtool::to_string(getUpdateRate(playerID), 1) + "pps";
+    }
+    CULog("Bot %d: frame %.2fms (avg %.2fms, max %.2fms) divergence %.3f (%d corrections) peers%s",
+          self, _frameTime * 1000, getAverageFrameTime() * 1000, _maxFrameTime * 1000,
+          getDivergence(), getCorrectionCount(), peers.c_str());
+    _replication.logStats();
+}
+
+//  MARK: - Helpers
+
+/**
+ * Seeds the random walk and clears the stats
+ */
+void BotClient::initPolicy(Uint32 seed) {
+    _random.seed(seed);
+    setRandomWalk();
+    resetStats();
+    _named = false;
+    _game = nullptr;
+}
+
+/**
+ * Waits in the lobby until the game starts
+ *
+ * The host starts the game as soon as enough players have joined it.
+ */
+void BotClient::updateLobby() {
+    _network->update();
+    if (_network->getStatus() == NetworkController::WAIT && !_named) {
+        _network->sendDisplayName("Bot " + to_string(*_network->getPlayerID()));
+        _named = true;
+    }
+
+    if (_isHost && _network->getStatus() == NetworkController::WAIT && _network->getNumPlayers() >= _players) {
+        _network->sendStartGame(_level);
+        startGame(_level);
+    } else if (!_isHost && _network->getStatus() == NetworkController::START) {
+        startGame(_network->getLevel());
+    }
+}
+
+/**
+ * Builds the headless game once the host starts it
+ */
+void BotClient::startGame(const std::string& level) {
+    _playerNumber = _network->getPlayerNumber();
+    _doneTime = 0;
+
+    // The world is set up as in the game scene, as catches are detected by collisions, but
+    // nothing is drawn, so there is no need to interpolate
+    _world = physics2::ObstacleWorld::alloc(Rect(0, 0, WORLD_WIDTH, WORLD_HEIGHT), Vec2::ZERO);
+    _world->setInterpolated(false);
+    _world->activateCollisionCallbacks(true);
+    _world->onBeginContact = [this](b2Contact* contact) { _collision.beginContact(contact); };
+    _world->onEndContact = [this](b2Contact* contact) { _collision.endContact(contact); };
+    _world->activateFilterCallbacks(true);
+    _world->shouldCollide = [this](b2Fixture* f1, b2Fixture* f2) { return _collision.shouldCollide(f1, f2); };
+
+    // Without assets or nodes, the game is headless
+    shared_ptr<scene2::SceneNode> none = nullptr;
+    shared_ptr<scene2::ActionManager> actions = nullptr;
+    _game = make_shared<GameModel>();
+    if (!_game->init(_world, none, none, none, nullptr, 1.0f, level, actions, "")) {
+        CULogError("Bot could not start level %s", level.c_str());
+        _game = nullptr;
+        return;
+    }
+    _simulation.init(_game, _world, _network, _isHost);
+    _collision.init(_game);
+#ifdef CHECK_REPLICATION
+    if (_isHost) _replication.init(_game, level, _random());
+#endif
+}
+
+/**
+ * Plays the game for one frame
+ *
+ * This follows a frame of the game scene, with the policy in place of the input controller.
+ * The frame goes through the same simulation as the game scene, so the bot runs the same
+ * fixed steps (and replays the same predictions) as a player would.
+ */
+void BotClient::updateGame(float timestep) {
+    // Between rounds, the game scene only waits
+    if (_game->isGameOver()) {
+        _doneTime += timestep;
+        if (_doneTime >= RESET_TIME) reset();
+        return;
+    }
+
+    // Keep track of time, on the host clock once it is known
+    if (_simulation.updateClock(timestep)) {
+        _simulation.endRound();
+        return;
+    }
+
+    // The policy stands in for the joystick, and for the swipe of a cop
+    Vec2 movement = nextMovement(timestep);
+    bool swipe = nextTackle(timestep);
+    Vec2 tackle;
+    if (swipe) {
+        tackle = _game->getThief()->getPosition() - _game->getCop(_playerNumber)->getPosition();
+        tackle.normalize();
+    }
+    _simulation.step(timestep, movement, false, swipe, tackle);
+    _replication.check(_game, _world);
+    _simulation.checkGameOver();
+}
+
+/**
+ * Rewinds the game to the start of a new round
+ */
+void BotClient::reset() {
+    _doneTime = 0;
+    _simulation.reset();
+    _replication.reset();
+    _collision.init(_game);
+}
+
+/**
+ * Returns true iff the cop of this bot should lunge at the thief this frame
+ *
+ * A cop lunges now and then while the thief is in range.
+ */
+bool BotClient::nextTackle(float timestep) {
+    if (_playerNumber == -1) return false;
+    shared_ptr<CopModel> cop = _game->getCop(_playerNumber);
+    float distance = (_game->getThief()->getPosition() - cop->getPosition()).length();
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    return !cop->getTackling() && distance < TACKLE_RANGE && unit(_random) < TACKLE_CHANCE * timestep;
+}
+
+/**
+ * Advances the policy, returning the movement for this frame
+ */
+Vec2 BotClient::nextMovement(float timestep) {
+    _stepTime -= timestep;
+    if (_policy == SCRIPTED) {
+        if (_script.empty()) return Vec2::ZERO;
+        if (_stepTime <= 0) {
+            _step = (_step + 1) % _script.size();
+            _stepTime = _script[_step].duration;
+        }
+        return _script[_step].movement;
+    }
+
+    // Pick a new direction (or stand still) every so often
+    if (_stepTime <= 0) {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        _stepTime = WALK_MIN_TIME + (WALK_MAX_TIME - WALK_MIN_TIME) * unit(_random);
+        if (unit(_random) < WALK_IDLE_CHANCE) {
+            _movement = Vec2::ZERO;
+        } else {
+            float angle = 2 * M_PI * unit(_random);
+            _movement = Vec2(cosf(angle), sinf(angle));
+        }
+    }
+    return _movement;
+}
@@ -0,0 +1,262 @@
+//
+//  LCMPBotClient.h
+//  Low Control Mall Patrol
+//
+//  This class is a headless player for load testing. A bot has its own network
+//  controller, physics world and game model, but no scene graph, sprite batch
+//  or audio, so dozens of them can run in one process. Bots talk over a shared
+//  loopback network, whose owner advances it every frame along with the bots:
+//
+//      loopback->update(timestep);
+//      for (auto& bot : bots) bot->update(timestep);
+//
+//  One bot hosts the room and starts the game once enough players have joined,
+//  and the others join it by its room ID. A room holds at most five players,
+//  so a large test runs several rooms, each on its own loopback network.
+//  Every bot records its frame time, the round trip time and update rate of
+//  each peer, and how far its predictions diverge from the host state.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#ifndef __LCMP_BOT_CLIENT_H__
+#define __LCMP_BOT_CLIENT_H__
+#include <cugl/cugl.h>
+#include <random>
+#include "LCMPNetworkController.h"
+#include "LCMPGameModel.h"
+#include "LCMPCollisionController.h"
+#include "LCMPSimulationController.h"
+#include "LCMPReplicationCheck.h"
+
+class BotClient {
+public:
+//  MARK: - Enumerations
+
+    /** The ways a bot can choose its movement */
+    enum Policy {
+        /** Walk in a random direction, changing it every so often */
+        RANDOM_WALK,
+        /** Repeat a script of movements */
+        SCRIPTED
+    };
+
+    /** One step of a scripted policy */
+    struct Step {
+        /** The movement (joystick) held for the step */
+        cugl::Vec2 movement;
+        /** The length (in seconds) of the step */
+        float duration;
+    };
+
+protected:
+//  MARK: - Properties
+
+    /** The loopback network shared with the other bots */
+    std::shared_ptr<cugl::LoopbackNetwork> _loopback;
+    /** The network controller of this bot */
+    std::shared_ptr<NetworkController> _network;
+    /** The physics world of this bot */
+    std::shared_ptr<cugl::physics2::ObstacleWorld> _world;
+    /** The headless game, or nullptr while in the lobby */
+    std::shared_ptr<GameModel> _game;
+    /** The collision controller of the game */
+    CollisionController _collision;
+    /** The simulation of the game, shared with the game scene */
+    SimulationController _simulation;
+    /** The replication check of the host (only run with CHECK_REPLICATION) */
+    ReplicationCheck _replication;
+
+    /** Whether this bot is the host */
+    bool _isHost;
+    /** The level the host starts the game with */
+    std::string _level;
+    /** The number of players (including the host) the host waits for */
+    int _players;
+    /** Whether the display name has been sent */
+    bool _named;
+    /** The player number of this bot (-1 for the thief) */
+    int _playerNumber;
+    /** The time (in seconds) since the round ended */
+    float _doneTime;
+
+    /** The movement policy */
+    Policy _policy;
+    /** The script of the scripted policy */
+    std::vector<Step> _script;
+    /** The random number generator of the policy */
+    std::mt19937 _random;
+    /** The current movement */
+    cugl::Vec2 _movement;
+    /** The current step of the script */
+    int _step;
+    /** The time (in seconds) left before the movement changes */
+    float _stepTime;
+
+    /** The length (in seconds) of the last update */
+    float _frameTime;
+    /** The longest update (in seconds) since the stats were reset */
+    float _maxFrameTime;
+    /** The total length (in seconds) of the updates since the stats were reset */
+    float _totalFrameTime;
+    /** The number of updates since the stats were reset */
+    int _frames;
+
+public:
+//  MARK: - Constructors
+
+    /**
+     * Constructs a Bot Client
+     */
+    BotClient() : _isHost(false), _players(0), _named(false), _playerNumber(0),
+    _doneTime(0), _policy(RANDOM_WALK), _step(0), _stepTime(0), _frameTime(0), _maxFrameTime(0),
+    _totalFrameTime(0), _frames(0) {}
+
+    /**
+     * Destructs a Bot Client
+     */
+    ~BotClient() { dispose(); }
+
+    /**
+     * Disposes of all resources in this instance of Bot Client
+     */
+    void dispose();
+
+    /**
+     * Initializes a Bot Client that hosts a room, and starts the level once enough players join
+     */
+    bool initHost(const std::shared_ptr<cugl::LoopbackNetwork>& loopback,
+                  const std::string& level, int players, Uint32 seed);
+
+    /**
+     * Initializes a Bot Client that joins the room with the given ID
+     */
+    bool initClient(const std::shared_ptr<cugl::LoopbackNetwork>& loopback,
+                    const std::string& room, Uint32 seed);
+
+//  MARK: - Methods
+
+    /**
+     * Updates the bot for one frame, in the lobby or in the game
+     */
+    void update(float timestep);
+
+    /**
+     * Returns the room ID of the host
+     */
+    std::string getRoomID() const { return _network->getRoomID(); }
+
+    /**
+     * Returns true iff the bot has started the game
+     */
+    bool isPlaying() const { return _game != nullptr; }
+
+    /**
+     * Returns the network controller of this bot
+     */
+    const std::shared_ptr<NetworkController>& getNetwork() const { return _network; }
+
+    /**
+     * Returns the movement policy
+     */
+    Policy getPolicy() const { return _policy; }
+
+    /**
+     * Uses a random walk as the movement policy
+     */
+    void setRandomWalk();
+
+    /**
+     * Uses the given script, repeated forever, as the movement policy
+     */
+    void setScript(const std::vector<Step>& script);
+
+//  MARK: - Stats
+
+    /**
+     * Returns the length (in seconds) of the last update
+     */
+    float getFrameTime() const { return _frameTime; }
+
+    /**
+     * Returns the longest update (in seconds) since the stats were reset
+     */
+    float getMaxFrameTime() const { return _maxFrameTime; }
+
+    /**
+     * Returns the average update (in seconds) since the stats were reset
+     */
+    float getAverageFrameTime() const { return _frames == 0 ? 0 : _totalFrameTime / _frames; }
+
+    /**
+     * Returns the smoothed round trip time (in seconds) to the peer with the given player ID
+     */
+    float getRTT(int playerID) const { return _network->getRTT(playerID); }
+
+    /**
+     * Returns the packets per second received from the peer with the given player ID
+     */
+    float getUpdateRate(int playerID) const { return _network->getReceivedTraffic(playerID).packetsPerSecond; }
+
+    /**
+     * Returns the distance between the host state and the prediction for the last acknowledged input
+     */
+    float getDivergence() const { return _network->getPrediction().getLastError(); }
+
+    /**
+     * Returns the number of times the host corrected the prediction
+     */
+    int getCorrectionCount() const { return _network->getPrediction().getCorrectionCount(); }
+
+    /**
+     * Resets the frame time stats
+     */
+    void resetStats();
+
+    /**
+     * Logs the stats of this bot on a single line
+     */
+    void logStats() const;
+
+private:
+//  MARK: - Helpers
+
+    /**
+     * Seeds the random walk and clears the stats
+     */
+    void initPolicy(Uint32 seed);
+
+    /**
+     * Waits in the lobby until the game starts
+     */
+    void updateLobby();
+
+    /**
+     * Builds the headless game once the host starts it
+     */
+    void startGame(const std::string& level);
+
+    /**
+     * Plays the game for one frame
+     */
+    void updateGame(float timestep);
+
+    /**
+     * Rewinds the game to the start of a new round
+     */
+    void reset();
+
+    /**
+     * Returns true iff the cop of this bot should lunge at the thief this frame
+     */
+    bool nextTackle(float timestep);
+
+    /**
+     * Advances the policy, returning the movement for this frame
+     */
+    cugl::Vec2 nextMovement(float timestep);
+
+};
+
+#endif /* __LCMP_BOT_CLIENT_H__ */
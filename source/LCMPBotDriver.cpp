@@ -0,0 +1,126 @@
+//
+//  LCMPBotDriver.cpp
+//  Low Control Mall Patrol
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#include "LCMPBotDriver.h"
+
+using namespace cugl;
+using namespace std;
+
+//  MARK: - Constructors
+
+/**
+ * Disposes of all resources in this instance of Bot Driver
+ */
+void BotDriver::dispose() {
+    stop();
+    _rooms.clear();
+    _statsTime = 0;
+}
+
+/**
+ * Initializes a Bot Driver with the given number of rooms, each playing the level with the given number of bots
+ *
+ * A room holds at most five players, so the bots per room are clamped to that. The host of
+ * each room gets its room ID as soon as it connects to the loopback network, so the other
+ * bots join it right away, and the host starts the level once they are all in the lobby.
+ */
+bool BotDriver::init(const string& level, int rooms, int players, Uint32 seed, float interval,
+                     const LoopbackNetwork::Conditions& conditions) {
+    dispose();
+    _interval = interval;
+    players = max(1, min(players, 5));
+
+    for (int ii = 0; ii < rooms; ii++) {
+        Room room;
+        room.loopback = LoopbackNetwork::alloc(seed + ii);
+        room.loopback->setConditions(conditions);
+
+        auto host = make_shared<BotClient>();
+        if (!host->initHost(room.loopback, level, players, seed + ii * 5)) {
+            CULogError("Bot room %d could not be hosted", ii);
+            return false;
+        }
+        room.bots.push_back(host);
+
+        for (int jj = 1; jj < players; jj++) {
+            auto bot = make_shared<BotClient>();
+            if (!bot->initClient(room.loopback, host->getRoomID(), seed + ii * 5 + jj)) {
+                CULogError("Bot %d could not join room %d", jj, ii);
+                return false;
+            }
+            room.bots.push_back(bot);
+        }
+        _rooms.push_back(room);
+    }
+    CULog("Bot load test: %d rooms of %d bots on %s", rooms, players, level.c_str());
+    return true;
+}
+
+//  MARK: - Methods
+
+/**
+ * Advances every loopback network and bot by the timestep, logging the stats when they are due
+ */
+void BotDriver::update(float timestep) {
+    for (Room& room : _rooms) {
+        room.loopback->update(timestep);
+        for (auto& bot : room.bots) bot->update(timestep);
+    }
+
+    _statsTime += timestep;
+    if (_interval > 0 && _statsTime >= _interval) {
+        logStats();
+        _statsTime = 0;
+    }
+}
+
+/**
+ * Advances the load test by a fixed timestep until the given duration (in seconds) has passed
+ *
+ * This blocks until it is done (or the driver is stopped), so the bots run as fast as
+ * the machine allows rather than at the frame rate.
+ */
+void BotDriver::run(float duration, float timestep) {
+    for (float time = 0; time < duration && !_stopping; time += timestep) update(timestep);
+}
+
+/**
+ * Runs the load test on its own thread, until the given duration (in seconds) has passed or it is stopped
+ *
+ * The bots share nothing with the game but the log, so the thread needs no locking. Off the
+ * render thread, the frame time of each bot is its own, and not that of the game's frame.
+ */
+void BotDriver::start(float duration, float timestep) {
+    stop();
+    _stopping = false;
+    _thread = thread([=] { run(duration, timestep); });
+}
+
+/**
+ * Stops the load test thread, waiting for it to finish its current frame
+ */
+void BotDriver::stop() {
+    _stopping = true;
+    if (_thread.joinable()) _thread.join();
+}
+
+/**
+ * Logs the stats of every bot and of every loopback network, and resets the frame times
+ */
+void BotDriver::logStats() {
+    for (int ii = 0; ii < _rooms.size(); ii++) {
+        const LoopbackNetwork::Stats& stats = _rooms[ii].loopback->getStats();
+        CULog("Room %d (%s): %zu sent, %zu delivered, %zu lost, %zu superseded, %zu resent, %zu bytes",
+              ii, _rooms[ii].bots.front()->isPlaying() ? "playing" : "lobby", stats.sent,
+              stats.delivered, stats.lost, stats.superseded, stats.resent, stats.bytes);
+        for (auto& bot : _rooms[ii].bots) {
+            bot->logStats();
+            bot->resetStats();
+        }
+    }
+}
@@ -0,0 +1,98 @@
+//
+//  LCMPBotDriver.h
+//  Low Control Mall Patrol
+//
+//  This class runs a load test of headless bots. It spins up a number of rooms,
+//  each on its own loopback network with a hosting bot and the bots that join
+//  it, advances every network and bot each frame, and periodically logs the
+//  stats of every bot. The app runs one on its own thread when BOT_LOAD_TEST
+//  is defined, so that the frame times of the bots leave out the game's frame.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#ifndef __LCMP_BOT_DRIVER_H__
+#define __LCMP_BOT_DRIVER_H__
+#include <cugl/cugl.h>
+#include <atomic>
+#include <thread>
+#include "LCMPBotClient.h"
+
+class BotDriver {
+protected:
+    /** A room of bots sharing a loopback network */
+    struct Room {
+        /** The loopback network of the room */
+        std::shared_ptr<cugl::LoopbackNetwork> loopback;
+        /** The bots of the room, with the host first */
+        std::vector<std::shared_ptr<BotClient>> bots;
+    };
+
+//  MARK: - Properties
+
+    /** The rooms of the load test */
+    std::vector<Room> _rooms;
+    /** The time (in seconds) between stats logs */
+    float _interval;
+    /** The time (in seconds) since the stats were last logged */
+    float _statsTime;
+    /** The thread running the load test, if it was started */
+    std::thread _thread;
+    /** Whether the load test should stop before its duration has passed */
+    std::atomic<bool> _stopping;
+
+public:
+//  MARK: - Constructors
+
+    /**
+     * Constructs a Bot Driver without any rooms
+     */
+    BotDriver() : _interval(0), _statsTime(0), _stopping(false) {}
+
+    /**
+     * Destructs a Bot Driver
+     */
+    ~BotDriver() { dispose(); }
+
+    /**
+     * Disposes of all resources in this instance of Bot Driver
+     */
+    void dispose();
+
+    /**
+     * Initializes a Bot Driver with the given number of rooms, each playing the level with the given number of bots
+     */
+    bool init(const std::string& level, int rooms, int players, Uint32 seed, float interval,
+              const cugl::LoopbackNetwork::Conditions& conditions);
+
+//  MARK: - Methods
+
+    /**
+     * Advances every loopback network and bot by the timestep, logging the stats when they are due
+     */
+    void update(float timestep);
+
+    /**
+     * Advances the load test by a fixed timestep until the given duration (in seconds) has passed
+     */
+    void run(float duration, float timestep);
+
+    /**
+     * Runs the load test on its own thread, until the given duration (in seconds) has passed or it is stopped
+     */
+    void start(float duration, float timestep);
+
+    /**
+     * Stops the load test thread, waiting for it to finish its current frame
+     */
+    void stop();
+
+    /**
+     * Logs the stats of every bot and of every loopback network, and resets the frame times
+     */
+    void logStats();
+
+};
+
+#endif /* __LCMP_BOT_DRIVER_H__ */
@@ -0,0 +1,61 @@
+//
+//  LCMPClockSync.cpp
+//  Low Control Mall Patrol
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#include "LCMPClockSync.h"
+
+/** The weight of a new sample in the smoothed round trip time */
+#define RTT_SMOOTHING       0.125f
+/** The weight of a new sample in the smoothed offset */
+#define OFFSET_SMOOTHING    0.1f
+/** How much slower (as a factor) than usual a round trip may be and still update the offset */
+#define RTT_OUTLIER         2.0f
+/** How much slower (in seconds) than usual a round trip may always be, so fast links are not too strict */
+#define RTT_SLACK           0.02f
+
+using namespace cugl;
+
+//  MARK: - Constructors
+
+/**
+ * Initializes a Clock Sync for the given number of peers
+ */
+bool ClockSync::init(int peers) {
+    _peers.resize(peers);
+    clear();
+    return true;
+}
+
+//  MARK: - Methods
+
+/**
+ * Forgets the estimates of every peer
+ */
+void ClockSync::clear() {
+    std::fill(_peers.begin(), _peers.end(), Peer{0, 0, 0});
+}
+
+/**
+ * Adds a sample from a pong, given the local clock when the ping was sent and the pong received
+ */
+void ClockSync::sample(int peer, float sent, float remote, float received) {
+    if (peer >= _peers.size() || received < sent) return;
+    Peer& estimate = _peers[peer];
+    float rtt = received - sent;
+    float offset = remote - (sent + received) / 2;
+    if (estimate.samples == 0) {
+        estimate.offset = offset;
+        estimate.rtt = rtt;
+    } else {
+        // A slow round trip was probably queued one way only, which skews its offset
+        if (rtt <= estimate.rtt * RTT_OUTLIER + RTT_SLACK) {
+            estimate.offset += (offset - estimate.offset) * OFFSET_SMOOTHING;
+        }
+        estimate.rtt += (rtt - estimate.rtt) * RTT_SMOOTHING;
+    }
+    estimate.samples++;
+}
@@ -0,0 +1,82 @@
+//
+//  LCMPClockSync.h
+//  Low Control Mall Patrol
+//
+//  This class estimates the clock offset and round trip time to every peer
+//  from NTP-style ping/pong exchanges. A ping carries the clock of the sender,
+//  and the pong carries that clock back along with the clock of the peer that
+//  answered it. The peer clock is assumed to have been read halfway through the
+//  round trip. Samples are smoothed, and the offset ignores samples whose round
+//  trip was unusually slow, as queueing delay is rarely symmetric.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#ifndef __LCMP_CLOCK_SYNC_H__
+#define __LCMP_CLOCK_SYNC_H__
+#include <cugl/cugl.h>
+
+class ClockSync {
+public:
+//  MARK: - Structs
+
+    /** The clock estimate of one peer */
+    struct Peer {
+        /** The peer clock minus the local clock (in seconds) */
+        float offset;
+        /** The smoothed round trip time (in seconds) */
+        float rtt;
+        /** The number of samples taken */
+        int samples;
+    };
+
+protected:
+//  MARK: - Properties
+
+    /** The estimate of each peer (by player ID) */
+    std::vector<Peer> _peers;
+
+public:
+//  MARK: - Constructors
+
+    /**
+     * Constructs a Clock Sync
+     */
+    ClockSync() {}
+
+    /**
+     * Initializes a Clock Sync for the given number of peers
+     */
+    bool init(int peers);
+
+//  MARK: - Methods
+
+    /**
+     * Forgets the estimates of every peer
+     */
+    void clear();
+
+    /**
+     * Adds a sample from a pong, given the local clock when the ping was sent and the pong received
+     */
+    void sample(int peer, float sent, float remote, float received);
+
+    /**
+     * Returns true iff there is an estimate for the given peer
+     */
+    bool isSynced(int peer) const { return peer < _peers.size() && _peers[peer].samples > 0; }
+
+    /**
+     * Returns the peer clock minus the local clock (in seconds)
+     */
+    float getOffset(int peer) const { return _peers[peer].offset; }
+
+    /**
+     * Returns the smoothed round trip time to the peer (in seconds)
+     */
+    float getRTT(int peer) const { return _peers[peer].rtt; }
+
+};
+
+#endif /* __LCMP_CLOCK_SYNC_H__ */
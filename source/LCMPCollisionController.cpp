@@ -17,6 +17,19 @@ bool CollisionController::init(const std::shared_ptr<GameModel> game) {
     _game = game;
     didHitObstacle = false;
     didHitTrap = false;
+    
+    // Build the dispatch tables (lower kind first)
+    for (int i = 0; i < EntityTag::KindCount; i++) {
+        for (int j = 0; j < EntityTag::KindCount; j++) {
+            _beginHandlers[i][j] = nullptr;
+            _endHandlers[i][j] = nullptr;
+        }
+    }
+    _beginHandlers[EntityTag::Thief][EntityTag::Cop] = &CollisionController::beginThiefCop;
+    _beginHandlers[EntityTag::Thief][EntityTag::Trap] = &CollisionController::beginThiefTrap;
+    _beginHandlers[EntityTag::Cop][EntityTag::Trap] = &CollisionController::beginCopTrap;
+    _endHandlers[EntityTag::Thief][EntityTag::Trap] = &CollisionController::endThiefTrap;
+    _endHandlers[EntityTag::Cop][EntityTag::Trap] = &CollisionController::endCopTrap;
     return true;
 }
 
@@ -26,67 +39,18 @@ bool CollisionController::init(const std::shared_ptr<GameModel> game) {
  * Callback for when two obstacles in the world begin colliding
  */
 void CollisionController::beginContact(b2Contact* contact) {
-    b2Body* body1 = contact->GetFixtureA()->GetBody();
-    b2Body* body2 = contact->GetFixtureB()->GetBody();
-    b2Body* thiefBody = _game->getThief()->getRealBody();
+    EntityTag tag1 = EntityTag::decode(contact->GetFixtureA()->GetUserData().pointer);
+    EntityTag tag2 = EntityTag::decode(contact->GetFixtureB()->GetUserData().pointer);
+    if (tag1.kind > tag2.kind) std::swap(tag1, tag2);
     
-    if (body1 == thiefBody || body2 == thiefBody) {
+    // Any contact with a player is a hit, unless the player hit a trap
+    if (tag1.kind == EntityTag::Thief || tag1.kind == EntityTag::Cop ||
+        tag2.kind == EntityTag::Thief || tag2.kind == EntityTag::Cop) {
         didHitObstacle = true;
     }
-
-    // Check all of the cops
-    for (int i = 0; i < 4; i++) {
-        b2Body* copBody = _game->getCop(i)->getRealBody();
-        
-        if (copBody == body1 || copBody == body2) {
-            didHitObstacle = true;
-        }
-        
-        if ((thiefBody == body1 && copBody == body2) ||
-            (thiefBody == body2 && copBody == body1)) {
-            if (!_game->isGameOver()) {
-                _game->getCop(i)->setCaughtThief(true);
-            }
-        }
-    }
-
-    // Check all of the traps
-    for (int i = 0; i < _game->numberOfTraps(); i++) {
-        shared_ptr<TrapModel> trap = _game->getTrap(i);
-        b2Body* triggerBody = trap->getTriggerArea()->getRealBody();
-        b2Body* thiefEffectBody = trap->getThiefEffectArea()->getRealBody();
-        b2Body* copEffectBody = trap->getCopEffectArea()->getRealBody();
-        b2Body* deactivationBody = trap->getDeactivationArea()->getRealBody();
-
-        if (trap->activated) {
-            if ((thiefBody == body1 && thiefEffectBody == body2) ||
-                (thiefBody == body2 && thiefEffectBody == body1)) {
-                _game->getThief()->act(trap->getTrapID(), trap->getThiefEffect());
-                didHitTrap = true;
-            }
-
-            for (int i = 0; i < 4; i++) {
-                b2Body* copBody = _game->getCop(i)->getRealBody();
-                if ((copBody == body1 && copEffectBody == body2) ||
-                    (copBody == body2 && copEffectBody == body1)) {
-                    _game->getCop(i)->act(trap->getTrapID(), trap->getCopEffect());
-                    didHitTrap = true;
-                }
-
-                if ((copBody == body1 && deactivationBody == body2) ||
-                    (copBody == body2 && deactivationBody == body1)) {
-                    _game->getCop(i)->trapDeactivationFlag = trap->getTrapID();
-                }
-            }
-        }
-        else {
-            if ((thiefBody == body1 && triggerBody == body2) ||
-                (thiefBody == body2 && triggerBody == body1)) {
-                _game->getThief()->trapActivationFlag = trap->getTrapID();
-            }
-
-        }
-    }
+    
+    ContactHandler handler = _beginHandlers[tag1.kind][tag2.kind];
+    if (handler != nullptr) (this->*handler)(tag1, tag2);
     
     didHitObstacle = didHitObstacle && !didHitTrap;
 }
@@ -95,37 +59,12 @@ void CollisionController::beginContact(b2Contact* contact) {
  * Callback for when two obstacles in the world end colliding
  */
 void CollisionController::endContact(b2Contact* contact) {
-    b2Body* body1 = contact->GetFixtureA()->GetBody();
-    b2Body* body2 = contact->GetFixtureB()->GetBody();
-    b2Body* thiefBody = _game->getThief()->getRealBody();
-
-    for (int i = 0; i < _game->numberOfTraps(); i++) {
-        shared_ptr<TrapModel> trap = _game->getTrap(i);
-        b2Body* triggerBody = trap->getTriggerArea()->getRealBody();
-        b2Body* thiefEffectBody = trap->getThiefEffectArea()->getRealBody();
-        b2Body* copEffectBody = trap->getCopEffectArea()->getRealBody();
-
-        if (trap->activated) {
-            didHitTrap = false;
-            if ((thiefBody == body1 && thiefEffectBody == body2) ||
-                (thiefBody == body2 && thiefEffectBody == body1)) {
-                _game->getThief()->unact(trap->getTrapID(), trap->getThiefEffect());
-            }
-            for (int i = 0; i < 4; i++) {
-                b2Body* copBody = _game->getCop(i)->getRealBody();
-                if ((copBody == body1 && copEffectBody == body2) ||
-                    (copBody == body2 && copEffectBody == body1)) {
-                    _game->getCop(i)->unact( trap->getTrapID(), trap->getCopEffect());
-                }
-            }
-        }
-        else {
-            if ((thiefBody == body1 && triggerBody == body2) ||
-                (thiefBody == body2 && triggerBody == body1)) {
-                _game->getThief()->trapActivationFlag = -1;
-            }
-        }
-    }
+    EntityTag tag1 = EntityTag::decode(contact->GetFixtureA()->GetUserData().pointer);
+    EntityTag tag2 = EntityTag::decode(contact->GetFixtureB()->GetUserData().pointer);
+    if (tag1.kind > tag2.kind) std::swap(tag1, tag2);
+    
+    ContactHandler handler = _endHandlers[tag1.kind][tag2.kind];
+    if (handler != nullptr) (this->*handler)(tag1, tag2);
 }
 
 /**
@@ -137,3 +76,69 @@ bool CollisionController::shouldCollide(b2Fixture* f1, b2Fixture* f2) {
 
     return filterA.maskBits & filterB.maskBits;
 }
+
+//  MARK: - Handlers
+
+/**
+ * Handles the thief beginning to touch a cop
+ */
+void CollisionController::beginThiefCop(const EntityTag& thief, const EntityTag& cop) {
+    if (!_game->isGameOver()) {
+        _game->getCop(cop.owner)->setCaughtThief(true);
+    }
+}
+
+/**
+ * Handles the thief beginning to touch a trap area
+ */
+void CollisionController::beginThiefTrap(const EntityTag& thief, const EntityTag& trap) {
+    shared_ptr<TrapModel> model = _game->getTrap(trap.trap);
+    if (model->activated && trap.role == EntityTag::ThiefEffect) {
+        _game->getThief()->act(model->getTrapID(), model->getThiefEffect());
+        didHitTrap = true;
+    } else if (!model->activated && trap.role == EntityTag::Trigger) {
+        _game->getThief()->trapActivationFlag = model->getTrapID();
+    }
+}
+
+/**
+ * Handles a cop beginning to touch a trap area
+ */
+void CollisionController::beginCopTrap(const EntityTag& cop, const EntityTag& trap) {
+    shared_ptr<TrapModel> model = _game->getTrap(trap.trap);
+    if (!model->activated) return;
+    if (trap.role == EntityTag::CopEffect) {
+        _game->getCop(cop.owner)->act(model->getTrapID(), model->getCopEffect());
+        didHitTrap = true;
+    } else if (trap.role == EntityTag::Deactivation) {
+        _game->getCop(cop.owner)->trapDeactivationFlag = model->getTrapID();
+    }
+}
+
+/**
+ * Handles the thief no longer touching a trap area
+ */
+void CollisionController::endThiefTrap(const EntityTag& thief, const EntityTag& trap) {
+    shared_ptr<TrapModel> model = _game->getTrap(trap.trap);
+    if (model->activated) {
+        didHitTrap = false;
+        if (trap.role == EntityTag::ThiefEffect) {
+            _game->getThief()->unact(model->getTrapID(), model->getThiefEffect());
+        }
+    } else if (trap.role == EntityTag::Trigger) {
+        _game->getThief()->trapActivationFlag = -1;
+    }
+}
+
+/**
+ * Handles a cop no longer touching a trap area
+ */
+void CollisionController::endCopTrap(const EntityTag& cop, const EntityTag& trap) {
+    shared_ptr<TrapModel> model = _game->getTrap(trap.trap);
+    if (model->activated) {
+        didHitTrap = false;
+        if (trap.role == EntityTag::CopEffect) {
+            _game->getCop(cop.owner)->unact(model->getTrapID(), model->getCopEffect());
+        }
+    }
+}
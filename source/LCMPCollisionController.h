@@ -12,15 +12,24 @@
 #include <box2d/b2_contact.h>
 #include <box2d/b2_collision.h>
 #include "LCMPGameModel.h"
+#include "LCMPEntityTag.h"
 
 class CollisionController {
 protected:
+    /** A contact handler for a pair of tags, ordered by kind */
+    typedef void (CollisionController::*ContactHandler)(const EntityTag& tag1, const EntityTag& tag2);
+    
 //  MARK: - Properties
     
     // Models
     /** A reference to the model to represent all models within the game */
     std::shared_ptr<GameModel> _game;
     
+    /** The begin contact handlers, indexed by the kinds of the two tags (lower kind first) */
+    ContactHandler _beginHandlers[EntityTag::KindCount][EntityTag::KindCount];
+    /** The end contact handlers, indexed by the kinds of the two tags (lower kind first) */
+    ContactHandler _endHandlers[EntityTag::KindCount][EntityTag::KindCount];
+    
 public:
     bool didHitObstacle;
     bool didHitTrap;
@@ -65,6 +74,34 @@ public:
      */
     bool shouldCollide(b2Fixture* f1, b2Fixture* f2);
     
+private:
+//  MARK: - Handlers
+    
+    /**
+     * Handles the thief beginning to touch a cop
+     */
+    void beginThiefCop(const EntityTag& thief, const EntityTag& cop);
+    
+    /**
+     * Handles the thief beginning to touch a trap area
+     */
+    void beginThiefTrap(const EntityTag& thief, const EntityTag& trap);
+    
+    /**
+     * Handles a cop beginning to touch a trap area
+     */
+    void beginCopTrap(const EntityTag& cop, const EntityTag& trap);
+    
+    /**
+     * Handles the thief no longer touching a trap area
+     */
+    void endThiefTrap(const EntityTag& thief, const EntityTag& trap);
+    
+    /**
+     * Handles a cop no longer touching a trap area
+     */
+    void endCopTrap(const EntityTag& cop, const EntityTag& trap);
+    
 };
 
 #endif /* __LCMP_COLLISION_CONTROLLER_H__ */
@@ -103,8 +103,16 @@ enum JsonConstants :int {
 
 /** The source for our level file */
 #define LEVEL_ONE_FILE      "maps/example6.json"
-/** Assets for our level */
+/** Assets for our level (the backdrop chunks, streamed in during the game) */
 #define WALL_ASSETS_FILE    "maps/Map3WallAssets.json"
+/** The key of a backdrop chunk, by row and column (starting at 1) */
+#define BACKDROP_CHUNK_KEY  "row-%d-column-%d"
+/** The size of a backdrop chunk texture in pixels */
+#define BACKDROP_CHUNK_SIZE 2000
+/** The number of chunks past the camera view to load ahead of time */
+#define BACKDROP_PREFETCH   1
+/** The number of chunks past the prefetch ring before a chunk is evicted */
+#define BACKDROP_HYSTERESIS 1
 /** The key for our loaded level */
 #define LEVEL_ONE_KEY       "example6"
 #define LEVEL_DONUT_KEY		"maps/donut_room.json"
@@ -112,13 +120,86 @@ enum JsonConstants :int {
 
 /** Tileset for props */
 #define PROPS_FILE          "maps/PropsAndTraps.tsj"
+/** The name of the props tileset as referenced by the maps */
+#define PROPS_TILESET       "PropsAndTraps.tsj"
+
+/** The extension of compiled levels (replaces .json in the level file) */
+#define LEVEL_EXTENSION     ".lvl"
+/** The magic number at the start of every compiled level ("LCMP") */
+#define LEVEL_MAGIC         0x4C434D50
+/** The version of the compiled level format (bump whenever it changes) */
+#define LEVEL_VERSION       3
+/**
+ * Uncomment to compile every level into the save directory on startup.
+ * Copy the resulting files into assets/maps to ship them with the game. A compiled
+ * level is ignored once its Tiled map or the props tileset changes, so recompile them.
+ */
+//#define COMPILE_LEVELS
+/**
+ * Uncomment to record the contacts of every round, and to log how long the old pointer
+ * dispatch and the tag dispatch take to replay them when the next round starts.
+ */
+//#define BENCHMARK_CONTACTS
+/** The number of times a recorded contact stream is replayed */
+#define BENCHMARK_REPEATS   1000
+/**
+ * Uncomment to run rooms of headless bots on loopback networks alongside the game (on a
+ * thread of their own), logging the stats of every bot every BOT_STATS_INTERVAL seconds.
+ */
+//#define BOT_LOAD_TEST
+/** The number of rooms in the bot load test */
+#define BOT_ROOMS           4
+/** The number of bots (including the host) in each room, at most 5 */
+#define BOT_PLAYERS         5
+/** The simulated time (in seconds) the bot load test runs for */
+#define BOT_DURATION        600.0f
+/** The time (in seconds) between bot stats logs */
+#define BOT_STATS_INTERVAL  5.0f
+/** The one way latency (in seconds) of the bot loopback networks */
+#define BOT_LATENCY         0.05f
+/** The jitter (in seconds) of the bot loopback networks */
+#define BOT_JITTER          0.01f
+/** The chance that a bot packet is lost */
+#define BOT_LOSS            0.02f
+/** The chance that a bot packet is overtaken by later ones */
+#define BOT_REORDER         0.01f
+/**
+ * Uncomment to have the hosting bot of each room replicate its physics world into a copy
+ * of the level, and log how far the copy is off with the stats of the bot.
+ */
+//#define CHECK_REPLICATION
+/** The number of replication messages from one keyframe to the next */
+#define REPLICATION_KEYFRAMES       30
+/** The chance that a replication message is lost */
+#define REPLICATION_LOSS            0.05f
+/** The largest replicated speed (that of a tackling cop) */
+#define REPLICATION_SPEED           (COP_MAX_SPEED_DEFAULT * TACKLE_MOVEMENT_MULT)
+/** The number of bits of each replicated position component */
+#define REPLICATION_POSITION_BITS   16
+/** The number of bits of a replicated angle */
+#define REPLICATION_ANGLE_BITS      10
+/** The number of bits of each replicated velocity component */
+#define REPLICATION_VELOCITY_BITS   12
 
 //  MARK: - Physics Constants
 
 #define POLYFACTORY_TOLERANCE   0.1
 
+/** Width of the game world in Box2d units */
+#define WORLD_WIDTH             32.0f
+/** Height of the game world in Box2d units */
+#define WORLD_HEIGHT            18.0f
+/** The length (in seconds) of one simulation step */
+#define SIMULATION_STEP         (1/60.0f)
+/** The most simulation steps in one frame, so that a slow frame cannot snowball */
+#define MAX_SUBSTEPS            5
+
 /** size of grid squares for collision optimization */
 #define GRID_SIZE               5
+/** number of grid squares an obstacle reaches past its bounds */
+#define GRID_PADDING            1
+/** size of the regions the walls and props are merged into (a single grid square) */
+#define MERGE_REGION_SIZE       GRID_SIZE
 
 /** Music constants */
 #define THIEF_COLLISION_SFX     "fuck"
@@ -170,6 +251,8 @@ enum JsonConstants :int {
 
 /** This is how long the game will be */
 #define GAME_LENGTH     109
+/** The amount of time that the game waits before reseting */
+#define RESET_TIME      3
 
 /** This is the size of the active portion of the screen */
 #define SCENE_WIDTH     1024
@@ -0,0 +1,213 @@
+//
+//  LCMPContactBenchmark.cpp
+//  Low Control Mall Patrol
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#include "LCMPContactBenchmark.h"
+
+using namespace cugl;
+using namespace std;
+
+/** The handlers an event can resolve to */
+enum Handler {
+    CAUGHT_THIEF = 1,
+    THIEF_ACT,
+    THIEF_TRIGGER,
+    COP_ACT,
+    COP_DEACTIVATE,
+    THIEF_UNACT,
+    THIEF_UNTRIGGER,
+    COP_UNACT
+};
+
+/**
+ * Returns a code for a resolved handler, spread out so that a sum of codes is a fair checksum
+ */
+static Uint64 resolved(Handler handler, int cop, int trap) {
+    Uint64 code = (Uint64)handler | ((Uint64)(cop + 1) << 4) | ((Uint64)trap << 8);
+    return code * 0x9E3779B97F4A7C15ULL;
+}
+
+//  MARK: - Constructors
+
+/**
+ * Constructs a Contact Benchmark with an empty stream
+ *
+ * The resolver tables mirror the handler tables of the Collision Controller.
+ */
+ContactBenchmark::ContactBenchmark() {
+    for (int i = 0; i < EntityTag::KindCount; i++) {
+        for (int j = 0; j < EntityTag::KindCount; j++) {
+            _beginResolvers[i][j] = nullptr;
+            _endResolvers[i][j] = nullptr;
+        }
+    }
+    _beginResolvers[EntityTag::Thief][EntityTag::Cop] = &ContactBenchmark::beginThiefCop;
+    _beginResolvers[EntityTag::Thief][EntityTag::Trap] = &ContactBenchmark::beginThiefTrap;
+    _beginResolvers[EntityTag::Cop][EntityTag::Trap] = &ContactBenchmark::beginCopTrap;
+    _endResolvers[EntityTag::Thief][EntityTag::Trap] = &ContactBenchmark::endThiefTrap;
+    _endResolvers[EntityTag::Cop][EntityTag::Trap] = &ContactBenchmark::endCopTrap;
+}
+
+//  MARK: - Methods
+
+/**
+ * Records a contact event
+ */
+void ContactBenchmark::record(b2Contact* contact, bool begin) {
+    b2Fixture* fixture1 = contact->GetFixtureA();
+    b2Fixture* fixture2 = contact->GetFixtureB();
+    _events.push_back({ fixture1->GetBody(), fixture2->GetBody(),
+                        fixture1->GetUserData().pointer, fixture2->GetUserData().pointer, begin });
+}
+
+/**
+ * Replays the recorded stream the given number of times through both dispatchers, and logs the times
+ *
+ * The game must be the one the stream was recorded in, as the old dispatcher compares its bodies.
+ * Returns true iff both dispatchers resolved the same handlers.
+ */
+bool ContactBenchmark::run(const shared_ptr<GameModel>& game, int repeats) {
+    if (_events.empty() || repeats <= 0) return true;
+
+    Uint64 pointers = 0;
+    Timestamp start;
+    for (int ii = 0; ii < repeats; ii++) {
+        for (const Event& event : _events) pointers += dispatchPointers(game, event);
+    }
+    Timestamp middle;
+    Uint64 tags = 0;
+    for (int ii = 0; ii < repeats; ii++) {
+        for (const Event& event : _events) tags += dispatchTags(game, event);
+    }
+    Timestamp end;
+
+    double count = (double)_events.size() * repeats;
+    double pointerTime = Timestamp::ellapsedMicros(start, middle);
+    double tagTime = Timestamp::ellapsedMicros(middle, end);
+    CULog("Contact replay of %zu events x %d (%d cops, %d traps): pointers %.3fms (%.1fns/event), "
+          "tags %.3fms (%.1fns/event), %s",
+          _events.size(), repeats, game->numberOfCops(), game->numberOfTraps(),
+          pointerTime / 1000, pointerTime * 1000 / count, tagTime / 1000, tagTime * 1000 / count,
+          pointers == tags ? "same handlers" : "HANDLERS DIFFER");
+    return pointers == tags;
+}
+
+//  MARK: - Dispatchers
+
+/**
+ * Resolves an event by comparing the body pointers, as the old controller did
+ *
+ * This keeps the loops of the old controller: every cop for a catch, then every area of every
+ * trap (and every cop again for each trap).
+ */
+Uint64 ContactBenchmark::dispatchPointers(const shared_ptr<GameModel>& game, const Event& event) {
+    b2Body* body1 = event.body1;
+    b2Body* body2 = event.body2;
+    b2Body* thiefBody = game->getThief()->getRealBody();
+    Uint64 result = 0;
+
+    if (event.begin) {
+        for (int i = 0; i < game->numberOfCops(); i++) {
+            b2Body* copBody = game->getCop(i)->getRealBody();
+            if ((thiefBody == body1 && copBody == body2) ||
+                (thiefBody == body2 && copBody == body1)) {
+                result += resolved(CAUGHT_THIEF, i, 0);
+            }
+        }
+    }
+
+    for (int t = 0; t < game->numberOfTraps(); t++) {
+        shared_ptr<TrapModel> trap = game->getTrap(t);
+        b2Body* triggerBody = trap->getTriggerArea()->getRealBody();
+        b2Body* thiefEffectBody = trap->getThiefEffectArea()->getRealBody();
+        b2Body* copEffectBody = trap->getCopEffectArea()->getRealBody();
+        b2Body* deactivationBody = trap->getDeactivationArea()->getRealBody();
+
+        if (trap->activated) {
+            if ((thiefBody == body1 && thiefEffectBody == body2) ||
+                (thiefBody == body2 && thiefEffectBody == body1)) {
+                result += resolved(event.begin ? THIEF_ACT : THIEF_UNACT, -1, t);
+            }
+            for (int i = 0; i < game->numberOfCops(); i++) {
+                b2Body* copBody = game->getCop(i)->getRealBody();
+                if ((copBody == body1 && copEffectBody == body2) ||
+                    (copBody == body2 && copEffectBody == body1)) {
+                    result += resolved(event.begin ? COP_ACT : COP_UNACT, i, t);
+                }
+                if (event.begin && ((copBody == body1 && deactivationBody == body2) ||
+                                    (copBody == body2 && deactivationBody == body1))) {
+                    result += resolved(COP_DEACTIVATE, i, t);
+                }
+            }
+        } else if ((thiefBody == body1 && triggerBody == body2) ||
+                   (thiefBody == body2 && triggerBody == body1)) {
+            result += resolved(event.begin ? THIEF_TRIGGER : THIEF_UNTRIGGER, -1, t);
+        }
+    }
+    return result;
+}
+
+/**
+ * Resolves an event by looking up the tag pair, as the controller does
+ */
+Uint64 ContactBenchmark::dispatchTags(const shared_ptr<GameModel>& game, const Event& event) {
+    EntityTag tag1 = EntityTag::decode(event.data1);
+    EntityTag tag2 = EntityTag::decode(event.data2);
+    if (tag1.kind > tag2.kind) std::swap(tag1, tag2);
+
+    Resolver resolver = event.begin ? _beginResolvers[tag1.kind][tag2.kind] : _endResolvers[tag1.kind][tag2.kind];
+    return resolver == nullptr ? 0 : (this->*resolver)(game, tag1, tag2);
+}
+
+//  MARK: - Resolvers
+
+/**
+ * Resolves the thief beginning to touch a cop
+ */
+Uint64 ContactBenchmark::beginThiefCop(const shared_ptr<GameModel>& game, const EntityTag& thief, const EntityTag& cop) {
+    return resolved(CAUGHT_THIEF, cop.owner, 0);
+}
+
+/**
+ * Resolves the thief beginning to touch a trap area
+ */
+Uint64 ContactBenchmark::beginThiefTrap(const shared_ptr<GameModel>& game, const EntityTag& thief, const EntityTag& trap) {
+    shared_ptr<TrapModel> model = game->getTrap(trap.trap);
+    if (model->activated && trap.role == EntityTag::ThiefEffect) return resolved(THIEF_ACT, -1, trap.trap);
+    if (!model->activated && trap.role == EntityTag::Trigger) return resolved(THIEF_TRIGGER, -1, trap.trap);
+    return 0;
+}
+
+/**
+ * Resolves a cop beginning to touch a trap area
+ */
+Uint64 ContactBenchmark::beginCopTrap(const shared_ptr<GameModel>& game, const EntityTag& cop, const EntityTag& trap) {
+    shared_ptr<TrapModel> model = game->getTrap(trap.trap);
+    if (!model->activated) return 0;
+    if (trap.role == EntityTag::CopEffect) return resolved(COP_ACT, cop.owner, trap.trap);
+    if (trap.role == EntityTag::Deactivation) return resolved(COP_DEACTIVATE, cop.owner, trap.trap);
+    return 0;
+}
+
+/**
+ * Resolves the thief no longer touching a trap area
+ */
+Uint64 ContactBenchmark::endThiefTrap(const shared_ptr<GameModel>& game, const EntityTag& thief, const EntityTag& trap) {
+    shared_ptr<TrapModel> model = game->getTrap(trap.trap);
+    if (model->activated && trap.role == EntityTag::ThiefEffect) return resolved(THIEF_UNACT, -1, trap.trap);
+    if (!model->activated && trap.role == EntityTag::Trigger) return resolved(THIEF_UNTRIGGER, -1, trap.trap);
+    return 0;
+}
+
+/**
+ * Resolves a cop no longer touching a trap area
+ */
+Uint64 ContactBenchmark::endCopTrap(const shared_ptr<GameModel>& game, const EntityTag& cop, const EntityTag& trap) {
+    shared_ptr<TrapModel> model = game->getTrap(trap.trap);
+    if (model->activated && trap.role == EntityTag::CopEffect) return resolved(COP_UNACT, cop.owner, trap.trap);
+    return 0;
+}
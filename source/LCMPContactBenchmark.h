@@ -0,0 +1,130 @@
+//
+//  LCMPContactBenchmark.h
+//  Low Control Mall Patrol
+//
+//  This class measures the cost of contact dispatch. It records the contact
+//  stream of a real round (the two bodies and fixture tags of every begin and
+//  end event), and then replays it against two dispatchers: the old one, which
+//  compares the body pointers against the thief, every cop and every area of
+//  every trap, and the current one, which looks up a handler by tag pair.
+//
+//  Only the dispatch is replayed. Each event resolves to the handler (and the
+//  cop and trap) it would run, but nothing is applied, so the benchmark can run
+//  between rounds of a live game. Both dispatchers must resolve the same
+//  handlers, which the benchmark checks as it reports the times.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#ifndef __LCMP_CONTACT_BENCHMARK_H__
+#define __LCMP_CONTACT_BENCHMARK_H__
+#include <box2d/b2_contact.h>
+#include "LCMPGameModel.h"
+#include "LCMPEntityTag.h"
+
+class ContactBenchmark {
+protected:
+    /** A recorded contact event */
+    struct Event {
+        /** The body of the first fixture */
+        b2Body* body1;
+        /** The body of the second fixture */
+        b2Body* body2;
+        /** The user data (entity tag) of the first fixture */
+        uintptr_t data1;
+        /** The user data (entity tag) of the second fixture */
+        uintptr_t data2;
+        /** Whether the contact began (rather than ended) */
+        bool begin;
+    };
+
+    /** A resolver for a pair of tags, ordered by kind */
+    typedef Uint64 (ContactBenchmark::*Resolver)(const std::shared_ptr<GameModel>& game,
+                                                 const EntityTag& tag1, const EntityTag& tag2);
+
+//  MARK: - Properties
+
+    /** The recorded contact stream */
+    std::vector<Event> _events;
+    /** The begin resolvers, indexed by the kinds of the two tags (lower kind first) */
+    Resolver _beginResolvers[EntityTag::KindCount][EntityTag::KindCount];
+    /** The end resolvers, indexed by the kinds of the two tags (lower kind first) */
+    Resolver _endResolvers[EntityTag::KindCount][EntityTag::KindCount];
+
+public:
+//  MARK: - Constructors
+
+    /**
+     * Constructs a Contact Benchmark with an empty stream
+     */
+    ContactBenchmark();
+
+//  MARK: - Methods
+
+    /**
+     * Records a contact event
+     */
+    void record(b2Contact* contact, bool begin);
+
+    /**
+     * Returns the number of recorded contact events
+     */
+    size_t size() const { return _events.size(); }
+
+    /**
+     * Forgets the recorded contact stream
+     */
+    void clear() { _events.clear(); }
+
+    /**
+     * Replays the recorded stream the given number of times through both dispatchers, and logs the times
+     *
+     * The game must be the one the stream was recorded in, as the old dispatcher compares its bodies.
+     * Returns true iff both dispatchers resolved the same handlers.
+     */
+    bool run(const std::shared_ptr<GameModel>& game, int repeats);
+
+private:
+//  MARK: - Dispatchers
+
+    /**
+     * Resolves an event by comparing the body pointers, as the old controller did
+     */
+    Uint64 dispatchPointers(const std::shared_ptr<GameModel>& game, const Event& event);
+
+    /**
+     * Resolves an event by looking up the tag pair, as the controller does
+     */
+    Uint64 dispatchTags(const std::shared_ptr<GameModel>& game, const Event& event);
+
+//  MARK: - Resolvers
+
+    /**
+     * Resolves the thief beginning to touch a cop
+     */
+    Uint64 beginThiefCop(const std::shared_ptr<GameModel>& game, const EntityTag& thief, const EntityTag& cop);
+
+    /**
+     * Resolves the thief beginning to touch a trap area
+     */
+    Uint64 beginThiefTrap(const std::shared_ptr<GameModel>& game, const EntityTag& thief, const EntityTag& trap);
+
+    /**
+     * Resolves a cop beginning to touch a trap area
+     */
+    Uint64 beginCopTrap(const std::shared_ptr<GameModel>& game, const EntityTag& cop, const EntityTag& trap);
+
+    /**
+     * Resolves the thief no longer touching a trap area
+     */
+    Uint64 endThiefTrap(const std::shared_ptr<GameModel>& game, const EntityTag& thief, const EntityTag& trap);
+
+    /**
+     * Resolves a cop no longer touching a trap area
+     */
+    Uint64 endCopTrap(const std::shared_ptr<GameModel>& game, const EntityTag& cop, const EntityTag& trap);
+
+};
+
+#endif /* __LCMP_CONTACT_BENCHMARK_H__ */
@@ -59,37 +59,40 @@ bool CopModel::init(int copID, float scale,
     // Call the parent's initializer
     PlayerModel::init(copID, Vec2::ZERO, size, scale, node, actions);
     
-    // Set up the textures for all tackle directions
-    _tackleDownTexture = assets->get<Texture>(COP_JUMP_DOWN);
-    _tackleUpTexture = assets->get<Texture>(COP_JUMP_UP);
-    _tackleLeftTexture = assets->get<Texture>(COP_JUMP_LEFT);
-    _tackleRightTexture = assets->get<Texture>(COP_JUMP_RIGHT);
-    _landDownTexture = assets->get<Texture>(COP_LAND_DOWN);
-    _landUpTexture = assets->get<Texture>(COP_LAND_UP);
-    _landLeftTexture = assets->get<Texture>(COP_LAND_LEFT);
-    _landRightTexture = assets->get<Texture>(COP_LAND_RIGHT);
+    // A headless cop (as for a bot client) has no textures or sprites
+    if (assets != nullptr) {
+        // Set up the textures for all tackle directions
+        _tackleDownTexture = assets->get<Texture>(COP_JUMP_DOWN);
+        _tackleUpTexture = assets->get<Texture>(COP_JUMP_UP);
+        _tackleLeftTexture = assets->get<Texture>(COP_JUMP_LEFT);
+        _tackleRightTexture = assets->get<Texture>(COP_JUMP_RIGHT);
+        _landDownTexture = assets->get<Texture>(COP_LAND_DOWN);
+        _landUpTexture = assets->get<Texture>(COP_LAND_UP);
+        _landLeftTexture = assets->get<Texture>(COP_LAND_LEFT);
+        _landRightTexture = assets->get<Texture>(COP_LAND_RIGHT);
     
-    // Set up the textures for all directions
-    bool female;
-    skinKey == "COP_RUN_RIGHT_F" ? female = true : female = false;
+        // Set up the textures for all directions
+        bool female;
+        skinKey == "COP_RUN_RIGHT_F" ? female = true : female = false;
     
-    !female ? _spriteSheets.push_back(assets->get<Texture>(COP_RUN_RIGHT)) : _spriteSheets.push_back(assets->get<Texture>(COP_RUN_RIGHT_F));
-    _spriteSheets.push_back(assets->get<Texture>(COP_RUN_BACK));
-    !female ? _spriteSheets.push_back(assets->get<Texture>(COP_RUN_LEFT)) : _spriteSheets.push_back(assets->get<Texture>(COP_RUN_LEFT_F));
-    _spriteSheets.push_back(assets->get<Texture>(COP_RUN_FRONT));
-    !female ? _spriteSheets.push_back(assets->get<Texture>(COP_IDLE_RIGHT)) : _spriteSheets.push_back(assets->get<Texture>(COP_IDLE_RIGHT_F));
-    !female ? _spriteSheets.push_back(assets->get<Texture>(COP_IDLE_LEFT)) : _spriteSheets.push_back(assets->get<Texture>(COP_IDLE_LEFT_F));
+        !female ? _spriteSheets.push_back(assets->get<Texture>(COP_RUN_RIGHT)) : _spriteSheets.push_back(assets->get<Texture>(COP_RUN_RIGHT_F));
+        _spriteSheets.push_back(assets->get<Texture>(COP_RUN_BACK));
+        !female ? _spriteSheets.push_back(assets->get<Texture>(COP_RUN_LEFT)) : _spriteSheets.push_back(assets->get<Texture>(COP_RUN_LEFT_F));
+        _spriteSheets.push_back(assets->get<Texture>(COP_RUN_FRONT));
+        !female ? _spriteSheets.push_back(assets->get<Texture>(COP_IDLE_RIGHT)) : _spriteSheets.push_back(assets->get<Texture>(COP_IDLE_RIGHT_F));
+        !female ? _spriteSheets.push_back(assets->get<Texture>(COP_IDLE_LEFT)) : _spriteSheets.push_back(assets->get<Texture>(COP_IDLE_LEFT_F));
         
-    // Initialize the first texture. Note: width is in screen coordinates
-    float width = size.width * scale * 1.5f;
-    setSpriteNodes(width);
+        // Initialize the first texture. Note: width is in screen coordinates
+        float width = size.width * scale * 1.5f;
+        setSpriteNodes(width);
     
-    _character = scene2::PolygonNode::allocWithTexture(_tackleDownTexture);
-    _character->setScale(_spriteNodes[0]->getWidth() / _tackleDownTexture->getWidth());
-    _character->setAnchor(Vec2::ANCHOR_CENTER);
-    _character->setPosition(Vec2(0, width / 2.5f));
-    _character->setVisible(false);
-    _node->addChild(_character);
+        _character = scene2::PolygonNode::allocWithTexture(_tackleDownTexture);
+        _character->setScale(_spriteNodes[0]->getWidth() / _tackleDownTexture->getWidth());
+        _character->setAnchor(Vec2::ANCHOR_CENTER);
+        _character->setPosition(Vec2(0, width / 2.5f));
+        _character->setVisible(false);
+        _node->addChild(_character);
+    }
     // TODO: Get rid of the magic numbers in the lines above.
     
     // Initialize tackle properties
@@ -134,14 +137,21 @@ void CopModel::attemptTackle(Vec2 thiefPosition, Vec2 tackle) {
     _tackleTime = 0;
     _tacklePosition = getPosition();
     _tackleDirection = tackle;
-    
+    _tackleSuccessful = judgeTackle(_tacklePosition, tackle, thiefPosition);
+}
+
+/**
+ * Returns whether a tackle from the given position in the given direction hits the thief
+ *
+ * This is static so that the host can judge a tackle against where the thief was in the past.
+ */
+bool CopModel::judgeTackle(Vec2 tacklePosition, Vec2 tackle, Vec2 thiefPosition) {
     // Do some math between this cop, the the thief, and the tackle
-    Vec2 dist = thiefPosition - _tacklePosition;
+    Vec2 dist = thiefPosition - tacklePosition;
     float angle = abs(abs(tackle.getAngle()) - abs(dist.getAngle()));
     
     // See if the tackle was successful
-    _tackleSuccessful =
-        angle <= TACKLE_ANGLE_MAX_ERR
+    return angle <= TACKLE_ANGLE_MAX_ERR
         && dist.lengthSquared() < TACKLE_HIT_RADIUS * TACKLE_HIT_RADIUS;
 }
 
@@ -180,6 +190,7 @@ void CopModel::applyNetwork(cugl::Vec2 position, cugl::Vec2 velocity,
  * Performs a film strip action
  */
 void CopModel::playAnimation() {
+    if (_character == nullptr) return;
     if (_tackling) playTackle();
     else {
         PlayerModel::playAnimation();
@@ -187,6 +198,23 @@ void CopModel::playAnimation() {
     }
 }
 
+/**
+ * Clears the tackle state so the cop can start a new round
+ */
+void CopModel::reset() {
+    PlayerModel::reset();
+    _tackleDirection = Vec2::ZERO;
+    _tacklePosition = Vec2::ZERO;
+    _tackleTime = 0;
+    _tackling = false;
+    _caughtThief = false;
+    _tackleSuccessful = false;
+    didTackle = false;
+    didLand = false;
+    trapDeactivationFlag = -1;
+    if (_character != nullptr) _character->setVisible(false);
+}
+
 //  MARK: - Helpers
 
 /**
@@ -125,6 +125,11 @@ public:
      */
     void attemptTackle(cugl::Vec2 thiefPosition, cugl::Vec2 tackle);
     
+    /**
+     * Returns whether a tackle from the given position in the given direction hits the thief
+     */
+    static bool judgeTackle(cugl::Vec2 tacklePosition, cugl::Vec2 tackle, cugl::Vec2 thiefPosition);
+    
     /**
      * Applies physics to cop when tackling
      */
@@ -146,6 +151,11 @@ public:
      */
     void playAnimation();
     
+    /**
+     * Clears the tackle state so the cop can start a new round
+     */
+    void reset() override;
+    
 private:
 //  MARK: - Helpers
     
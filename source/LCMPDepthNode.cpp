@@ -0,0 +1,118 @@
+//
+//  LCMPDepthNode.cpp
+//  Low Control Mall Patrol
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#include "LCMPDepthNode.h"
+
+using namespace cugl;
+
+//  MARK: - Constructors
+
+/**
+ * Disposes of all resources in this instance of Depth Node
+ */
+void DepthNode::dispose() {
+    _sequence.clear();
+    _dynamic.clear();
+    _nextSequence = 0;
+    _moves = 0;
+    SceneNode::dispose();
+}
+
+//  MARK: - Children
+
+/**
+ * Adds a child to this node, in sorted position
+ */
+void DepthNode::addChild(const std::shared_ptr<scene2::SceneNode>& child) {
+    _sequence[child.get()] = _nextSequence++;
+    SceneNode::addChild(child);
+    
+    // The other children are sorted, so binary search for the new place
+    auto last = _children.end() - 1;
+    auto place = std::upper_bound(_children.begin(), last, child,
+                                  [this](const std::shared_ptr<scene2::SceneNode>& a,
+                                         const std::shared_ptr<scene2::SceneNode>& b) {
+        return isBehind(a.get(), b.get());
+    });
+    moveChild((unsigned int)(last - _children.begin()), (unsigned int)(place - _children.begin()));
+}
+
+/**
+ * Removes the child at the given position from this node
+ */
+void DepthNode::removeChild(unsigned int pos) {
+    CUAssertLog(pos < _children.size(), "Position index out of bounds");
+    const std::shared_ptr<scene2::SceneNode>& child = _children[pos];
+    _sequence.erase(child.get());
+    auto it = std::find(_dynamic.begin(), _dynamic.end(), child);
+    if (it != _dynamic.end()) _dynamic.erase(it);
+    SceneNode::removeChild(pos);
+}
+
+/**
+ * Removes all children from this node
+ */
+void DepthNode::removeAllChildren() {
+    _sequence.clear();
+    _dynamic.clear();
+    SceneNode::removeAllChildren();
+}
+
+/**
+ * Sets whether a child of this node may move, and so must be re-sorted every update
+ */
+void DepthNode::setDynamic(const std::shared_ptr<scene2::SceneNode>& child, bool value) {
+    CUAssertLog(child->getParent() == this, "The node is not a child of this node");
+    auto it = std::find(_dynamic.begin(), _dynamic.end(), child);
+    if (value && it == _dynamic.end()) {
+        _dynamic.push_back(child);
+    } else if (!value && it != _dynamic.end()) {
+        _dynamic.erase(it);
+    }
+}
+
+//  MARK: - Methods
+
+/**
+ * Moves every dynamic child to its place among the other children
+ */
+void DepthNode::update() {
+    _moves = 0;
+    for (const std::shared_ptr<scene2::SceneNode>& child : _dynamic) {
+        _moves += resort(child->getChildOffset());
+    }
+}
+
+//  MARK: - Helpers
+
+/**
+ * Returns true iff node a should be drawn before (behind) node b
+ */
+bool DepthNode::isBehind(const scene2::SceneNode* a, const scene2::SceneNode* b) const {
+    float depthA = a->getPosition().y - a->getHeight() / 2;
+    float depthB = b->getPosition().y - b->getHeight() / 2;
+    if (depthA != depthB) return depthA > depthB;
+
+    // Break ties by insertion order so that equal nodes never swap
+    return _sequence.at(a) < _sequence.at(b);
+}
+
+/**
+ * Moves the child at the given position to its sorted place, returning the distance moved
+ */
+int DepthNode::resort(unsigned int pos) {
+    const scene2::SceneNode* child = _children[pos].get();
+    unsigned int target = pos;
+    while (target > 0 && isBehind(child, _children[target - 1].get())) target--;
+    if (target == pos) {
+        while (target + 1 < _children.size() && isBehind(_children[target + 1].get(), child)) target++;
+    }
+    if (target == pos) return 0;
+    moveChild(pos, target);
+    return target > pos ? target - pos : pos - target;
+}
@@ -0,0 +1,107 @@
+//
+//  LCMPDepthNode.h
+//  Low Control Mall Patrol
+//
+//  This class is a scene graph node that keeps its children sorted by depth,
+//  so that nodes lower on the screen are drawn in front. Children are
+//  inserted in sorted order, and only the dynamic children (the players) are
+//  moved each frame, by shifting them to their new place among the others.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#ifndef __LCMP_DEPTH_NODE_H__
+#define __LCMP_DEPTH_NODE_H__
+#include <cugl/cugl.h>
+#include <unordered_map>
+
+class DepthNode : public cugl::scene2::SceneNode {
+protected:
+//  MARK: - Properties
+
+    /** The insertion order of each child, to break ties between equal depths */
+    std::unordered_map<const cugl::scene2::SceneNode*, Uint64> _sequence;
+    /** The insertion order of the next child */
+    Uint64 _nextSequence;
+    /** The children that may move, and so are re-sorted every update */
+    std::vector<std::shared_ptr<cugl::scene2::SceneNode>> _dynamic;
+    /** The number of positions the children moved in the last update */
+    int _moves;
+
+public:
+//  MARK: - Constructors
+
+    /**
+     * Constructs a Depth Node
+     */
+    DepthNode() : SceneNode(), _nextSequence(0), _moves(0) { _classname = "DepthNode"; }
+
+    /**
+     * Destructs a Depth Node
+     */
+    ~DepthNode() { dispose(); }
+
+    /**
+     * Disposes of all resources in this instance of Depth Node
+     */
+    virtual void dispose() override;
+
+    /**
+     * Returns a newly allocated Depth Node
+     */
+    static std::shared_ptr<DepthNode> alloc() {
+        std::shared_ptr<DepthNode> result = std::make_shared<DepthNode>();
+        return (result->init() ? result : nullptr);
+    }
+
+//  MARK: - Children
+
+    /**
+     * Adds a child to this node, in sorted position
+     */
+    virtual void addChild(const std::shared_ptr<cugl::scene2::SceneNode>& child) override;
+
+    /**
+     * Removes the child at the given position from this node
+     */
+    virtual void removeChild(unsigned int pos) override;
+
+    /**
+     * Removes all children from this node
+     */
+    virtual void removeAllChildren() override;
+
+    /**
+     * Sets whether a child of this node may move, and so must be re-sorted every update
+     */
+    void setDynamic(const std::shared_ptr<cugl::scene2::SceneNode>& child, bool value);
+
+//  MARK: - Methods
+
+    /**
+     * Moves every dynamic child to its place among the other children
+     */
+    void update();
+
+    /**
+     * Returns the number of positions the children moved in the last update
+     */
+    int getMoves() const { return _moves; }
+
+private:
+//  MARK: - Helpers
+
+    /**
+     * Returns true iff node a should be drawn before (behind) node b
+     */
+    bool isBehind(const cugl::scene2::SceneNode* a, const cugl::scene2::SceneNode* b) const;
+
+    /**
+     * Moves the child at the given position to its sorted place, returning the distance moved
+     */
+    int resort(unsigned int pos);
+
+};
+
+#endif /* __LCMP_DEPTH_NODE_H__ */
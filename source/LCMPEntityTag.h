@@ -0,0 +1,76 @@
+//
+//  LCMPEntityTag.h
+//  Low Control Mall Patrol
+//
+//  This class packs the identity of an obstacle (what kind of entity it
+//  belongs to, which player or trap, and what part of a trap it is) into the
+//  Box2D fixture user data, so collision callbacks never search for bodies.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#ifndef __LCMP_ENTITY_TAG_H__
+#define __LCMP_ENTITY_TAG_H__
+#include <cstdint>
+
+class EntityTag {
+public:
+//  MARK: - Enums
+
+    /** The kind of entity an obstacle belongs to */
+    enum Kind {
+        /** Walls, props and borders (the default for untagged obstacles) */
+        Scenery = 0,
+        Thief,
+        Cop,
+        Trap,
+        /** The number of kinds (for dispatch tables) */
+        KindCount
+    };
+
+    /** The part of a trap an obstacle represents */
+    enum Role {
+        None = 0,
+        Trigger,
+        Deactivation,
+        ThiefEffect,
+        CopEffect
+    };
+
+//  MARK: - Properties
+
+    /** The kind of entity */
+    Kind kind;
+    /** The player (cop) index, or 0 */
+    int owner;
+    /** The trap index, or 0 */
+    int trap;
+    /** The part of the trap, or None */
+    Role role;
+
+//  MARK: - Methods
+
+    /**
+     * Returns the tag stored in the given fixture user data
+     */
+    static EntityTag decode(uintptr_t data) {
+        EntityTag tag;
+        tag.kind  = (Kind)(data & 0xF);
+        tag.role  = (Role)((data >> 4) & 0xF);
+        tag.owner = (int)((data >> 8) & 0xFF);
+        tag.trap  = (int)((data >> 16) & 0xFFFF);
+        return tag;
+    }
+
+    /**
+     * Returns the fixture user data for the given tag fields
+     */
+    static uintptr_t encode(Kind kind, int owner = 0, int trap = 0, Role role = None) {
+        return ((uintptr_t)kind & 0xF) | (((uintptr_t)role & 0xF) << 4) |
+               (((uintptr_t)owner & 0xFF) << 8) | (((uintptr_t)trap & 0xFFFF) << 16);
+    }
+
+};
+
+#endif /* __LCMP_ENTITY_TAG_H__ */
@@ -23,10 +23,14 @@ void GameModel::dispose() {
 
 /**
  * initializes a Game Model
+ *
+ * Without assets, the game is headless: it only builds the physics of the players, the
+ * walls and the prop hitboxes, so that it can be simulated without a scene graph. Traps
+ * are sized by their textures, so a headless game has none.
  */
 bool GameModel::init(std::shared_ptr<cugl::physics2::ObstacleWorld>& world,
                      std::shared_ptr<cugl::scene2::SceneNode>& floornode,
-                     std::shared_ptr<cugl::scene2::SceneNode>& worldnode,
+                     const std::shared_ptr<cugl::scene2::SceneNode>& worldnode,
                      std::shared_ptr<cugl::scene2::SceneNode>& debugnode,
                      const std::shared_ptr<cugl::AssetManager>& assets,
                      float scale, const std::string& file,
@@ -42,177 +46,60 @@ bool GameModel::init(std::shared_ptr<cugl::physics2::ObstacleWorld>& world,
     _worldnode = worldnode;
     _debugnode = debugnode;
     _gameover = false;
+    _proxies = true;
+    _headless = assets == nullptr;
     _skinKey = skinKey;
     
     _actions = actions;
-    std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(file);
-    std::shared_ptr<JsonValue> json = reader->readJson();
     
-    _mapWidth = json->getFloat(WIDTH_FIELD);
-    _mapHeight = json->getFloat(HEIGHT_FIELD);
-    _tileSize = json->getFloat(T_SIZE_FIELD);
+    // Prefer the compiled level, and fall back to the Tiled map
+    _level = LevelData::load(file);
+    if (_level == nullptr) {
+        CULogError("Could not load level %s", file.c_str());
+        return false;
+    }
     
-    reader = JsonReader::allocWithAsset(PROPS_FILE);
-    shared_ptr<JsonValue> propTileset = reader->readJson();
-    map<int,GameModel::TileData> idToTileData = buildTileDataMap(propTileset, scale);
+    _mapWidth = _level->getMapWidth();
+    _mapHeight = _level->getMapHeight();
+    _tileSize = _level->getTileSize();
     
     timer = time(NULL);
     timeinfo = localtime (&timer);
-//    CULog("done reading tileset %s", asctime(timeinfo));
-    
-//    for(auto it = idToTileData.begin(); it != idToTileData.end(); it++){
-//        int key = it->first;
-//        TileData val = it->second;
-//        CULog("%d:\t%s", key, val.assetName.data());
-//    }
-
-    //init the map that converts Json Strings into Json Values
-
-    //CULog("-4");
-    constantsMap["activated"] = ACTIVATED;
-    constantsMap["collisionSound"] = COLLISION_SOUND;
-    constantsMap["copCollide"] = COP_COLLIDE;
-    constantsMap["copEffect"] = COP_EFFECT;
-    constantsMap["copLingerDuration"] = COP_LINGER_DURATION;
-    constantsMap["copLingerEffect"] = COP_LINGER_EFFECT;
-    constantsMap["effectArea"] = EFFECT_AREA;
-    constantsMap["idleActivatedAnimation"] = IDLE_ACTIVATED_ANIMATION,
-    constantsMap["idleDeactivatedAnimation"] = IDLE_DEACTIVATED_ANIMATION,
-    constantsMap["numUsages"] = NUM_USAGES;
-    constantsMap["textureActivationTrigger"] = TEXTURE_ACTIVATION_TRIGGER;
-    constantsMap["textureAsset"] = TEXTURE_ASSET;
-    constantsMap["textureDeactivationTrigger"] = TEXTURE_DEACTIVATION_TRIGGER;
-    constantsMap["thiefCollide"] = THIEF_COLLIDE;
-    constantsMap["thiefEffect"] = THIEF_EFFECT;
-    constantsMap["thiefLingerDuration"] = THIEF_LINGER_DURATION;
-    constantsMap["thiefLingerEffect"] = THIEF_LINGER_EFFECT;
-    constantsMap["triggerArea"] = TRIGGER_AREA;
-    constantsMap["triggerDeactivationArea"] = TRIGGER_DEACTIVATION_AREA;
-    
-    constantsMap["Escalator"] = ESCALATOR;
-    constantsMap["Teleport"] = TELEPORT;
-    constantsMap["Stairs"] = STAIRS;
-    constantsMap["Velocity Modifier"] = VELOCITY_MODIFIER;
-
-    constantsMap["NULL"] = NIL;
-    
-    std::shared_ptr<JsonValue> layers = json->get(LAYERS_FIELD);
-    std::shared_ptr<JsonValue> props = layers->get(PROPS_FIELD)->get(OBJECTS_FIELD);
-    std::shared_ptr<JsonValue> walls = layers->get(WALLS_FIELD)->get(OBJECTS_FIELD);
-    std::shared_ptr<JsonValue> copsSpawn = layers->get(COPS_FIELD)->get(OBJECTS_FIELD);
-    std::shared_ptr<JsonValue> thiefSpawn = layers->get(THIEF_FIELD)->get(OBJECTS_FIELD);
-    std::shared_ptr<JsonValue> traps = layers->get(TRAPS_FIELD)->get(OBJECTS_FIELD);
+//    CULog("done reading level %s", asctime(timeinfo));
     
     // Initialize backdrop
 
     //float backdropScale = (scale / _tileSize) * 1.12; // 1.12 is the scale of the floor plan relative to the tiled map
     float backdropScale = (scale / _tileSize);
 
-    initBackdrop(backdropScale, 5, 5, assets);
+    if (!_headless) initBackdrop(backdropScale, assets);
 
     // Initialize thief
-    initThief(scale, thiefSpawn, assets, _actions);
+    initThief(scale, _level->getThiefSpawn(), assets, _actions);
     
     // Initialize cops
-    for (int i = 0; i < 4; i++) initCop(i, scale, copsSpawn, assets, _actions);
+    for (int i = 0; i < 4; i++) initCop(i, scale, _level->getCopSpawn(i), assets, _actions);
 
     _obstacles = std::vector<std::shared_ptr<physics2::PolygonObstacle>>();
     
-    // Initialize walls
-    for (int i = 0; i < walls->size(); i++) initWall(walls->get(i), scale);
-    
-    // Initialize props
-    int prop_firstGid = 0;
-    auto tilesets = json->get("tilesets");
-    for(int i = 0; i < tilesets->size(); i++){
-        //TODO: make these constants
-        if(tilesets->get(i)->getString("source") == "PropsAndTraps.tsj"){
-            prop_firstGid = tilesets->get(i)->getInt("firstgid");
-            break;
-        }
-    }
-    if(prop_firstGid > 0){
-//    for (int i = 0; i < props->size(); i++) initProp(props->get(i), prop_firstGid, propTileset, assets, scale);
-        initProps(props, prop_firstGid, idToTileData, assets, scale);
-    }
+    // Gather the walls and props, and merge them into a few static obstacles
+    GeometryBaker baker;
+    baker.init(Size(_mapWidth, _mapHeight), MERGE_REGION_SIZE);
+    for (const LevelData::Shape& wall : _level->getWalls()) baker.add(wall.poly, Vec2(wall.x, wall.y));
+    if (_level->getPropFirstGid() > 0) initProps(assets, scale, baker);
+    initStaticGeometry(baker);
     
     timer = time(NULL);
     timeinfo = localtime (&timer);
 //    CULog("done initializing backdrop, players, walls, and props %s", asctime(timeinfo));
 
-    obstaclesInGrid = map<int, set<shared_ptr<physics2::PolygonObstacle>>>();
-
-    for(auto ob : _obstacles){
-        auto boundingbox = ob->getPolygon().getBounds();
-        for(int i = (boundingbox.getMinX()+ob->getX())/GRID_SIZE-1; i <= (boundingbox.getMaxX()+ob->getX())/GRID_SIZE+2; i++)
-            for(int j = (boundingbox.getMinY()+ob->getY())/GRID_SIZE-1; j <= (boundingbox.getMaxY()+ob->getY())/GRID_SIZE+2; j++){
-                obstaclesInGrid[hash(i,j)].insert(ob);
-            }
-//        ob->setEnabled(false);
-    }
-//    shared_ptr<PlayerModel> player = _thief;
-//    auto gridcell = player->getPosition();
-//    for(int d1 = -1; d1 <= 1; d1++)
-//        for(int d2 = -1; d2 <= 1; d2++){
-//            CULog("enabling for hash %d", hash(gridcell+Vec2(d1,d2)));
-//            for(auto ob : obstaclesInGrid[hash(gridcell+Vec2(d1,d2))]){
-//                ob->setEnabled(true);
-//                CULog("enabled obstacle for thief");
-//            }
-//        }
-//    for(auto it = _cops.begin(); it != _cops.end(); it++){
-//        player = it->second;
-//        gridcell = player->getPosition();
-//        for(int d1 = -1; d1 <= 1; d1++)
-//            for(int d2 = -1; d2 <= 1; d2++)
-//                for(auto ob : obstaclesInGrid[hash(gridcell+Vec2(d1,d2))]){
-//                    ob->setEnabled(true);
-//                    CULog("enabled obstacle for cop");
-//                }
-//    }
+    // Build the spatial grid over the walls and props
+    initGrid();
     
     // Initialize traps
-
-    vector<shared_ptr<JsonValue>> trapsJson = vector<shared_ptr<JsonValue>>();
-    vector<shared_ptr<JsonValue>> trapsObstaclesJson = vector<shared_ptr<JsonValue>>();
-
-    for (int i = 0; i < traps->size(); i++) {
-
-        shared_ptr<JsonValue> trap = traps->get(i); // Will either be a trap or an obstacle within the trap.
-
-        bool point = trap->getBool(POINT_FIELD);
-
-        if (point) {
-            trapsJson.push_back(trap);
-        }
-        else {
-            trapsObstaclesJson.push_back(trap);
-        }
-
-    }
-    //CULog("-1");
-
-    map<int, ObstacleNode_x_Y_Gid_struct> obstacleMap;
-    map<int, ObstacleNode_x_Y_Gid_struct> obstacleMap2; // This is extremely scuff but we're not sure how to copy an obstacle so we are making all the obstacles twice.
-    for (int i = 0; i < trapsObstaclesJson.size(); i++) { // On the bright side it gets only called once a game
-        
-//        CULog("calling readJsonShape twice in traps");
-        
-        ObstacleNode_x_Y_Gid_struct trapObstacle = readJsonShape(trapsObstaclesJson.at(i), scale);
-        obstacleMap.insert(pair<int, ObstacleNode_x_Y_Gid_struct>(trapsObstaclesJson.at(i)->getInt(ID_FIELD), trapObstacle));
-
-        // Tony: I wanna cry... Omg I'm gonna cry
-        ObstacleNode_x_Y_Gid_struct trapObstacle2 = readJsonShape(trapsObstaclesJson.at(i), scale);
-        obstacleMap2.insert(pair<int, ObstacleNode_x_Y_Gid_struct>(trapsObstaclesJson.at(i)->getInt(ID_FIELD), trapObstacle2));
-        //obstacleMap[trapsObstaclesJson.at(i)->getInt(ID_FIELD)] = trapObstacle.obstacle;
-
-    }
-    
-    timer = time(NULL);
-    timeinfo = localtime (&timer);
-//    CULog("done reading trap info %s", asctime(timeinfo));
-
-    for (int i = 0; i < trapsJson.size(); i++) initTrap(i, trapsJson[i], obstacleMap, obstacleMap2, idToTileData, prop_firstGid,scale, assets);
+    const vector<LevelData::Trap>& traps = _level->getTraps();
+    for (int i = 0; i < traps.size() && !_headless; i++) initTrap(i, traps[i], scale, assets);
+    _trapShapeObstacles.clear();
     
     timer = time(NULL);
     timeinfo = localtime (&timer);
@@ -221,6 +108,9 @@ bool GameModel::init(std::shared_ptr<cugl::physics2::ObstacleWorld>& world,
     // Initialize borders
     initBorder(scale);
     
+    // Remember the start of the round so that resets do not rebuild the game
+    snapshot();
+    
     timer = time(NULL);
     timeinfo = localtime (&timer);
 //    CULog("done with initialization %s", asctime(timeinfo));
@@ -228,6 +118,43 @@ bool GameModel::init(std::shared_ptr<cugl::physics2::ObstacleWorld>& world,
     return true;
 }
 
+/**
+ * Records the current state of the players, traps and obstacles as the start of a round
+ */
+void GameModel::snapshot() {
+    _snapshot = _world->snapshot();
+}
+
+/**
+ * Rewinds the players, traps and obstacles to the last snapshot, in place
+ *
+ * Walls, props and their scene graph nodes are kept as they are, so a new
+ * round does not reparse the level or reallocate any obstacles.
+ */
+void GameModel::restore() {
+    _world->restore(_snapshot);
+    _gameover = false;
+    
+    _thief->reset();
+    for (auto entry = _cops.begin(); entry != _cops.end(); entry++) {
+        entry->second->reset();
+    }
+    for (shared_ptr<TrapModel> trap : _traps) {
+        trap->reset();
+    }
+    
+    // The grid obstacles are static, so the snapshot does not cover them and they are disabled here
+    for (int ii : _activeObstacles) {
+        _obstacles[ii]->setEnabled(false);
+    }
+    _obstacleActive.assign(_obstacles.size(), false);
+    _obstacleStamp.assign(_obstacles.size(), 0);
+    _activeObstacles.clear();
+    _nextActiveObstacles.clear();
+    _gridFrame = 0;
+    _obstacleToggles = 0;
+}
+
 /**
  * Updates all game objects
  */
@@ -235,41 +162,36 @@ void GameModel::update(float timestep) {
     
     // Update the thief
     _thief->update(timestep);
-    _thief->playAnimation();
+    if (!_headless) _thief->playAnimation();
     
     // Update all of the cops
     for (auto entry = _cops.begin(); entry != _cops.end(); entry++) {
         entry->second->update(timestep);
-        entry->second->playAnimation();
+        if (!_headless) entry->second->playAnimation();
     }
     
-    for (auto ob : _obstacles)
-        ob->setEnabled(false);
-    
-    shared_ptr<PlayerModel> player = _thief;
-    auto gridcell = player->getPosition()/GRID_SIZE;
-            for(auto ob : obstaclesInGrid[hash(gridcell)])
-                ob->setEnabled(true);
-//                CULog("enabled obstacle for thief");
-        
-    for(auto it = _cops.begin(); it != _cops.end(); it++){
-        player = it->second;
-        gridcell = player->getPosition()/GRID_SIZE;
-                if(obstaclesInGrid[hash(gridcell)].size() > 0)
-//                CULog("enabling %d obs for hash %d", obstaclesInGrid[hash(gridcell)].size(), hash(gridcell));
-                for(auto ob : obstaclesInGrid[hash(gridcell)])
-                    ob->setEnabled(true);
-
-    }
+    // Only toggle the obstacles that entered or left the players' neighborhood
+    updateGrid();
 
     // update the traps
     updateTraps(timestep);
 }
 
+/**
+ * Draws the players the given fraction of the way between the last two physics steps
+ */
+void GameModel::interpolate(float alpha) {
+    _thief->interpolate(alpha);
+    for (auto entry = _cops.begin(); entry != _cops.end(); entry++) {
+        entry->second->interpolate(alpha);
+    }
+}
+
 /**
  * Applies an acceleration to the thief (most likely for local updates)
  */
 void GameModel::updateThief(cugl::Vec2 acceleration) {
+    _thief->setProxy(false);
     _thief->applyForce(acceleration);
 //    CULog("Thief node pos: (%f, %f)", _thief->getNode()->getPositionX(), _thief->getNode()->getPositionY());
 }
@@ -279,6 +201,7 @@ void GameModel::updateThief(cugl::Vec2 acceleration) {
  */
 void GameModel::updateCop(Vec2 acceleration, Vec2 thiefPosition, int copID, float timestep) {
     shared_ptr<CopModel> cop = _cops[copID];
+    cop->setProxy(false);
     if (cop->getTackling()) cop->applyTackle(timestep, thiefPosition);
     else cop->applyForce(acceleration);
 }
@@ -287,6 +210,7 @@ void GameModel::updateCop(Vec2 acceleration, Vec2 thiefPosition, int copID, floa
  * Updates the position and velocity of the thief
  */
 void GameModel::updateThief(cugl::Vec2 position, cugl::Vec2 velocity, cugl::Vec2 force) {
+    _thief->setProxy(_proxies);
     _thief->applyNetwork(position, velocity, force);
 }
 cugl::Vec2 _tackleDirection;
@@ -308,6 +232,7 @@ void GameModel::updateCop(cugl::Vec2 position, cugl::Vec2 velocity,
                           bool tackleSuccessful,
                           int copID) {
     shared_ptr<CopModel> cop = _cops[copID];
+    cop->setProxy(_proxies);
     cop->applyNetwork(position, velocity, force, tackleDirection, tacklePosition,
                       tackleTime, tackling, caughtThief, tackleSuccessful);
 }
@@ -316,6 +241,8 @@ void GameModel::updateCop(cugl::Vec2 position, cugl::Vec2 velocity,
  * Activates a trap
  */
 void GameModel::activateTrap(int trapID) {
+    // A headless game has no traps, but may still hear of them
+    if (trapID < 0 || trapID >= _traps.size()) return;
     _traps[trapID]->activate();
 }
 
@@ -323,46 +250,39 @@ void GameModel::activateTrap(int trapID) {
  * Activates a trap
  */
 void GameModel::deactivateTrap(int trapID) {
+    if (trapID < 0 || trapID >= _traps.size()) return;
     _traps[trapID]->deactivate();
 }
 
-//  MARK: - Helpers
-
-void GameModel::initBackdrop(float scale, int rows, int cols,
-                             const shared_ptr<AssetManager>& assets) {
-
-    // Create textured node to store texture for each map chunk
-    std::shared_ptr<cugl::scene2::PolygonNode> chunkNode;
-
-    Vec2 origin = Vec2(0.0f, 0.0f);
-
-    // Cycle through all map chunks
-    for (int y = 1; y <= cols; y++) {
-        for (int x = 1; x <= rows; x++) {
+/**
+ * Streams in the map chunks near the given view (in background node coordinates)
+ */
+void GameModel::updateBackdrop(Rect view) {
+    _backdrop.update(view);
+}
 
-            // Retrieve map chunk from assets
-            string assetName = strtool::format("row-%d-column-%d", y, x);
-            auto mapChunk = assets->get<Texture>(assetName);
+//  MARK: - Helpers
 
-            // Create textured node for chunk
-            chunkNode = scene2::PolygonNode::allocWithTexture(mapChunk);
-            chunkNode->setAnchor(0.0f, 0.0f);
-            chunkNode->setScale(scale);
-            chunkNode->setPositionX(origin.x + mapChunk->getWidth() * scale * (x - 1));
-            chunkNode->setPositionY(origin.y + mapChunk->getHeight() * scale * (y - 1));
-            _floornode->addChild(chunkNode);
-        }
-    }
+/**
+ * Initializes the background of the map
+ *
+ * The map chunks are not loaded here; they are streamed in around the camera by {@link updateBackdrop}.
+ */
+void GameModel::initBackdrop(float scale, const shared_ptr<AssetManager>& assets) {
+    _backdrop.dispose();
+    _backdrop.init(_floornode, assets, WALL_ASSETS_FILE, scale);
 }
 
-void GameModel::initThief(float scale,
-                          const shared_ptr<JsonValue>& spawn,
+void GameModel::initThief(float scale, Vec2 spawn,
                           const shared_ptr<AssetManager>& assets,
                           shared_ptr<scene2::ActionManager>& actions) {
     // Create thief node
-    std::shared_ptr<scene2::SceneNode> thiefNode = scene2::SceneNode::alloc();
-    thiefNode->setAnchor(Vec2::ANCHOR_CENTER);
-    _worldnode->addChildWithName(thiefNode, "thief");
+    std::shared_ptr<scene2::SceneNode> thiefNode = nullptr;
+    if (!_headless) {
+        thiefNode = scene2::SceneNode::alloc();
+        thiefNode->setAnchor(Vec2::ANCHOR_CENTER);
+        _worldnode->addChildWithName(thiefNode, "thief");
+    }
     
     // Create thief
     _thief = std::make_shared<ThiefModel>();
@@ -373,18 +293,19 @@ void GameModel::initThief(float scale,
     _world->addObstacle(_thief);
     
     // Position thief afterwards to not have to deal with changing world size
-    _thief->setPosition(Vec2(spawn->get(0)->getFloat(X_FIELD) / _tileSize,
-                             _mapHeight - spawn->get(0)->getFloat(Y_FIELD) / _tileSize));
+    _thief->setPosition(spawn);
 }
 
-void GameModel::initCop(int copID, float scale,
-                        const std::shared_ptr<JsonValue>& spawns,
+void GameModel::initCop(int copID, float scale, Vec2 spawn,
                         const std::shared_ptr<cugl::AssetManager>& assets,
                         std::shared_ptr<cugl::scene2::ActionManager>& actions) {
     // Create cop node
-    std::shared_ptr<scene2::SceneNode> copNode = scene2::SceneNode::alloc();
-    copNode->setAnchor(Vec2::ANCHOR_CENTER);
-    _worldnode->addChildWithName(copNode, "cop" + to_string(copID));
+    std::shared_ptr<scene2::SceneNode> copNode = nullptr;
+    if (!_headless) {
+        copNode = scene2::SceneNode::alloc();
+        copNode->setAnchor(Vec2::ANCHOR_CENTER);
+        _worldnode->addChildWithName(copNode, "cop" + to_string(copID));
+    }
     
     // Create cop
     std::shared_ptr<CopModel> cop = std::make_shared<CopModel>();
@@ -395,332 +316,130 @@ void GameModel::initCop(int copID, float scale,
     _world->addObstacle(cop);
     
     // Position cop afterwards to not have to deal with changing world size
-    
-    std::shared_ptr<JsonValue> spawn = spawns->get(copID);
-    cop->setPosition(Vec2(spawn->getFloat(X_FIELD) / _tileSize,
-                          _mapHeight - spawn->getFloat(Y_FIELD) / _tileSize));
+    cop->setPosition(spawn);
     
     // Add the cop to the mapping of cops
     _cops[copID] = cop;
 }
 
-map<int,GameModel::TileData> GameModel::buildTileDataMap(const shared_ptr<JsonValue>& propTileset, float scale){
-    // build map from tile id to asset name
-    map<int, GameModel::TileData> idToTileData {};
-    auto tiles = propTileset->get("tiles");
-    int tilecount = propTileset->getInt("tilecount");
-    for(int i = 0; i < tilecount; i++){
-        auto tile = tiles->get(i);
-        int id = tile->get("id")->asInt();
-        //CULog("%d", id);
-        auto properties = tile->get("properties");
-        // get value of property with matching names
-        // the other way to do this is tony's travesty
-        // and there's only 4 things so if/elif is fine
-        string assetName = "";
-        bool animated = false;
-        int anim_rows = 0;
-        int anim_cols = 0;
-        for(int j = 0; j < properties->size(); j++){
-            auto p = properties->get(j);
-            if(p == nullptr) break;
-            auto pname = p->getString("name");
-            if(pname == "name") {
-                assetName = p->getString("value");
-            } else if(pname == "animated") {
-                animated = p->getBool("value");
-            } else if(pname == "anim_rows") {
-                anim_rows = p->getInt("value");
-            } else if(pname == "anim_cols") {
-                anim_cols = p->getInt("value");
-            }
-        }
-//        CULog("reading tile %s", assetName.data());
-        vector<shared_ptr<ObstacleNode_x_Y_Gid_struct>> hitboxes;
-        if (tile->get("objectgroup") != nullptr) {
-            auto hitbox_jsons = tile->get("objectgroup")->get("objects");
-            for(int j = 0; j < hitbox_jsons->size(); j++){
-                auto hb_json = hitbox_jsons->get(j);
-//                CULog("contents %s", hb_json->toString().data());
-//                CULog("calling readJsonShape in buildTileDataMap");
-                auto s = make_shared<ObstacleNode_x_Y_Gid_struct>(readJsonShape(hb_json, scale));
-                hitboxes.push_back(s);
-            }
-        }
-        
-        idToTileData[id] = {assetName, hitboxes, animated, anim_rows, anim_cols};
-//        CULog("%s has hitboxes %s", assetName.data(), hitboxes->toString().data());
-        // this is correct
-    }
-    
-    return idToTileData;
-}
-
-
-void GameModel::initProps(const shared_ptr<JsonValue>& props,
-                          int props_firstgid,
-                          map<int,GameModel::TileData> idToTileData,
-                          const shared_ptr<AssetManager>& assets,
-                          float scale){
-    for(int i = 0; i < props->size(); i++) {
-        auto prop = props->get(i);
-        
-        float x = prop->getFloat(X_FIELD) / _tileSize;
-        float y = prop->getFloat(Y_FIELD) / _tileSize;
-        float width = prop->getFloat(WIDTH_FIELD) / _tileSize;
-        float height = prop->getFloat(HEIGHT_FIELD) / _tileSize;
-        y = _mapHeight - y;
+/**
+ * Places all props into the world, adding their hitboxes to the static geometry
+ *
+ * The hitboxes are scaled by the texture sizes stored in the level, so a headless game
+ * (without assets) still collides with the props, and only skips their nodes.
+ */
+void GameModel::initProps(const shared_ptr<AssetManager>& assets, float scale, GeometryBaker& baker) {
+    const map<int, LevelData::Tile>& tiles = _level->getTiles();
+    for (const LevelData::Prop& prop : _level->getProps()) {
+        float x = prop.x;
+        float y = prop.y;
+        float width = prop.width;
+        float height = prop.height;
 //        CULog("prop x,y %f %f", x,y);
 //        CULog("prop dims %f %f", width, height);
         
-        int gid = prop->getInt("gid");
-        //TODO: incorporate rotation/reflection using tiled flags
-        gid &= CLEAR_FLAGS_FILTER;
-        int id = gid - props_firstgid;
+        auto entry = tiles.find(prop.tile);
+        if (entry == tiles.end()) continue;
+        const LevelData::Tile& data = entry->second;
+        if (data.imageWidth <= 0 || data.imageHeight <= 0) continue;
         
-        TileData data = idToTileData[id];
-        
-//        CULog("%d asset name %s", id, data.assetName.data());
-        auto texture = assets->get<Texture>(data.assetName);
-        //TODO: get this working
-        Vec2 scale_ = Vec2(width/texture->getWidth(), height/texture->getHeight());
-//        Vec2 scale_ = Vec2::ONE;
+//        CULog("%d asset name %s", prop.tile, data.assetName.data());
         // size of image in world in box2d units / size of texture in pixels
-        // * pixels in world / pixels
+        Vec2 scale_ = Vec2(width/data.imageWidth, height/data.imageHeight);
+        
+        // add hitboxes to the static geometry
+        for (const LevelData::Shape& shape : data.hitboxes) {
+            baker.add(scaleHitbox(shape, scale_, x, y, height), Vec2::ZERO);
+        }
+        if (_headless) continue;
         
         // add node to world
+        auto texture = assets->get<Texture>(data.assetName);
         shared_ptr<scene2::PolygonNode> node;
         if(data.animated){
-            node = scene2::SpriteNode::alloc(texture, data.anim_rows, data.anim_cols);
+            node = scene2::SpriteNode::alloc(texture, data.animRows, data.animCols);
 //            CULog("prop is animated");
         } else {
             node = scene2::PolygonNode::allocWithTexture(texture);
 //            CULog("prop is not animated");
         }
         node->setScale(scale_.x * scale, scale_.y * scale);
-        _worldnode->addChild(node);
         node->setPosition((x + width / 2) * scale, (y + height / 2) * scale);
+        node->setCullable(true);
+        _worldnode->addChild(node);
 //        CULog("prop node position %f %f", (x + width / 2) * scale, (y + height / 2) * scale);
-        
-        // add hitboxes to world
-        auto size = data.hitboxes.size();
-        for(int j = 0; j < size; j++){
-            auto shape = data.hitboxes[j];
-            
-            auto obstacle = scaleHitbox(shape, scale_, x, y, height);
-//            obstacle->setDebugScene(_debugnode);
-//            CULog("prop obst scaleHitbox call\n\t\tscale_ %f %f\n\t\tx %f\n\t\ty %f\n\t\theight %f",
-//                  scale_.x, scale_.y,
-//                  x, y,
-//                  height);
-//            CULog("prop obst position %f %f", obstacle->getX(), obstacle->getY());
-            _obstacles.push_back(obstacle);
-//            obstacle->setEnabled(false);
-        }
     }
 }
 
-std::shared_ptr<cugl::physics2::PolygonObstacle> GameModel::scaleHitbox(std::shared_ptr<GameModel::ObstacleNode_x_Y_Gid_struct> shape, Vec2 scale_, float x, float y, float height) {
-    auto x_ = shape->x;
-    auto y_ = shape->y;
-    y_ -= _mapHeight;
+/**
+ * Returns the position of a prop's hitbox scaled to match what is seen in Tiled
+ */
+Vec2 GameModel::scaleHitboxPosition(const LevelData::Shape& shape, Vec2 scale_, float x, float y, float height) {
+    return Vec2(shape.x * scale_.x * _tileSize + x,
+                (shape.y - _mapHeight) * scale_.y * _tileSize + y + height);
+}
 
-    auto reference_obstacle = shape->obstacle;
-    auto poly = Poly2(reference_obstacle->getPolygon());
+/**
+ * Returns a prop's hitbox in world coordinates, scaled to match what is seen in Tiled
+ */
+Poly2 GameModel::scaleHitbox(const LevelData::Shape& shape, Vec2 scale_, float x, float y, float height) {
+    Poly2 poly = shape.poly;
     poly *= scale_ * _tileSize;
-
-    auto obstacle = physics2::PolygonObstacle::alloc(poly);
-    obstacle->setDebugScene(_debugnode);
-//    obstacle->setDebugScene(nullptr);
-    _world->addObstacle(obstacle);
-    obstacle->setPosition(x_ * scale_.x * _tileSize + x,
-        y_ * scale_.y * _tileSize + y
-        + height);
-
-    return obstacle;
+    poly += scaleHitboxPosition(shape, scale_, x, y, height);
+    return poly;
 }
 
 /**
- Reads PolygonObstacle and PolygonNode from Tiled Json object.
- Does not add either to the world/debugscene or assign color/texture, and obstacle position is 0,0.
+ * Initializes the merged walls and props, as one static obstacle per region
+ *
+ * The walls and props never move, so a static body for each region of the map replaces
+ * the body of every single wall and hitbox, and shapes that overlap no longer add fixtures.
  */
-GameModel::ObstacleNode_x_Y_Gid_struct GameModel::readJsonShape(const shared_ptr<JsonValue>& json, float scale){
-    std::shared_ptr<JsonValue> polygon = json->get(POLYGON_FIELD);
-    bool ellipse = json->getBool(ELLIPSE_FIELD);
-    float x = json->getFloat(X_FIELD) / _tileSize;
-    float y = json->getFloat(Y_FIELD) / _tileSize;
-//    CULog("x,y %f %f", x*_tileSize, y*_tileSize);
-    float width = json->getFloat(WIDTH_FIELD) / _tileSize;
-    float height = json->getFloat(HEIGHT_FIELD) / _tileSize;
-    int gid = json->getInt(GID_FIELD);
-    
-    // We want to populate the following obstacle and node
-    shared_ptr<physics2::PolygonObstacle> obstacle;
-    shared_ptr<scene2::PolygonNode> node;
-    
-    // The wall component is an ellipse
-    if (ellipse) {
-        // Adjust the coordinates to match CUGL
-        x = x + width / 2;
-        y = _mapHeight - (height / 2) - y;
-        
-        // Make a wall and a corresponding node from a polygon
-        // TODO: Maybe make this a model or a type of ObstacleModel
-        Poly2 poly = PolyFactory(POLYFACTORY_TOLERANCE).makeEllipse(Vec2::ZERO, Vec2(width,height));
-        obstacle = physics2::PolygonObstacle::alloc(poly);
-        node = scene2::PolygonNode::allocWithPoly(poly);
-        node->setPosition(x * scale, y * scale);
-    }
-    
-    // The wall component is a polygon
-    else if (polygon != nullptr) {
-        // Adjust the coordinates to match CUGL
-        y = _mapHeight - y;
-        
-        // Gather all of the vertices scaled to Box2D coordinates
-        vector<Vec2> vertices;
-        shared_ptr<JsonValue> points = json->get(POLYGON_FIELD);
-        for (int ii = 0; ii < points->size(); ii++) {
-            shared_ptr<JsonValue> vertex = points->get(ii);
-            float localx = vertex->getFloat(X_FIELD) / _tileSize;
-            float localy = -vertex->getFloat(Y_FIELD) / _tileSize;
-            vertices.push_back(Vec2(localx,localy));
-        }
-                
-        // Create a path in the counter clockwise direction, give up if not valid
-        Path2 path(vertices);
-        if (path.orientation() == 0) throw runtime_error("non-closed path");
-        if (path.orientation() != -1) path.reverse();
-        
-        // Create a polygon from that path
-        EarclipTriangulator triangulator;
-        triangulator.set(path);
-        triangulator.calculate();
-        Poly2 poly = triangulator.getPolygon();
-
-        // Anchor the node on the relative position of the first node
-        Rect bounds = poly.getBounds();
-        Vec2 range(bounds.getMaxX() + abs(bounds.getMinX()),
-                   bounds.getMaxY() + abs(bounds.getMinY()));
-        Vec2 anchor(abs(bounds.getMinX()) / range.x,
-                    abs(bounds.getMinY()) / range.y);
+void GameModel::initStaticGeometry(const GeometryBaker& baker) {
+    for (const Poly2& poly : baker.bake()) {
+        auto obstacle = physics2::PolygonObstacle::alloc(poly);
+        obstacle->setBodyType(b2_staticBody);
         
-        // Make the wall and the node from the polygon
-        obstacle = physics2::PolygonObstacle::alloc(poly);
-        node = scene2::PolygonNode::allocWithPoly(poly);
-        node->setAnchor(anchor);
-        node->setPosition(x * scale, y * scale);
-    }
-    
-    // The wall component is a rectangle
-    else {
-        // Flip the y coordinate
-        y = _mapHeight - height - y;
+        // Add the obstacle to the world
+        obstacle->setDebugScene(_debugnode);
+        obstacle->setDebugColor(Color4::RED);
+        _world->addObstacle(obstacle);
         
-        // Make a wall and a corresponding node from a polygon
-        // TODO: Maybe make this a model or a type of ObstacleModel
-        Poly2 poly = PolyFactory(POLYFACTORY_TOLERANCE).makeRect(Vec2::ZERO, Vec2(width, height));
-        obstacle = physics2::PolygonObstacle::alloc(poly);
-        node = scene2::PolygonNode::allocWithPoly(poly);
-        node->setPosition((x + width / 2) * scale, (y + height / 2) * scale);
+        _obstacles.push_back(obstacle);
     }
-
-    node->setScale(scale);
-    
-    GameModel::ObstacleNode_x_Y_Gid_struct o = {obstacle, node, x, y, gid};
-    return o;
 }
 
+
 /**
- * Initializes a single wall
+ * Returns a new obstacle for a trap shape, sharing its geometry with every other obstacle for that shape
  */
-void GameModel::initWall(const std::shared_ptr<JsonValue>& json, float scale) {
-//    float x = json->getFloat(X_FIELD) / _tileSize;
-//    float y = json->getFloat(Y_FIELD) / _tileSize;
-    
-//    CULog("calling readJsonShape in initWall");
-    auto shape = readJsonShape(json, scale);
-    
-    auto wall = shape.obstacle;
-    auto node = shape.node;
-    float x = shape.x;
-    float y = shape.y;
-    
-    // Add the wall to the world
-    wall->setDebugScene(_debugnode);
-    wall->setDebugColor(Color4::RED);
-    _world->addObstacle(wall);
-    
-    // Set the position afterwards in case there's something weird with bounds
-    wall->setPosition(x, y);
-    
-    // Add the node to the world node
-    node->setColor(Color4::GRAY);
-
-    
-    _obstacles.push_back(wall);
-    
-    // Uncomment if you need to see the walls on the map
-//    _worldnode->addChild(node);
-
+shared_ptr<physics2::PolygonObstacle> GameModel::cloneTrapShape(int shapeID) {
+    auto it = _trapShapeObstacles.find(shapeID);
+    if (it == _trapShapeObstacles.end()) {
+        const LevelData::Shape& shape = _level->getTrapShapes().at(shapeID);
+        it = _trapShapeObstacles.emplace(shapeID, physics2::PolygonObstacle::alloc(shape.poly)).first;
+    }
+    return physics2::PolygonObstacle::allocWithClone(*it->second);
 }
 
-
 /**
  * Initializes a single trap
  */
-void GameModel::initTrap(int trapID,
-                         const std::shared_ptr<cugl::JsonValue>& json,
-                         const map<int, ObstacleNode_x_Y_Gid_struct>& map1,
-                         const map<int, ObstacleNode_x_Y_Gid_struct>& map2,
-                         const map<int, GameModel::TileData> idToTileData, const int prop_firstGid,
-                         float scale,
+void GameModel::initTrap(int trapID, const LevelData::Trap& data, float scale,
                          const std::shared_ptr<cugl::AssetManager>& assets) {
+    const map<int, LevelData::Shape>& shapes = _level->getTrapShapes();
     
-    // Create the trap from the json
-
-    //init variables
-
-    //CULog("0");
-
     shared_ptr<TrapModel> trap = std::make_shared<TrapModel>();
-    shared_ptr<TrapModel::Effect> copEffect = std::make_shared<TrapModel::Effect>();
-    shared_ptr<TrapModel::Effect> thiefEffect = std::make_shared<TrapModel::Effect>();
-    shared_ptr<TrapModel::Effect> copLingerEffect = std::make_shared<TrapModel::Effect>();
-    shared_ptr<TrapModel::Effect> thiefLingerEffect = std::make_shared<TrapModel::Effect>();
-
+    
     shared_ptr<Texture> activationTriggerTexture = std::make_shared<Texture>();
     shared_ptr<Texture> deactivationTriggerTexture = std::make_shared<Texture>();
-    shared_ptr<Texture> assetTexture = std::make_shared<Texture>();
-
-    shared_ptr<Vec2> activationTriggerTextureScale = std::make_shared<Vec2>();
-    shared_ptr<Vec2> deactivationTriggerTextureScale = std::make_shared<Vec2>();
-    shared_ptr<Vec2> assetTextureScale = std::make_shared<Vec2>();
+    if (!data.activationTexture.empty()) activationTriggerTexture = assets->get<Texture>(data.activationTexture);
+    if (!data.deactivationTexture.empty()) deactivationTriggerTexture = assets->get<Texture>(data.deactivationTexture);
 
     shared_ptr<cugl::physics2::PolygonObstacle> thiefEffectArea = std::make_shared<cugl::physics2::PolygonObstacle>();
     shared_ptr<cugl::physics2::PolygonObstacle> copEffectArea = std::make_shared<cugl::physics2::PolygonObstacle>();
-    shared_ptr<cugl::physics2::PolygonObstacle> tempObst;
+    Vec2 effectAreaPosition;
 
-    std::shared_ptr<cugl::JsonValue> properties = json->get(PROPERTIES_FIELD);
-    vector<std::shared_ptr<cugl::JsonValue>> children = properties->children();
-
-    bool activated = false;
-    bool copCollide = false;
-    bool thiefCollide = false;
-    bool idleActivatedAnimation = false;
-    bool idleDeactivatedAnimation = false;
-    //int effectObjectId = -1;
-    float effectAreaX = 0;
-    float effectAreaY = 0;
-    int triggerObjectId = -1;
-    int deactivationObjectId = -1;
-    int numUses = -1;
-    int copEffectLingerDur = 0;
-    int thiefEffectLingerDur = 0;
-    bool sfxOn = false;
-    std::string sfxKey = "";
-
-    TileData td;
     string assetName = "";
     bool animated = false;
     int anim_rows = 0;
@@ -734,200 +453,72 @@ void GameModel::initTrap(int trapID,
     float height = 0;
     float width = 0;
 
-    //CULog("%s", children.at(3)->get(NAME_FIELD)->asString());
-  
-    // read in the JSON values and match it to the proper property
-    for (int i = 0; i < children.size(); i++) {
-        std::shared_ptr<cugl::JsonValue> elem = children.at(i);
-        std::string name = elem->getString(NAME_FIELD, "NULL");
-        switch (constantsMap[name])
-        {
-
-        case ACTIVATED:
-            //CULog("in activated");
-            activated = elem->getBool(VALUE_FIELD);
-            //CULog("%d", activated);
-            break;
-                
-        case COLLISION_SOUND:
-            sfxKey = elem->getString(VALUE_FIELD);
-            break;
-
-        case COP_COLLIDE:
-            copCollide = elem->getBool(VALUE_FIELD);
-            break;
+    // The effect area is the hitbox of the trap's texture, scaled to the texture object
+    auto textureShape = shapes.find(data.textureObject);
+    if (textureShape != shapes.end()) {
+        const LevelData::Shape& shape = textureShape->second;
+        const LevelData::Tile& td = _level->getTiles().at(shape.gid - _level->getPropFirstGid());
+        animated = td.animated;
+        anim_rows = td.animRows;
+        anim_cols = td.animCols;
+        assetName = td.assetName;
+
+        shared_ptr<Texture> assetTexture = assets->get<Texture>(assetName);
         
-        case COP_EFFECT:
-            copEffect = readJsonEffect(elem);
-            break;
+        Size size = shape.poly.getBounds().size;
+        x = shape.x;
+        y = shape.y + size.height;
+        height = size.height;
+        width = size.width;
+        scale_ = Vec2(width * anim_cols / assetTexture->getWidth(),
+                      height * anim_rows / assetTexture->getHeight());
+//        CULog("trap x,y %f %f", x,y);
+//        CULog("trap dims %f %f", width,height);
         
-        case COP_LINGER_DURATION:
-            copEffectLingerDur = elem->getFloat(VALUE_FIELD);
-            break;
-
-        case COP_LINGER_EFFECT:
-            copLingerEffect = readJsonEffect(elem);
-            break;
-
-        case EFFECT_AREA:
-            //effectObjectId = elem->getInt(VALUE_FIELD);
-            break;
-
-        case IDLE_ACTIVATED_ANIMATION:
-            idleActivatedAnimation = elem->getBool(VALUE_FIELD);
-            break;
-
-        case IDLE_DEACTIVATED_ANIMATION:
-            idleDeactivatedAnimation = elem->getBool(VALUE_FIELD);
-            break;
-
-        case NUM_USAGES:
-            numUses = elem->getInt(VALUE_FIELD);
-            break;
-
-        case THIEF_COLLIDE:
-            thiefCollide = elem->getBool(VALUE_FIELD);
-            break;
-
-        case TEXTURE_ACTIVATION_TRIGGER:
-            activationTriggerTexture = assets->get<Texture>(elem->getString(VALUE_FIELD));
-            break;
-
-        case TEXTURE_ASSET:
-            //CULog("%d", map1.at(elem->getInt(VALUE_FIELD)).gid);
-            //auto fuck = map1.at(elem->getInt(VALUE_FIELD));
-
-            td = idToTileData.at(map1.at(elem->getInt(VALUE_FIELD)).gid - prop_firstGid);
-            animated = td.animated;
-            anim_rows = td.anim_rows;
-            anim_cols = td.anim_cols;
-            assetName = td.assetName;
-
-            assetTexture = assets->get<Texture>(assetName);
-
-            scale_ = Vec2(
-                          map1.at(elem->getInt(VALUE_FIELD)).obstacle->getSize().width * anim_cols /assetTexture->getWidth(),
-                          map1.at(elem->getInt(VALUE_FIELD)).obstacle->getSize().height * anim_rows/ assetTexture->getHeight());
-
-            tempObst = scaleHitbox(td.hitboxes[0], scale_, map1.at(elem->getInt(VALUE_FIELD)).x, map1.at(elem->getInt(VALUE_FIELD)).y + map1.at(elem->getInt(VALUE_FIELD)).obstacle->getSize().height, map1.at(elem->getInt(VALUE_FIELD)).obstacle->getSize().height);
-                effectAreaX = tempObst->getX();
-                effectAreaY = tempObst->getY();
-                tempObst->setDebugScene(nullptr);
-                _world->removeObstacle(&*tempObst);
-                
-                x = map1.at(elem->getInt(VALUE_FIELD)).x;
-                y = map1.at(elem->getInt(VALUE_FIELD)).y + map1.at(elem->getInt(VALUE_FIELD)).obstacle->getSize().height;
-                height = map1.at(elem->getInt(VALUE_FIELD)).obstacle->getSize().height;
-                width = map1.at(elem->getInt(VALUE_FIELD)).obstacle->getSize().width;
-//                CULog("trap x,y %f %f", x,y);
-//                CULog("trap dims %f %f", width,height);
-                
-//                CULog("trap obst scaleHitbox call\n\t\tscale_ %f %f\n\t\tx %f\n\t\ty %f\n\t\theight %f",
-//                      scale_.x, scale_.y,
-//                      x, y,
-//                      height);
-//                CULog("trap obst position %f %f", effectAreaX, effectAreaY);
-                
-                thiefEffectArea = cugl::physics2::PolygonObstacle::alloc(tempObst->getPolygon());
-//                thiefEffectArea->setDebugScene(_debugnode);
-//                thiefEffectArea = physics2::PolygonObstacle::alloc(PolyFactory().makeRect(0,0,1,1));
-            
-            copEffectArea = cugl::physics2::PolygonObstacle::alloc(tempObst->getPolygon());
-//                copEffectArea = physics2::PolygonObstacle::alloc(PolyFactory().makeRect(0,0,1,1));
-//                copEffectArea->setDebugScene(_debugnode);
-
-
-
-//            effectAreaX = (map1.at(elem->getInt(VALUE_FIELD)).x + map1.at(elem->getInt(VALUE_FIELD)).obstacle->getSize().width/2);
-//            effectAreaY = (map1.at(elem->getInt(VALUE_FIELD)).y + map1.at(elem->getInt(VALUE_FIELD)).obstacle->getSize().height/2) + assetTexture->getHeight()*scale_.y;
-                
-                
-//          CULog("scale_ %f %f", scale_.x, scale_.y);
-
-            
-            break;
-
-        case TEXTURE_DEACTIVATION_TRIGGER:
-            deactivationTriggerTexture = assets->get<Texture>(elem->getString(VALUE_FIELD));
-            break;
-
-        case THIEF_EFFECT:
-            thiefEffect = readJsonEffect(elem);
-            break;
-
-        case THIEF_LINGER_DURATION:
-            thiefEffectLingerDur = elem->getFloat(VALUE_FIELD);
-            break;
-
-        case THIEF_LINGER_EFFECT:
-            thiefLingerEffect = readJsonEffect(elem);
-            break;
-
-        case TRIGGER_AREA:
-            triggerObjectId = elem->getInt(VALUE_FIELD);
-            break;
-
-        case TRIGGER_DEACTIVATION_AREA:
-            deactivationObjectId = elem->getInt(VALUE_FIELD);
-            break;
-
-        case NIL:
-        default:
-            break;
-        }
+        Poly2 poly = td.hitboxes[0].poly;
+        poly *= scale_ * _tileSize;
+        effectAreaPosition = scaleHitboxPosition(td.hitboxes[0], scale_, x, y, height);
+        thiefEffectArea = cugl::physics2::PolygonObstacle::alloc(poly);
+        copEffectArea = cugl::physics2::PolygonObstacle::allocWithClone(*thiefEffectArea);
+//        CULog("trap obst position %f %f", effectAreaPosition.x, effectAreaPosition.y);
     }
 
-    //CULog("1");
-
-    //shared_ptr<cugl::physics2::PolygonObstacle> thiefEffectArea = map1.at(effectObjectId).obstacle;
-    //shared_ptr<cugl::physics2::PolygonObstacle> copEffectArea = map2.at(effectObjectId).obstacle;
-    shared_ptr<cugl::physics2::PolygonObstacle> triggerArea = map1.at(triggerObjectId).obstacle;
-    shared_ptr<cugl::physics2::PolygonObstacle> deactivationArea = map2.at(deactivationObjectId).obstacle;
-
-    std::shared_ptr<cugl::Vec2> triggerPosition = make_shared<cugl::Vec2>(json->getFloat(X_FIELD)/_tileSize, _mapHeight - json->getFloat(Y_FIELD)/_tileSize);
-
+    const LevelData::Shape& triggerShape = shapes.at(data.triggerObject);
+    const LevelData::Shape& deactivationShape = shapes.at(data.deactivationObject);
+    shared_ptr<cugl::physics2::PolygonObstacle> triggerArea = cloneTrapShape(data.triggerObject);
+    shared_ptr<cugl::physics2::PolygonObstacle> deactivationArea = cloneTrapShape(data.deactivationObject);
 
-    // Create the parameters to create a trap
-
-    //std::shared_ptr<cugl::Vec2> triggerPosition = make_shared<cugl::Vec2>(center);
-    //bool copSolid = true;
-    //bool thiefSolid = false;
-    //int numUses = 1;
-    //float lingerDur = 0.3;
-    //std::shared_ptr<cugl::Affine2> thiefVelMod = make_shared<cugl::Affine2>(1, 0, 0, 1, 0, 0);
-    //std::shared_ptr<cugl::Affine2> copVelMod = make_shared<cugl::Affine2>(1, 0, 0, 1, 0, 0);
+    std::shared_ptr<cugl::Vec2> triggerPosition = make_shared<cugl::Vec2>(data.position);
 
     // Initialize a trap
 
     trap->init(trapID,
-                activated,
+                data.activated,
                 thiefEffectArea, copEffectArea,
                 triggerArea, deactivationArea,
                 triggerPosition,
-                copCollide, thiefCollide,
-                numUses,
-                copEffectLingerDur,
-                thiefEffectLingerDur,
-                copEffect,
-                thiefEffect,
-                copLingerEffect,
-                thiefLingerEffect,
-                idleActivatedAnimation,
-                idleDeactivatedAnimation,
-                sfxOn,
-                sfxKey);
-
-    //CULog("2");
+                data.copCollide, data.thiefCollide,
+                data.numUses,
+                data.copLingerDuration,
+                data.thiefLingerDuration,
+                makeEffect(data.copEffect),
+                makeEffect(data.thiefEffect),
+                makeEffect(data.copLingerEffect),
+                makeEffect(data.thiefLingerEffect),
+                data.idleActivatedAnimation,
+                data.idleDeactivatedAnimation,
+                false,
+                data.sfxKey);
     
     // Configure physics
     _world->addObstacle(thiefEffectArea);
     _world->addObstacle(copEffectArea);
     _world->addObstacle(triggerArea);
-    thiefEffectArea->setPosition(Vec2(effectAreaX, effectAreaY));
-    copEffectArea->setPosition(Vec2(effectAreaX, effectAreaY));
+    thiefEffectArea->setPosition(effectAreaPosition);
+    copEffectArea->setPosition(effectAreaPosition);
 
-    triggerArea->setPosition(Vec2(map1.at(triggerObjectId).x, map1.at(triggerObjectId).y));
-    deactivationArea->setPosition(Vec2(map2.at(deactivationObjectId).x, map2.at(deactivationObjectId).y));
+    triggerArea->setPosition(Vec2(triggerShape.x, triggerShape.y));
+    deactivationArea->setPosition(Vec2(deactivationShape.x, deactivationShape.y));
 
     deactivationArea->setSensor(true);
     triggerArea->setSensor(true);
@@ -935,9 +526,6 @@ void GameModel::initTrap(int trapID,
     copEffectArea->setSensor(true);
 
     tuple <bool, int, int, std::string> assetInfo = make_tuple(animated, anim_rows, anim_cols, assetName);
-    
-    // TODO: fix this once assets are written
-
 
     trap->setAssets(Vec2(x,y), Vec2(width,height),
                     scale, scale_, _tileSize, _worldnode, assets,
@@ -947,59 +535,14 @@ void GameModel::initTrap(int trapID,
     
     // Add the trap to the vector of traps
     _traps.push_back(trap);
-    //CULog("3");
 }
 
 /**
- * Takes a JsonValue pointing towards an Effect object and parses it
+ * Returns a trap effect built from its level data
  */
-shared_ptr<TrapModel::Effect> GameModel::readJsonEffect(shared_ptr<JsonValue> effect) {
-    std::shared_ptr<cugl::Vec2> effectVec = make_shared<cugl::Vec2>(0, 0);
-    TrapModel::TrapType effectType = TrapModel::TrapType::Moving_Platform;
-    float effectx = 0.0;
-    float effecty = 0.0;
-
-    if (effect->get(VALUE_FIELD)->children().size() > 0) {
-        switch (constantsMap[effect->get(VALUE_FIELD)->getString(TRAP_TYPE, "NULL")])
-        {
-
-        case ESCALATOR:
-            effectType = TrapModel::TrapType::Moving_Platform;
-            if (effect->get(VALUE_FIELD)->get(ESCALATOR_VELOCITY) != nullptr) {
-                effectx = effect->get(VALUE_FIELD)->get(ESCALATOR_VELOCITY)->getFloat(X_FIELD, 0);
-                effecty = effect->get(VALUE_FIELD)->get(ESCALATOR_VELOCITY)->getFloat(Y_FIELD, 0);
-            }
-            effectVec = make_shared<cugl::Vec2>(effectx, effecty);
-            break;
-
-        case TELEPORT:
-            effectType = TrapModel::TrapType::Teleport;
-            effectx = effect->get(VALUE_FIELD)->get(TELEPORT_LOCATION)->getFloat(X_FIELD, 0) / _tileSize;
-            effecty = _mapHeight - effect->get(VALUE_FIELD)->get(TELEPORT_LOCATION)->getFloat(Y_FIELD, 0) / _tileSize;
-            effectVec = make_shared<cugl::Vec2>(effectx, effecty);
-            break;
-
-        case STAIRS:
-            effectType = TrapModel::TrapType::Directional_VelMod;
-            effectx = effect->get(VALUE_FIELD)->get(STAIRCASE_VELOCITY)->getFloat(X_FIELD, 0);
-            effecty = effect->get(VALUE_FIELD)->get(STAIRCASE_VELOCITY)->getFloat(Y_FIELD, 0);
-            effectVec = make_shared<cugl::Vec2>(effectx, effecty);
-            break;
-
-        case VELOCITY_MODIFIER:
-            effectType = TrapModel::TrapType::VelMod;
-            effectx = effect->get(VALUE_FIELD)->get(SPEED_MODIFIER)->getFloat(X_FIELD, 0);
-            effecty = effect->get(VALUE_FIELD)->get(SPEED_MODIFIER)->getFloat(Y_FIELD, 0);
-            effectVec = make_shared<cugl::Vec2>(effectx, effecty);
-            break;
-
-        case NIL:
-        default:
-            break;
-        }
-    }
+shared_ptr<TrapModel::Effect> GameModel::makeEffect(const LevelData::Effect& effect) {
     shared_ptr<TrapModel::Effect> temp = make_shared<TrapModel::Effect>();
-    temp->init(effectType, effectVec);
+    temp->init(effect.type, make_shared<cugl::Vec2>(effect.vec));
     return temp;
 }
 
@@ -1012,11 +555,128 @@ void GameModel::updateTraps(float timestep) {
     }
 }
 
+/**
+ * Builds the spatial grid of obstacles and disables every obstacle
+ *
+ * Each obstacle is stored in every cell overlapped by its bounding box,
+ * padded by GRID_PADDING cells, so that a player only needs to look at
+ * the cell it is standing in.
+ */
+void GameModel::initGrid() {
+    _gridCols = max(1, (int)ceil(_mapWidth / GRID_SIZE));
+    _gridRows = max(1, (int)ceil(_mapHeight / GRID_SIZE));
+    _grid.assign(_gridCols * _gridRows, vector<int>());
+    _obstacleActive.assign(_obstacles.size(), false);
+    _obstacleStamp.assign(_obstacles.size(), 0);
+    _activeObstacles.clear();
+    _nextActiveObstacles.clear();
+    _gridFrame = 0;
+    _obstacleToggles = 0;
+    _totalObstacleToggles = 0;
+    
+    for (int ii = 0; ii < _obstacles.size(); ii++) {
+        shared_ptr<physics2::PolygonObstacle> ob = _obstacles[ii];
+        Rect bounds = ob->getPolygon().getBounds();
+        int minCol = max(0, gridColumn(bounds.getMinX() + ob->getX()) - GRID_PADDING);
+        int maxCol = min(_gridCols - 1, gridColumn(bounds.getMaxX() + ob->getX()) + GRID_PADDING);
+        int minRow = max(0, gridRow(bounds.getMinY() + ob->getY()) - GRID_PADDING);
+        int maxRow = min(_gridRows - 1, gridRow(bounds.getMaxY() + ob->getY()) + GRID_PADDING);
+        for (int row = minRow; row <= maxRow; row++) {
+            for (int col = minCol; col <= maxCol; col++) {
+                _grid[row * _gridCols + col].push_back(ii);
+            }
+        }
+        
+        // Obstacles start disabled until a player comes near them
+        ob->setEnabled(false);
+    }
+}
+
+/**
+ * Enables the obstacles that entered the players' neighborhood and disables the ones that left it
+ *
+ * Toggling a body in Box2D destroys or recreates its broadphase proxies, so
+ * obstacles that stay near (or away from) the players are never touched.
+ */
+void GameModel::updateGrid() {
+    _gridFrame++;
+    _obstacleToggles = 0;
+    _nextActiveObstacles.clear();
+    
+    // Enable everything near the players that is not already enabled
+    activateGridCell(_thief->getPosition());
+    for (auto it = _cops.begin(); it != _cops.end(); it++) {
+        activateGridCell(it->second->getPosition());
+    }
+    
+    // Disable everything that was near a player last frame but is not anymore
+    for (int ii : _activeObstacles) {
+        if (_obstacleStamp[ii] != _gridFrame) {
+            _obstacles[ii]->setEnabled(false);
+            _obstacleActive[ii] = false;
+            _obstacleToggles++;
+        }
+    }
+    
+    _activeObstacles.swap(_nextActiveObstacles);
+    _totalObstacleToggles += _obstacleToggles;
+}
+
+/**
+ * Marks every obstacle in the grid cell containing the given position as active
+ */
+void GameModel::activateGridCell(Vec2 position) {
+    const vector<int>& cell = _grid[gridRow(position.y) * _gridCols + gridColumn(position.x)];
+    for (int ii : cell) {
+        // Skip obstacles already claimed by another player this frame
+        if (_obstacleStamp[ii] == _gridFrame) continue;
+        _obstacleStamp[ii] = _gridFrame;
+        _nextActiveObstacles.push_back(ii);
+        if (!_obstacleActive[ii]) {
+            _obstacles[ii]->setEnabled(true);
+            _obstacleActive[ii] = true;
+            _obstacleToggles++;
+        }
+    }
+}
+
+/**
+ * Returns the grid column containing the given x-coordinate, clamped to the grid
+ */
+int GameModel::gridColumn(float x) const {
+    return max(0, min(_gridCols - 1, (int)floor(x / GRID_SIZE)));
+}
+
+/**
+ * Returns the grid row containing the given y-coordinate, clamped to the grid
+ */
+int GameModel::gridRow(float y) const {
+    return max(0, min(_gridRows - 1, (int)floor(y / GRID_SIZE)));
+}
+
 /**
  * Initializes the border for the game
+ *
+ * The eight map-sized blocks around the map are drawn separately, but share a single
+ * static obstacle: a ring around the map, triangulated with the map as its hole.
  */
 void GameModel::initBorder(float scale) {
     Rect bounds = _world->getBounds();
+    Rect map = Rect(bounds.origin.x, bounds.origin.y, _mapWidth, _mapHeight);
+    Rect outer = Rect(map.origin.x - _mapWidth, map.origin.y - _mapHeight, 3 * _mapWidth, 3 * _mapHeight);
+    Path2 ring(outer);
+    DelaunayTriangulator triang(ring.reverse());
+    triang.addHole(Path2(map));
+    triang.calculate();
+    
+    // Add the border to the world
+    shared_ptr<physics2::PolygonObstacle> border = physics2::PolygonObstacle::alloc(triang.getPolygon());
+    border->setBodyType(b2_staticBody);
+    border->setDebugScene(_debugnode);
+    border->setDebugColor(Color4::RED);
+    _world->addObstacle(border);
+    if (_headless) return;
+    
     for (int i = -1; i < 2; i ++) {
         for (int j = -1; j < 2; j ++) {
             // Don't put a border in the middle
@@ -1028,23 +688,15 @@ void GameModel::initBorder(float scale) {
             float width = _mapWidth;
             float height = _mapHeight;
             
-            // Create the appropriate wall and node using the rectangle polygon
+            // Add the node to the world node using the rectangle polygon
             Rect rect = Rect(x, y, width, height);
             Poly2 poly = PolyFactory(POLYFACTORY_TOLERANCE).makeRect(rect);
-            shared_ptr<physics2::PolygonObstacle> wall = physics2::PolygonObstacle::alloc(poly);
             shared_ptr<scene2::PolygonNode> node = scene2::PolygonNode::allocWithPoly(poly);
-            
-            // Add the wall to the world
-            wall->setDebugScene(_debugnode);
-            wall->setDebugColor(Color4::RED);
-            _world->addObstacle(wall);
-            
-            // Add the node to the world node
             node->setScale(scale);
             node->setColor(Color4::GRAY);
             node->setPosition((x + width / 2) * scale, (y + height / 2) * scale);
+            node->setCullable(true);
             _worldnode->addChild(node);
         }
     }
-    
 }
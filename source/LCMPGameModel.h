@@ -13,6 +13,9 @@
 #include "LCMPCopModel.h"
 #include "LCMPTrapModel.h"
 #include "LCMPObstacleModel.h"
+#include "LCMPLevelData.h"
+#include "LCMPBackdropController.h"
+#include "LCMPGeometryBaker.h"
 #include <map>
 
 class GameModel {
@@ -25,7 +28,7 @@ protected:
     std::unordered_map<int, std::shared_ptr<CopModel>> _cops;
     /** A vector of references to the traps */
     std::vector<std::shared_ptr<TrapModel>> _traps;
-    /** A vector of references to obstacles */
+    /** A vector of references to the static obstacles, one for the walls and props of each region */
     std::vector<std::shared_ptr<cugl::physics2::PolygonObstacle>> _obstacles;
     /** A vector of references to the nodes holding the map textures */
     std::vector<std::shared_ptr<cugl::scene2::PolygonNode>> _mapChunks;
@@ -39,17 +42,37 @@ protected:
     std::shared_ptr<cugl::scene2::SceneNode> _debugnode;
     /** Reference to the Box2D world */
     std::shared_ptr<cugl::physics2::ObstacleWorld> _world;
-    // Map to associate the json strings with the json enum values
-    std::map<std::string, JsonConstants> constantsMap;
-    
-    int hash(cugl::Vec2 v){
-        return hash(int(v.x),int(v.y));
-    };
-    int hash(int x, int y){
-        return 100*x+y;
-    };
-    std::map<int, std::set<std::shared_ptr<cugl::physics2::PolygonObstacle>>> obstaclesInGrid;
-    
+    /** The streaming map chunks of the backdrop */
+    BackdropController _backdrop;
+    /** The level this game was built from */
+    std::shared_ptr<LevelData> _level;
+    /** The obstacles (never added to the world) that trap areas are cloned from, by shape id */
+    std::map<int, std::shared_ptr<cugl::physics2::PolygonObstacle>> _trapShapeObstacles;
+    /** The state of every obstacle at the start of the round */
+    std::vector<cugl::physics2::BodyNetData> _snapshot;
+    
+    // Spatial grid for enabling only the obstacles near the players
+    /** The number of grid columns covering the map */
+    int _gridCols;
+    /** The number of grid rows covering the map */
+    int _gridRows;
+    /** The indices (into _obstacles) of the obstacles near each cell, stored row major */
+    std::vector<std::vector<int>> _grid;
+    /** Whether each obstacle (by index into _obstacles) is currently enabled */
+    std::vector<bool> _obstacleActive;
+    /** The last grid update in which each obstacle was near a player */
+    std::vector<unsigned int> _obstacleStamp;
+    /** The indices of the obstacles enabled by the last grid update */
+    std::vector<int> _activeObstacles;
+    /** Scratch buffer for the obstacles enabled by the current grid update */
+    std::vector<int> _nextActiveObstacles;
+    /** The number of grid updates so far (used to stamp obstacles) */
+    unsigned int _gridFrame;
+    /** The number of obstacles enabled or disabled in the last grid update */
+    int _obstacleToggles;
+    /** The number of obstacles enabled or disabled since initialization */
+    unsigned long _totalObstacleToggles;
+
     /** The width of the map in Box2D coordinates */
     float _mapWidth;
     /** The height of the map in Box2D coordinates */
@@ -58,6 +81,10 @@ protected:
     float _tileSize;
     /** A flag indicating whether the game is over */
     bool _gameover;
+    /** Whether players updated over the network are kinematic proxies */
+    bool _proxies;
+    /** Whether the game has no assets or scene graph (as for a bot client) */
+    bool _headless;
 
     /** The chosen customization skin  */
     string _skinKey;
@@ -82,10 +109,13 @@ public:
     
     /**
      * initializes a Game Model
+     *
+     * Without assets, the game is headless: it only builds the physics of the players, the
+     * walls and the prop hitboxes, so that it can be simulated without a scene graph.
      */
     bool init(std::shared_ptr<cugl::physics2::ObstacleWorld>& world,
               std::shared_ptr<cugl::scene2::SceneNode>& floornode,
-              std::shared_ptr<cugl::scene2::SceneNode>& worldnode,
+              const std::shared_ptr<cugl::scene2::SceneNode>& worldnode,
               std::shared_ptr<cugl::scene2::SceneNode>& debugnode,
               const std::shared_ptr<cugl::AssetManager>& assets,
               float scale, const std::string& file,
@@ -94,6 +124,16 @@ public:
     
 //  MARK: - Methods
     
+    /**
+     * Records the current state of the players, traps and obstacles as the start of a round
+     */
+    void snapshot();
+    
+    /**
+     * Rewinds the players, traps and obstacles to the last snapshot, in place
+     */
+    void restore();
+    
     /**
      * Returns true iff the game is over (cops won)
      */
@@ -104,6 +144,31 @@ public:
      */
     void setGameOver(bool value) { _gameover = value; }
     
+    /**
+     * Returns true iff the game has no assets or scene graph (as for a bot client)
+     */
+    bool isHeadless() const { return _headless; }
+    
+    /**
+     * Returns true iff players updated over the network are kinematic proxies
+     */
+    bool usesProxies() const { return _proxies; }
+    
+    /**
+     * Sets whether players updated over the network are kinematic proxies
+     */
+    void setProxies(bool value) { _proxies = value; }
+    
+    /**
+     * Returns the width of the map in Box2D coordinates
+     */
+    float getMapWidth() const { return _mapWidth; }
+    
+    /**
+     * Returns the height of the map in Box2D coordinates
+     */
+    float getMapHeight() const { return _mapHeight; }
+    
     /**
      * Returns a reference to the thief
      */ 
@@ -133,6 +198,11 @@ public:
      * Updates all game objects
      */
     void update(float timestep);
+
+    /**
+     * Draws the players the given fraction of the way between the last two physics steps
+     */
+    void interpolate(float alpha);
     
     /**
      * Applies an acceleration to the thief (most likely for local updates)
@@ -170,7 +240,27 @@ public:
     * deactivates a trap
     */
     void deactivateTrap(int trapID);
-    
+
+    /**
+     * Streams in the map chunks near the given view (in background node coordinates)
+     */
+    void updateBackdrop(cugl::Rect view);
+
+    /**
+     * Returns the number of obstacles enabled or disabled in the last update
+     */
+    int getObstacleToggles() const { return _obstacleToggles; }
+
+    /**
+     * Returns the number of obstacles enabled or disabled since initialization
+     */
+    unsigned long getTotalObstacleToggles() const { return _totalObstacleToggles; }
+
+    /**
+     * Returns the number of obstacles currently enabled near the players
+     */
+    int getActiveObstacleCount() const { return (int)_activeObstacles.size(); }
+
 private:
 //  MARK: - Helpers
     
@@ -178,83 +268,53 @@ private:
      * Initializes the background of the map
      */
     void initBackdrop(float scale,
-                      int rows,
-                      int cols,
                       const std::shared_ptr<cugl::AssetManager>& assets);
     
     /**
      * Initializes a thief
      */
-    void initThief(float scale,
-                   const std::shared_ptr<cugl::JsonValue>& spawn,
+    void initThief(float scale, cugl::Vec2 spawn,
                    const std::shared_ptr<cugl::AssetManager>& assets,
                    std::shared_ptr<cugl::scene2::ActionManager>& actions);
     
     /**
      * Initializes a single cop
      */
-    void initCop(int copID, float scale,
-                 const std::shared_ptr<cugl::JsonValue>& spawns,
+    void initCop(int copID, float scale, cugl::Vec2 spawn,
                  const std::shared_ptr<cugl::AssetManager>& assets,
                  std::shared_ptr<cugl::scene2::ActionManager>& actions);
     
-    struct ObstacleNode_x_Y_Gid_struct{
-        std::shared_ptr<cugl::physics2::PolygonObstacle> obstacle;
-        std::shared_ptr<cugl::scene2::PolygonNode> node;
-        float x, y;
-        int gid;
-    };
-    
-    GameModel::ObstacleNode_x_Y_Gid_struct readJsonShape(const std::shared_ptr<cugl::JsonValue>& json, float scale);
-    
-    struct TileData{
-        string assetName;
-        std::vector<std::shared_ptr<GameModel::ObstacleNode_x_Y_Gid_struct>> hitboxes;
-        bool animated = false;
-        int anim_rows = 0;
-        int anim_cols = 0;
-    };
-    
-    map<int,GameModel::TileData> buildTileDataMap(const shared_ptr<cugl::JsonValue>& propTileset, float scale);
-    
     /**
-     Places all props into the world
+     Places all props into the world, adding their hitboxes to the static geometry
      */
-    void initProps(const std::shared_ptr<cugl::JsonValue>& props,
-                   int props_firstgid,
-                   map<int,GameModel::TileData> idToTileData,
-                   const std::shared_ptr<cugl::AssetManager>& assets,
-                   float scale);
-    
+    void initProps(const std::shared_ptr<cugl::AssetManager>& assets, float scale, GeometryBaker& baker);
+
     /**
-     Places a single prop into the world
+     Returns the position of a prop's hitbox scaled to match what is seen in Tiled
      */
-    void initProp(const std::shared_ptr<cugl::JsonValue>& prop,
-                  int props_firstGid,
-                  const std::shared_ptr<cugl::JsonValue>& propTileset,
-                  const std::shared_ptr<cugl::AssetManager>& assets,
-                  float scale);
+    cugl::Vec2 scaleHitboxPosition(const LevelData::Shape& shape, cugl::Vec2 scale_,
+                                   float x, float y, float height);
 
     /**
-     Scales a prop's hitbox to match what is seen in Tiled
+     Returns a prop's hitbox in world coordinates, scaled to match what is seen in Tiled
      */
-    std::shared_ptr<cugl::physics2::PolygonObstacle> scaleHitbox(
-                                                                 std::shared_ptr<GameModel::ObstacleNode_x_Y_Gid_struct> shape, cugl::Vec2 scale_, float x, float y, float height);
+    cugl::Poly2 scaleHitbox(const LevelData::Shape& shape, cugl::Vec2 scale_,
+                            float x, float y, float height);
 
     /**
-     * Initializes a single wall
+     * Initializes the merged walls and props, as one static obstacle per region
      */
-    void initWall(const std::shared_ptr<cugl::JsonValue>& json, float scale);
+    void initStaticGeometry(const GeometryBaker& baker);
     
+    /**
+     * Returns a new obstacle for a trap shape, sharing its geometry with every other obstacle for that shape
+     */
+    std::shared_ptr<cugl::physics2::PolygonObstacle> cloneTrapShape(int shapeID);
+
     /**
      * Initializes a single trap
      */
-    void initTrap(int trapID,
-                  const std::shared_ptr<cugl::JsonValue>& json,
-                  const map<int, ObstacleNode_x_Y_Gid_struct>& map1,
-                  const map<int, ObstacleNode_x_Y_Gid_struct>& map2,
-                  const map<int, GameModel::TileData> idToTileData, const int prop_firstGid,
-                  float scale,
+    void initTrap(int trapID, const LevelData::Trap& data, float scale,
                   const std::shared_ptr<cugl::AssetManager>& assets);
 
     /**
@@ -264,15 +324,40 @@ private:
 
 
     /**
-    * Takes a JsonValue pointing towards an Effect object and parses it
+    * Returns a trap effect built from its level data
     */
-    shared_ptr<TrapModel::Effect> readJsonEffect(shared_ptr<cugl::JsonValue> effect);
+    std::shared_ptr<TrapModel::Effect> makeEffect(const LevelData::Effect& effect);
     
     /**
      * Initializes the border for the game
      */
     void initBorder(float scale);
-    
+
+    /**
+     * Builds the spatial grid of obstacles and disables every obstacle
+     */
+    void initGrid();
+
+    /**
+     * Enables the obstacles that entered the players' neighborhood and disables the ones that left it
+     */
+    void updateGrid();
+
+    /**
+     * Marks every obstacle in the grid cell containing the given position as active
+     */
+    void activateGridCell(cugl::Vec2 position);
+
+    /**
+     * Returns the grid column containing the given x-coordinate, clamped to the grid
+     */
+    int gridColumn(float x) const;
+
+    /**
+     * Returns the grid row containing the given y-coordinate, clamped to the grid
+     */
+    int gridRow(float y) const;
+
 };
 
 #endif /* __LCMP_GAME_MODEL_H__ */
@@ -28,16 +28,9 @@ using namespace std;
 /** Whether or not to show the debug node */
 #define DEBUG_ON        0
 
-/** Width of the game world in Box2d units */
-#define DEFAULT_WIDTH   32.0f
-/** Height of the game world in Box2d units */
-#define DEFAULT_HEIGHT  18.0f
 /** The default value of gravity (going down) */
 #define DEFAULT_GRAVITY 0.0f
 
-/** The amount of time that the game waits before reseting */
-#define RESET_TIME 3
-
 /** The key for the floor tile */
 #define TILE_TEXTURE    "floor"
 /** The size for the floor tile */
@@ -53,13 +46,6 @@ using namespace std;
 /** A coefficient for how much smaller the text font should be */
 #define TEXT_SCALAR         0.3f
 
-/**
- * Returns true iff o1 should appear behind o2.
- */
-bool compareNodes(shared_ptr<scene2::SceneNode> o1, shared_ptr<scene2::SceneNode> o2) {
-    return o1->getPosition().y - o1->getHeight() / 2 > o2->getPosition().y - o2->getHeight() / 2;
-}
-
 //  MARK: - Constructors
 
 /**
@@ -99,43 +85,49 @@ bool GameScene::init(const std::shared_ptr<cugl::AssetManager>& assets,
     _input.init(getBounds());
     
     // Calculate the scale
-    Rect rect(0,0,DEFAULT_WIDTH,DEFAULT_HEIGHT);
+    Rect rect(0,0,WORLD_WIDTH,WORLD_HEIGHT);
     Vec2 gravity(0,DEFAULT_GRAVITY);
     _offset = Vec2((_dimen.width-SCENE_WIDTH)/2.0f,(_dimen.height-SCENE_HEIGHT)/2.0f);
     _scale = _dimen.width == SCENE_WIDTH
         ? _dimen.width/rect.size.width
         : _dimen.height/rect.size.height;
     
-    // Initialize the world
+    // Initialize the world, whose nodes are interpolated between steps by the game instead
     _world = physics2::ObstacleWorld::alloc(rect,gravity);
+    _world->setInterpolated(false);
     
     // Add callbacks for entering/leaving collisions
     _world->activateCollisionCallbacks(true);
-    _world->onBeginContact = [this](b2Contact* contact) { _collision.beginContact(contact); };
-    _world->onEndContact = [this](b2Contact* contact) { _collision.endContact(contact); };
+    _world->onBeginContact = [this](b2Contact* contact) {
+#ifdef BENCHMARK_CONTACTS
+        _contacts.record(contact, true);
+#endif
+        _collision.beginContact(contact);
+    };
+    _world->onEndContact = [this](b2Contact* contact) {
+#ifdef BENCHMARK_CONTACTS
+        _contacts.record(contact, false);
+#endif
+        _collision.endContact(contact);
+    };
     
     // Add callback for filtering collisions
     _world->activateFilterCallbacks(true);
     _world->shouldCollide = [this](b2Fixture* f1, b2Fixture* f2) { return _collision.shouldCollide(f1, f2); };
 
-    // Initialize the floor
+    // Initialize the floor as a single quad over the repeating tile texture
     _floornode = scene2::SceneNode::alloc();
     shared_ptr<Texture> tile = _assets->get<Texture>(TILE_TEXTURE);
     float length = tile->getWidth();
     float rows = ceil(SCENE_HEIGHT / TILE_SIZE);
     float cols = ceil(SCENE_WIDTH / TILE_SIZE);
-    for (int i = -rows; i < rows * 2; i++) {
-        for (int j = -cols; j < cols * 2; j++) {
-            shared_ptr<scene2::PolygonNode> floortile = scene2::PolygonNode::allocWithTexture(tile);
-            floortile->setScale(TILE_SIZE / length);
-            floortile->setAnchor(Vec2::ANCHOR_BOTTOM_LEFT);
-            floortile->setPosition(Vec2(TILE_SIZE * j, TILE_SIZE * i));
-            _floornode->addChild(floortile);
-        }
-    }
+    shared_ptr<scene2::PolygonNode> floortiles = scene2::PolygonNode::allocWithTexture(tile, Rect(0, 0, cols * 3 * length, rows * 3 * length));
+    floortiles->setScale(TILE_SIZE / length);
+    floortiles->setAnchor(Vec2::ANCHOR_BOTTOM_LEFT);
+    floortiles->setPosition(Vec2(-TILE_SIZE * cols, -TILE_SIZE * rows));
+    _floornode->addChild(floortiles);
     _floornode->setAnchor(Vec2::ANCHOR_BOTTOM_LEFT);
     _floornode->setPosition(_offset);
-    // TODO: Tile this in a better way. This is an expensive shortcut.
     
     // Create the background node
     _backgroundnode = scene2::SceneNode::alloc();
@@ -143,7 +135,7 @@ bool GameScene::init(const std::shared_ptr<cugl::AssetManager>& assets,
     _backgroundnode->setPosition(_offset);
 
     // Create the world node
-    _worldnode = scene2::SceneNode::alloc();
+    _worldnode = DepthNode::alloc();
     _worldnode->setAnchor(Vec2::ANCHOR_BOTTOM_LEFT);
     _worldnode->setPosition(_offset);
     
@@ -166,6 +158,9 @@ bool GameScene::init(const std::shared_ptr<cugl::AssetManager>& assets,
     addChild(_debugnode);
     addChild(_uinode);
     
+    // Skip the props, traps and backdrop chunks that are off camera
+    setCulling(true);
+    
     // Set some flags
     _state = INIT;
     _quit = false;
@@ -196,9 +191,9 @@ void GameScene::dispose() {
  * @param host  Whether the player is host.
  */
 void GameScene::start(bool host, string skinKey, string levelKey) {
-    _gameTime = 0;
     _doneTime = 0;
     _isThiefWin = false;
+    _contacts.clear();
     _isHost = host;
     _audio->playSound(_assets, GAME_MUSIC, false, -1);
     _playerNumber = _network->getPlayerNumber();
@@ -208,6 +203,13 @@ void GameScene::start(bool host, string skinKey, string levelKey) {
     // Initialize the game
     _game = make_shared<GameModel>();
     _game->init(_world, _backgroundnode, _worldnode, _debugnode, _assets, _scale, levelKey, _actions, _skinKey);
+    _simulation.init(_game, _world, _network, _isHost);
+    
+    // Only the players move, so only they are re-sorted every frame
+    _worldnode->setDynamic(_game->getThief()->getNode(), true);
+    for (int i = 0; i < _game->numberOfCops(); i++) {
+        _worldnode->setDynamic(_game->getCop(i)->getNode(), true);
+    }
     
     // Set the player's names
     for (int i = 0; i < 5; i++) {
@@ -224,8 +226,9 @@ void GameScene::start(bool host, string skinKey, string levelKey) {
     _uinode->removeAllChildren();
     _ui.init(_worldnode, _uinode, _game, _font, _screenSize, _offset, _assets, _actions, _audio);
 
-    // Initialize camera position
+    // Initialize camera position (and start streaming the backdrop around it)
     initCamera();
+    updateFloor(0);
 
     // Update the state of the game
     _state = GAME;
@@ -281,34 +284,28 @@ void GameScene::setActive(bool value) {
  * Resets the game
  */
 void GameScene::reset() {
-    _gameTime = 0;
     _doneTime = 0;
     _isThiefWin = false;
-    _world->clear();
     _input.clear();
     
-    // Clear the nodes
-    _worldnode->removeAllChildren();
-    _debugnode->removeAllChildren();
-    _uinode->removeAllChildren();
+#ifdef BENCHMARK_CONTACTS
+    // Replay the contacts of the round that just ended, while its bodies still exist
+    _contacts.run(_game, BENCHMARK_REPEATS);
+#endif
+    _contacts.clear();
     
-    // Make a new game
-    _game = make_shared<GameModel>();
-    _game->init(_world, _backgroundnode, _worldnode, _debugnode, _assets, _scale, LEVEL_ONE_FILE, _actions, _skinKey);
-    
-    // Set the player's names
-    for (int i = 0; i < 5; i++) {
-        NetworkController::Player playerData = _network->getPlayer(i);
-        shared_ptr<PlayerModel> player = playerData.playerNumber == -1
-            ? (shared_ptr<PlayerModel>) _game->getThief()
-            : (shared_ptr<PlayerModel>) _game->getCop(playerData.playerNumber);
-        player->setName(playerData.username, _font);
-    }
+    // Rewind the game to the start of the round
+    _simulation.reset();
     
     // Initialize subcontrollers
+    _uinode->removeAllChildren();
     _collision.init(_game);
     _ui.init(_worldnode, _uinode, _game, _font, _screenSize, _offset, _assets, _actions, _audio);
     
+    // Initialize camera position (and start streaming the backdrop around it)
+    initCamera();
+    updateFloor(0);
+    
     // Update the state of the game
     _state = GAME;
 }
@@ -326,8 +323,8 @@ void GameScene::stateInit(float timestep) {
  * The update method for when we are in state GAME
  */
 void GameScene::stateGame(float timestep) {
-    // Keep track of time
-    _gameTime += timestep;
+    // Keep track of time, on the host clock once it is known so that every peer ends the round together
+    bool timeout = _simulation.updateClock(timestep);
     
     // Play last frame's sound effects
 //    if (_collision.didHitObstacle) {
@@ -352,9 +349,8 @@ void GameScene::stateGame(float timestep) {
     tackle.y = -tackle.y;
     
     // If time surpasses the game length, thief wins
-    if (_gameTime > GAME_LENGTH) {
-        _game->setGameOver(true);
-        if (_isHost) _network->sendGameOver();
+    if (timeout) {
+        _simulation.endRound();
         _isThiefWin = true;
         _state = DONE;
         updateUI(timestep, _isThief, movement, joystick, origin, position, _playerNumber);
@@ -371,19 +367,13 @@ void GameScene::stateGame(float timestep) {
 
 
     
-    // Update the game in these steps
-    updateLocal(timestep, movement, activate, swipe, tackle);
-    updateNetwork(timestep);
+    // Simulate the game in fixed steps, then update the view in these steps
+    _simulation.step(timestep, movement, activate, swipe, tackle);
     updateCamera(timestep);
     updateFloor(timestep);
     updateUI(timestep, _isThief, movement, joystick, origin, position, _playerNumber);
     updateOrder(timestep);
-    
-    
-    // Update the physics, then move the game nodes accordingly
     _actions->update(timestep);
-    _world->update(timestep);
-    _game->update(timestep);
     _input.clear();
     
     // Detect transition to SETTINGS
@@ -392,14 +382,7 @@ void GameScene::stateGame(float timestep) {
     }
     
     // Detect transition to DONE
-    for (int i = 0; i < _game->numberOfCops(); i++) {
-        if (_game->getCop(i)->getCaughtThief()) {
-//            _audio->playSound(_assets, THIEF_COLLISION_SFX, true, _gameTime);
-            if (_isHost) _game->setGameOver(true);
-        }
-    }
-    if (_game->isGameOver()) {
-        if (_isHost) _network->sendGameOver();
+    if (_simulation.checkGameOver()) {
         _state = DONE;
     }
 }
@@ -424,21 +407,16 @@ void GameScene::stateDone(float timestep) {
  * The update method for when we are in state SETTINGS
  */
 void GameScene::stateSettings(float timestep) {
-    // Keep track of time
-    _gameTime += timestep;
+    // Keep track of time, on the host clock once it is known so that every peer ends the round together
+    _simulation.updateClock(timestep);
 
-    // Update the game in these steps
-    updateLocal(timestep, Vec2::ZERO, false, false, Vec2::ZERO);
-    updateNetwork(timestep);
+    // Simulate the game in fixed steps, then update the view in these steps
+    _simulation.step(timestep, Vec2::ZERO, false, false, Vec2::ZERO);
     updateCamera(timestep);
     updateFloor(timestep);
     updateUI(timestep, _isThief, Vec2::ZERO, false, Vec2::ZERO, Vec2::ZERO, _playerNumber);
     updateOrder(timestep);
-
-    // Update the physics, then move the game nodes accordingly
     _actions->update(timestep);
-    _world->update(timestep);
-    _game->update(timestep);
     _input.clear();
     
     if (!_ui.isPaused()) {
@@ -452,7 +430,9 @@ void GameScene::stateSettings(float timestep) {
         
         // Do tasks that reset does that start does not
         _world->clear();
+        _contacts.clear();
         _input.clear();
+        _backgroundnode->removeAllChildren();
         _worldnode->removeAllChildren();
         _debugnode->removeAllChildren();
         _uinode->removeAllChildren();
@@ -476,86 +456,6 @@ void GameScene::initCamera() {
     _camera->update();
 }
 
-/**
- * Updates local players (own player and non-playing players)
- */
-void GameScene::updateLocal(float timestep, Vec2 movement, bool dtap,
-                            float swipe, Vec2 tackle) {
-    // Update non-playing players if host
-    if (_isHost) {
-        for (int i = 0; i < 5; i++) {
-            int copID = _network->getPlayer(i).playerNumber;
-            if (!_network->isPlayerConnected(i) && copID != -1 && copID != _playerNumber) {
-                updateCop(timestep, copID, Vec2::ZERO, false, Vec2::ZERO, dtap);
-            }
-        }
-    }
-    
-    // Update own player
-    if (_isThief) updateThief(timestep, movement, dtap);
-    else updateCop(timestep, _playerNumber, movement, swipe, tackle, dtap);
-    
-}
-
-/**
- * Updates and networks the thief and any actions it can perform
- */
-void GameScene::updateThief(float timestep, Vec2 movement, bool dtap) {
-    // Update and network thief movement
-    _game->updateThief(movement);
-    _network->sendThiefMovement(_game, movement);
-    
-    // Activate and network traps
-    int trapID = _game->getThief()->trapActivationFlag;
-    if (dtap && trapID != -1) {
-        _game->activateTrap(trapID);
-        _network->sendTrapActivation(trapID);
-    }
-}
-
-/**
- * Updates and networks a cop and any actions it can perform
- */
-void GameScene::updateCop(float timestep, int copID, Vec2 movement, bool swipe, Vec2 tackle, bool dtap) {
-    // Get some reusable variables
-    shared_ptr<CopModel> cop = _game->getCop(copID);
-    Vec2 thiefPosition = _game->getThief()->getPosition();
-
-    int trapID = cop->trapDeactivationFlag;
-    if (dtap && trapID != -1) {
-        _game->deactivateTrap(trapID);
-        //TODO: JUDE PLEASE FIX THIS NETWORK THING IDK HOW - Tony
-        //_network->sendTrapActivation(trapID);
-    }
-    
-    // Play tackling sounds
-//    if (cop->didTackle) {
-//        _audio->playSound(_assets, TACKLE_SFX, true, _gameTime);
-//        cop->didTackle = false;
-//    }
-//    if (cop->didLand) {
-//        _audio->playSound(_assets, LAND_SFX, true, _gameTime);
-//        cop->didLand = false;
-//    }
-    
-    // Update, animate, and network cop movement
-    _game->updateCop(movement, thiefPosition, copID, timestep);
-    _network->sendCopMovement(_game, movement, copID);
-    
-    // Attempt tackle if appropriate
-    if (swipe && !cop->getTackling()) {
-        cop->attemptTackle(thiefPosition, tackle);
-    }
-}
-
-/**
- * Updates based on data received over the network
- */
-void GameScene::updateNetwork(float timestep) {
-    _network->update(_game);
-    // TODO: Add stuff here for migrating host, connection status, etc.
-}
-
 /**
  * Updates camera based on the position of the controlled player
  */
@@ -579,6 +479,10 @@ void GameScene::updateFloor(float timestep) {
     Vec2 chunk = Vec2(floor(_camera->getPosition().x / SCENE_WIDTH),
                       floor(_camera->getPosition().y / SCENE_HEIGHT));
     _floornode->setPosition(chunk * Vec2(SCENE_WIDTH, SCENE_HEIGHT));
+    
+    // Stream in the backdrop around the camera
+    Vec2 center = Vec2(_camera->getPosition()) - _backgroundnode->getPosition();
+    _game->updateBackdrop(Rect(center - Vec2(getSize()) / 2, getSize()));
 }
 
 /**
@@ -586,7 +490,7 @@ void GameScene::updateFloor(float timestep) {
  */
 void GameScene::updateUI(float timestep, bool isThief, Vec2 movement,
                          bool didPress, Vec2 origin, Vec2 position, int playerNumber) {
-    _ui.update(timestep, isThief, movement, didPress, origin, position, playerNumber, _gameTime, _isThiefWin);
+    _ui.update(timestep, isThief, movement, didPress, origin, position, playerNumber, _simulation.getGameTime(), _isThiefWin);
     _uinode->setPosition(_camera->getPosition() - Vec2(SCENE_WIDTH, SCENE_HEIGHT)/2 - _offset);
 }
 
@@ -594,9 +498,5 @@ void GameScene::updateUI(float timestep, bool isThief, Vec2 movement,
  * Updates the ordering of the nodes in the World Node
  */
 void GameScene::updateOrder(float timestep) {
-    std::vector<std::shared_ptr<scene2::SceneNode>> children = _worldnode->getChildren();
-    sort(children.begin(), children.end(), compareNodes);
-    _worldnode->removeAllChildren();
-    for (std::shared_ptr<scene2::SceneNode> child : children) _worldnode->addChild(child);
-    // TODO: Figure out how to do this using OrderedNode, this is __very__ bad
+    _worldnode->update();
 }
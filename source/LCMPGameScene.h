@@ -15,9 +15,12 @@
 #include "LCMPNetworkController.h"
 #include "LCMPAudioController.h"
 #include "LCMPCollisionController.h"
+#include "LCMPContactBenchmark.h"
+#include "LCMPSimulationController.h"
 #include "LCMPInputController.h"
 #include "LCMPUIController.h"
 #include "LCMPGameModel.h"
+#include "LCMPDepthNode.h"
 
 /**
  * This class is the primary gameplay controller for the demo.
@@ -57,6 +60,10 @@ protected:
     std::shared_ptr<AudioController> _audio;
     /** The Collision Controller instance */
     CollisionController _collision;
+    /** The Simulation Controller instance */
+    SimulationController _simulation;
+    /** The contacts of the current round (only recorded with BENCHMARK_CONTACTS) */
+    ContactBenchmark _contacts;
     /** The Input Controller instance */
     InputController _input;
     /** The UI Controller instance */
@@ -71,8 +78,8 @@ protected:
     std::shared_ptr<cugl::scene2::SceneNode> _floornode;
     /** Reference to the background node of the scene graph */
     std::shared_ptr<cugl::scene2::SceneNode> _backgroundnode;
-    /** Reference to the physics node of the scene graph */
-    std::shared_ptr<cugl::scene2::SceneNode> _worldnode;
+    /** Reference to the physics node of the scene graph (sorted by depth) */
+    std::shared_ptr<DepthNode> _worldnode;
     /** Reference to the debug node of the scene graph */
     std::shared_ptr<cugl::scene2::SceneNode> _debugnode;
     /** Reference to the ui node of the scene graph */
@@ -97,8 +104,6 @@ protected:
     float _scale;
     
     // Timing
-    /** The time for the state GAME */
-    float _gameTime;
     /** The time for the state DONE */
     float _doneTime;
     /** The last time the cop tackled */
@@ -246,27 +251,6 @@ private:
     
 //  MARK: - Helpers
     
-    /**
-     * Updates local players (own player and non-playing players)
-     */
-    void updateLocal(float timestep, cugl::Vec2 movement, bool dtap,
-                     float swipe, cugl::Vec2 tackle);
-    
-    /**
-     * Updates and networks the thief and any actions it can perform
-     */
-    void updateThief(float timestep, cugl::Vec2 movement, bool activate);
-    
-    /**
-     * Updates and networks a cop and any actions it can perform
-     */
-    void updateCop(float timestep, int copID, cugl::Vec2 movement, bool swipe, cugl::Vec2 tackle, bool dtap);
-    
-    /**
-     * Updates based on data received over the network
-     */
-    void updateNetwork(float timestep);
-    
     /**
      * Sets camera position at the start of the game.
      */
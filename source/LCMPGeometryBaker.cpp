@@ -0,0 +1,154 @@
+//
+//  LCMPGeometryBaker.cpp
+//  Low Control Mall Patrol
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#include "LCMPGeometryBaker.h"
+
+/** The number of fixed point units per world unit given to Clipper */
+#define BAKE_RESOLUTION     1024.0
+
+using namespace cugl;
+using namespace std;
+
+//  MARK: - Constructors
+
+/**
+ * Initializes a Geometry Baker for a map of the given size
+ */
+bool GeometryBaker::init(Size size, float regionSize) {
+    _regionSize = regionSize;
+    _cols = max(1, (int)ceil(size.width / regionSize));
+    _rows = max(1, (int)ceil(size.height / regionSize));
+    _bounds = Rect(Vec2::ZERO, size);
+    _regions.assign(_cols * _rows, ClipperLib::Paths());
+    return true;
+}
+
+//  MARK: - Methods
+
+/**
+ * Adds the triangles of a polygon, moved by the given offset
+ *
+ * Each triangle is stored in every region its bounding box overlaps, wound the same way
+ * as the others so that overlapping triangles are unioned rather than cancelled.
+ */
+void GeometryBaker::add(const Poly2& poly, Vec2 offset) {
+    Rect bounds = poly.getBounds();
+    bounds.origin += offset;
+    _bounds.merge(bounds);
+
+    for (size_t ii = 0; ii + 2 < poly.indices.size(); ii += 3) {
+        ClipperLib::Path triangle;
+        Vec2 lower = poly.vertices[poly.indices[ii]] + offset;
+        Vec2 upper = lower;
+        for (int jj = 0; jj < 3; jj++) {
+            Vec2 vertex = poly.vertices[poly.indices[ii + jj]] + offset;
+            triangle << ClipperLib::IntPoint((ClipperLib::cInt)round(vertex.x * BAKE_RESOLUTION),
+                                             (ClipperLib::cInt)round(vertex.y * BAKE_RESOLUTION));
+            lower.set(min(lower.x, vertex.x), min(lower.y, vertex.y));
+            upper.set(max(upper.x, vertex.x), max(upper.y, vertex.y));
+        }
+        if (!ClipperLib::Orientation(triangle)) ClipperLib::ReversePath(triangle);
+
+        int minCol = max(0, (int)floor(lower.x / _regionSize));
+        int maxCol = min(_cols - 1, (int)floor(upper.x / _regionSize));
+        int minRow = max(0, (int)floor(lower.y / _regionSize));
+        int maxRow = min(_rows - 1, (int)floor(upper.y / _regionSize));
+        for (int row = minRow; row <= maxRow; row++) {
+            for (int col = minCol; col <= maxCol; col++) {
+                _regions[row * _cols + col].push_back(triangle);
+            }
+        }
+    }
+}
+
+/**
+ * Returns the merged geometry of each region that has any, in world coordinates
+ *
+ * Intersecting a region's triangles with its rectangle (filling with the nonzero rule)
+ * unions them and clips the result in one pass.
+ */
+vector<Poly2> GeometryBaker::bake() const {
+    vector<Poly2> result;
+    for (int row = 0; row < _rows; row++) {
+        for (int col = 0; col < _cols; col++) {
+            const ClipperLib::Paths& triangles = _regions[row * _cols + col];
+            if (triangles.empty()) continue;
+
+            ClipperLib::Clipper clipper;
+            clipper.AddPaths(triangles, ClipperLib::ptSubject, true);
+            clipper.AddPath(regionPath(col, row), ClipperLib::ptClip, true);
+            ClipperLib::PolyTree solution;
+            clipper.Execute(ClipperLib::ctIntersection, solution,
+                            ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+
+            Poly2 poly;
+            for (auto it = solution.Childs.begin(); it != solution.Childs.end(); ++it) {
+                triangulate(*it, poly);
+            }
+            if (!poly.indices.empty()) result.push_back(poly);
+        }
+    }
+    return result;
+}
+
+//  MARK: - Helpers
+
+/**
+ * Returns the rectangle of a region, in fixed point, stretched past the map at the edges
+ *
+ * Shapes that hang off the map are kept whole by the regions along its edges.
+ */
+ClipperLib::Path GeometryBaker::regionPath(int col, int row) const {
+    float left = col == 0 ? _bounds.getMinX() : col * _regionSize;
+    float right = col == _cols - 1 ? _bounds.getMaxX() : (col + 1) * _regionSize;
+    float bottom = row == 0 ? _bounds.getMinY() : row * _regionSize;
+    float top = row == _rows - 1 ? _bounds.getMaxY() : (row + 1) * _regionSize;
+
+    ClipperLib::Path path;
+    path << ClipperLib::IntPoint((ClipperLib::cInt)round(left * BAKE_RESOLUTION),
+                                 (ClipperLib::cInt)round(bottom * BAKE_RESOLUTION));
+    path << ClipperLib::IntPoint((ClipperLib::cInt)round(right * BAKE_RESOLUTION),
+                                 (ClipperLib::cInt)round(bottom * BAKE_RESOLUTION));
+    path << ClipperLib::IntPoint((ClipperLib::cInt)round(right * BAKE_RESOLUTION),
+                                 (ClipperLib::cInt)round(top * BAKE_RESOLUTION));
+    path << ClipperLib::IntPoint((ClipperLib::cInt)round(left * BAKE_RESOLUTION),
+                                 (ClipperLib::cInt)round(top * BAKE_RESOLUTION));
+    return path;
+}
+
+/**
+ * Triangulates an outer polygon of a Clipper solution (with its holes) into the buffer
+ *
+ * This follows ComplexExtruder: the children of an outer polygon are its holes, and
+ * their children are outer polygons again (such as a pillar inside a ring of walls).
+ */
+void GeometryBaker::triangulate(const ClipperLib::PolyNode* node, Poly2& buffer) const {
+    Path2 path;
+    for (auto it = node->Contour.begin(); it != node->Contour.end(); ++it) {
+        path.vertices.push_back(Vec2((float)(it->X / BAKE_RESOLUTION), (float)(it->Y / BAKE_RESOLUTION)));
+    }
+    path.closed = true;
+
+    DelaunayTriangulator triang(path);
+    for (auto it = node->Childs.begin(); it != node->Childs.end(); ++it) {
+        Path2 hole;
+        for (auto jt = (*it)->Contour.begin(); jt != (*it)->Contour.end(); ++jt) {
+            hole.vertices.push_back(Vec2((float)(jt->X / BAKE_RESOLUTION), (float)(jt->Y / BAKE_RESOLUTION)));
+        }
+        hole.closed = true;
+        triang.addHole(hole);
+    }
+    triang.calculate();
+    triang.getPolygon(&buffer);
+
+    for (auto it = node->Childs.begin(); it != node->Childs.end(); ++it) {
+        for (auto jt = (*it)->Childs.begin(); jt != (*it)->Childs.end(); ++jt) {
+            triangulate(*jt, buffer);
+        }
+    }
+}
@@ -0,0 +1,75 @@
+//
+//  LCMPGeometryBaker.h
+//  Low Control Mall Patrol
+//
+//  This class merges the static collision geometry of a level (walls and prop
+//  hitboxes) into a few polygons. The map is divided into square regions, and
+//  the shapes overlapping each region are unioned with Clipper, clipped to the
+//  region, and triangulated again. Each region then needs a single static body,
+//  and overlapping shapes no longer add fixtures (or contacts) of their own.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#ifndef __LCMP_GEOMETRY_BAKER_H__
+#define __LCMP_GEOMETRY_BAKER_H__
+#include <cugl/cugl.h>
+#include <clipper/clipper.hpp>
+
+class GeometryBaker {
+protected:
+//  MARK: - Properties
+
+    /** The length (in world units) of the side of a region */
+    float _regionSize;
+    /** The number of region columns covering the map */
+    int _cols;
+    /** The number of region rows covering the map */
+    int _rows;
+    /** The bounds of every shape added, which the edge regions are stretched to */
+    cugl::Rect _bounds;
+    /** The triangles overlapping each region, in fixed point, stored row major */
+    std::vector<ClipperLib::Paths> _regions;
+
+public:
+//  MARK: - Constructors
+
+    /**
+     * Constructs a Geometry Baker
+     */
+    GeometryBaker() : _regionSize(0), _cols(0), _rows(0) {}
+
+    /**
+     * Initializes a Geometry Baker for a map of the given size
+     */
+    bool init(cugl::Size size, float regionSize);
+
+//  MARK: - Methods
+
+    /**
+     * Adds the triangles of a polygon, moved by the given offset
+     */
+    void add(const cugl::Poly2& poly, cugl::Vec2 offset);
+
+    /**
+     * Returns the merged geometry of each region that has any, in world coordinates
+     */
+    std::vector<cugl::Poly2> bake() const;
+
+private:
+//  MARK: - Helpers
+
+    /**
+     * Returns the rectangle of a region, in fixed point, stretched past the map at the edges
+     */
+    ClipperLib::Path regionPath(int col, int row) const;
+
+    /**
+     * Triangulates an outer polygon of a Clipper solution (with its holes) into the buffer
+     */
+    void triangulate(const ClipperLib::PolyNode* node, cugl::Poly2& buffer) const;
+
+};
+
+#endif /* __LCMP_GEOMETRY_BAKER_H__ */
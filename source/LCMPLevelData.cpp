@@ -0,0 +1,696 @@
+//
+//  LCMPLevelData.cpp
+//  Low Control Mall Patrol
+//
+//  Author: Kevin Games
+//  Version: 4/26/22
+//
+
+#include "LCMPLevelData.h"
+
+/** The offset basis of the 32 bit FNV-1a hash */
+#define FNV_OFFSET      2166136261u
+/** The prime of the 32 bit FNV-1a hash */
+#define FNV_PRIME       16777619u
+
+using namespace cugl;
+
+//  MARK: - Serialization
+
+/**
+ * Returns the text of an asset, or the empty string if it cannot be read
+ */
+static string readText(const string& file) {
+    shared_ptr<TextReader> reader = TextReader::allocWithAsset(file);
+    if (reader == nullptr) return "";
+    string text = reader->readAll();
+    reader->close();
+    return text;
+}
+
+/**
+ * Reads a length-prefixed string from a compiled level
+ *
+ * The characters are read one at a time, as BinaryReader::read does not refill
+ * its buffer, and hangs on a string that crosses the end of the buffer.
+ */
+static string readString(const shared_ptr<BinaryReader>& reader) {
+    Uint32 length = reader->readUint32();
+    string result;
+    result.reserve(length);
+    for (Uint32 ii = 0; ii < length; ii++) result.push_back(reader->readChar());
+    return result;
+}
+
+/**
+ * Writes a length-prefixed string to a compiled level
+ */
+static void writeString(const shared_ptr<BinaryWriter>& writer, const string& value) {
+    writer->writeUint32((Uint32)value.size());
+    if (!value.empty()) writer->write(value.data(), value.size());
+}
+
+/**
+ * Reads a triangulated shape from a compiled level
+ */
+static LevelData::Shape readShape(const shared_ptr<BinaryReader>& reader) {
+    LevelData::Shape shape;
+    shape.x = reader->readFloat();
+    shape.y = reader->readFloat();
+    shape.gid = reader->readSint32();
+
+    Uint32 vertices = reader->readUint32();
+    shape.poly.vertices.reserve(vertices);
+    for (Uint32 ii = 0; ii < vertices; ii++) {
+        float x = reader->readFloat();
+        float y = reader->readFloat();
+        shape.poly.vertices.push_back(Vec2(x, y));
+    }
+
+    Uint32 indices = reader->readUint32();
+    shape.poly.indices.reserve(indices);
+    for (Uint32 ii = 0; ii < indices; ii++) {
+        shape.poly.indices.push_back(reader->readUint32());
+    }
+    return shape;
+}
+
+/**
+ * Writes a triangulated shape to a compiled level
+ */
+static void writeShape(const shared_ptr<BinaryWriter>& writer, const LevelData::Shape& shape) {
+    writer->writeFloat(shape.x);
+    writer->writeFloat(shape.y);
+    writer->writeSint32(shape.gid);
+
+    writer->writeUint32((Uint32)shape.poly.vertices.size());
+    for (const Vec2& vertex : shape.poly.vertices) {
+        writer->writeFloat(vertex.x);
+        writer->writeFloat(vertex.y);
+    }
+
+    writer->writeUint32((Uint32)shape.poly.indices.size());
+    for (Uint32 index : shape.poly.indices) {
+        writer->writeUint32(index);
+    }
+}
+
+/**
+ * Reads a trap effect from a compiled level
+ */
+static LevelData::Effect readEffect(const shared_ptr<BinaryReader>& reader) {
+    LevelData::Effect effect;
+    effect.type = (TrapModel::TrapType)reader->readByte();
+    effect.vec.x = reader->readFloat();
+    effect.vec.y = reader->readFloat();
+    return effect;
+}
+
+/**
+ * Writes a trap effect to a compiled level
+ */
+static void writeEffect(const shared_ptr<BinaryWriter>& writer, const LevelData::Effect& effect) {
+    writer->writeUint8((Uint8)effect.type);
+    writer->writeFloat(effect.vec.x);
+    writer->writeFloat(effect.vec.y);
+}
+
+//  MARK: - Constructors
+
+/**
+ * Disposes of all resources in this instance of Level Data
+ */
+void LevelData::dispose() {
+    _copSpawns.clear();
+    _walls.clear();
+    _tiles.clear();
+    _props.clear();
+    _trapShapes.clear();
+    _traps.clear();
+    _constants.clear();
+}
+
+/**
+ * Initializes a Level Data from a Tiled map and the props tileset
+ */
+bool LevelData::initWithJson(const shared_ptr<JsonValue>& map,
+                             const shared_ptr<JsonValue>& tileset) {
+    if (map == nullptr || tileset == nullptr) return false;
+
+    _mapWidth = map->getFloat(WIDTH_FIELD);
+    _mapHeight = map->getFloat(HEIGHT_FIELD);
+    _tileSize = map->getFloat(T_SIZE_FIELD);
+
+    // Init the map that converts Json Strings into Json Values
+    _constants["activated"] = ACTIVATED;
+    _constants["collisionSound"] = COLLISION_SOUND;
+    _constants["copCollide"] = COP_COLLIDE;
+    _constants["copEffect"] = COP_EFFECT;
+    _constants["copLingerDuration"] = COP_LINGER_DURATION;
+    _constants["copLingerEffect"] = COP_LINGER_EFFECT;
+    _constants["effectArea"] = EFFECT_AREA;
+    _constants["idleActivatedAnimation"] = IDLE_ACTIVATED_ANIMATION;
+    _constants["idleDeactivatedAnimation"] = IDLE_DEACTIVATED_ANIMATION;
+    _constants["numUsages"] = NUM_USAGES;
+    _constants["textureActivationTrigger"] = TEXTURE_ACTIVATION_TRIGGER;
+    _constants["textureAsset"] = TEXTURE_ASSET;
+    _constants["textureDeactivationTrigger"] = TEXTURE_DEACTIVATION_TRIGGER;
+    _constants["thiefCollide"] = THIEF_COLLIDE;
+    _constants["thiefEffect"] = THIEF_EFFECT;
+    _constants["thiefLingerDuration"] = THIEF_LINGER_DURATION;
+    _constants["thiefLingerEffect"] = THIEF_LINGER_EFFECT;
+    _constants["triggerArea"] = TRIGGER_AREA;
+    _constants["triggerDeactivationArea"] = TRIGGER_DEACTIVATION_AREA;
+
+    _constants["Escalator"] = ESCALATOR;
+    _constants["Teleport"] = TELEPORT;
+    _constants["Stairs"] = STAIRS;
+    _constants["Velocity Modifier"] = VELOCITY_MODIFIER;
+
+    _constants["NULL"] = NIL;
+
+    readJsonTiles(tileset);
+
+    shared_ptr<JsonValue> layers = map->get(LAYERS_FIELD);
+    shared_ptr<JsonValue> props = layers->get(PROPS_FIELD)->get(OBJECTS_FIELD);
+    shared_ptr<JsonValue> walls = layers->get(WALLS_FIELD)->get(OBJECTS_FIELD);
+    shared_ptr<JsonValue> copsSpawn = layers->get(COPS_FIELD)->get(OBJECTS_FIELD);
+    shared_ptr<JsonValue> thiefSpawn = layers->get(THIEF_FIELD)->get(OBJECTS_FIELD);
+    shared_ptr<JsonValue> traps = layers->get(TRAPS_FIELD)->get(OBJECTS_FIELD);
+
+    // Spawn locations
+    _thiefSpawn = Vec2(thiefSpawn->get(0)->getFloat(X_FIELD) / _tileSize,
+                       _mapHeight - thiefSpawn->get(0)->getFloat(Y_FIELD) / _tileSize);
+    for (int i = 0; i < copsSpawn->size(); i++) {
+        shared_ptr<JsonValue> spawn = copsSpawn->get(i);
+        _copSpawns.push_back(Vec2(spawn->getFloat(X_FIELD) / _tileSize,
+                                  _mapHeight - spawn->getFloat(Y_FIELD) / _tileSize));
+    }
+
+    // Walls
+    for (int i = 0; i < walls->size(); i++) _walls.push_back(readJsonShape(walls->get(i)));
+
+    // Props
+    shared_ptr<JsonValue> tilesets = map->get("tilesets");
+    for (int i = 0; i < tilesets->size(); i++) {
+        if (tilesets->get(i)->getString("source") == PROPS_TILESET) {
+            _propFirstGid = tilesets->get(i)->getInt("firstgid");
+            break;
+        }
+    }
+    if (_propFirstGid > 0) {
+        for (int i = 0; i < props->size(); i++) {
+            shared_ptr<JsonValue> prop = props->get(i);
+            int gid = prop->getInt(GID_FIELD);
+            //TODO: incorporate rotation/reflection using tiled flags
+            gid &= CLEAR_FLAGS_FILTER;
+
+            Prop p;
+            p.tile = gid - _propFirstGid;
+            p.x = prop->getFloat(X_FIELD) / _tileSize;
+            p.y = _mapHeight - prop->getFloat(Y_FIELD) / _tileSize;
+            p.width = prop->getFloat(WIDTH_FIELD) / _tileSize;
+            p.height = prop->getFloat(HEIGHT_FIELD) / _tileSize;
+            _props.push_back(p);
+        }
+    }
+
+    // Traps are points, everything else in the layer is a shape referenced by a trap
+    for (int i = 0; i < traps->size(); i++) {
+        shared_ptr<JsonValue> trap = traps->get(i);
+        if (trap->getBool(POINT_FIELD)) {
+            _traps.push_back(readJsonTrap(trap));
+        } else {
+            _trapShapes[trap->getInt(ID_FIELD)] = readJsonShape(trap);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Initializes a Level Data from a compiled binary level
+ *
+ * Returns false if the level was compiled with a different format version,
+ * so that the caller can fall back to the Tiled map. The caller must also
+ * compare the source hash, to check that the level is not out of date.
+ */
+bool LevelData::initWithBinary(const shared_ptr<BinaryReader>& reader) {
+    if (reader == nullptr || !reader->ready(8)) return false;
+    if (reader->readUint32() != LEVEL_MAGIC) return false;
+    if (reader->readUint32() != LEVEL_VERSION) return false;
+    _sourceHash = reader->readUint32();
+
+    _mapWidth = reader->readFloat();
+    _mapHeight = reader->readFloat();
+    _tileSize = reader->readFloat();
+    _propFirstGid = reader->readSint32();
+
+    _thiefSpawn.x = reader->readFloat();
+    _thiefSpawn.y = reader->readFloat();
+    Uint32 count = reader->readUint32();
+    for (Uint32 i = 0; i < count; i++) {
+        float x = reader->readFloat();
+        float y = reader->readFloat();
+        _copSpawns.push_back(Vec2(x, y));
+    }
+
+    count = reader->readUint32();
+    _walls.reserve(count);
+    for (Uint32 i = 0; i < count; i++) _walls.push_back(readShape(reader));
+
+    count = reader->readUint32();
+    for (Uint32 i = 0; i < count; i++) {
+        int id = reader->readSint32();
+        Tile& tile = _tiles[id];
+        tile.assetName = readString(reader);
+        tile.imageWidth = reader->readFloat();
+        tile.imageHeight = reader->readFloat();
+        tile.animated = reader->readByte() != 0;
+        tile.animRows = reader->readSint32();
+        tile.animCols = reader->readSint32();
+        Uint32 hitboxes = reader->readUint32();
+        for (Uint32 j = 0; j < hitboxes; j++) tile.hitboxes.push_back(readShape(reader));
+    }
+
+    count = reader->readUint32();
+    _props.reserve(count);
+    for (Uint32 i = 0; i < count; i++) {
+        Prop p;
+        p.tile = reader->readSint32();
+        p.x = reader->readFloat();
+        p.y = reader->readFloat();
+        p.width = reader->readFloat();
+        p.height = reader->readFloat();
+        _props.push_back(p);
+    }
+
+    count = reader->readUint32();
+    for (Uint32 i = 0; i < count; i++) {
+        int id = reader->readSint32();
+        _trapShapes[id] = readShape(reader);
+    }
+
+    count = reader->readUint32();
+    _traps.reserve(count);
+    for (Uint32 i = 0; i < count; i++) {
+        Trap t;
+        t.position.x = reader->readFloat();
+        t.position.y = reader->readFloat();
+        t.activated = reader->readByte() != 0;
+        t.copCollide = reader->readByte() != 0;
+        t.thiefCollide = reader->readByte() != 0;
+        t.idleActivatedAnimation = reader->readByte() != 0;
+        t.idleDeactivatedAnimation = reader->readByte() != 0;
+        t.numUses = reader->readSint32();
+        t.copLingerDuration = reader->readFloat();
+        t.thiefLingerDuration = reader->readFloat();
+        t.sfxKey = readString(reader);
+        t.activationTexture = readString(reader);
+        t.deactivationTexture = readString(reader);
+        t.textureObject = reader->readSint32();
+        t.triggerObject = reader->readSint32();
+        t.deactivationObject = reader->readSint32();
+        t.copEffect = readEffect(reader);
+        t.thiefEffect = readEffect(reader);
+        t.copLingerEffect = readEffect(reader);
+        t.thiefLingerEffect = readEffect(reader);
+        _traps.push_back(t);
+    }
+
+    return true;
+}
+
+/**
+ * Returns the level for the given Tiled map asset.
+ *
+ * This loads the compiled level next to the map (same name, with the
+ * extension LEVEL_EXTENSION) if there is one that was compiled from the
+ * current map and props tileset, and otherwise falls back to parsing them.
+ * A compiled level that does not match is logged, as it must be recompiled.
+ */
+shared_ptr<LevelData> LevelData::load(const string& file) {
+    string map = readText(file);
+    string tileset = readText(PROPS_FILE);
+    if (map.empty() || tileset.empty()) return nullptr;
+    Uint32 hash = hashSource(map, tileset);
+
+    shared_ptr<BinaryReader> reader = BinaryReader::allocWithAsset(getCompiledPath(file));
+    if (reader != nullptr) {
+        shared_ptr<LevelData> level = allocWithBinary(reader);
+        reader->close();
+        if (level != nullptr && level->_sourceHash == hash) return level;
+        CULogError("Compiled level for %s is out of date, reading the Tiled map instead", file.c_str());
+    }
+
+    shared_ptr<LevelData> level = allocWithJson(JsonValue::allocWithJson(map), JsonValue::allocWithJson(tileset));
+    if (level != nullptr) level->_sourceHash = hash;
+    return level;
+}
+
+/**
+ * Compiles a Tiled map and the props tileset into a binary level.
+ *
+ * The Tiled map is an asset path, while the destination is an absolute
+ * path (typically in the save directory). Copy the result next to the
+ * map in the assets folder to ship it.
+ */
+bool LevelData::compile(const string& file, const string& destination) {
+    string map = readText(file);
+    string tileset = readText(PROPS_FILE);
+    if (map.empty() || tileset.empty()) return false;
+
+    shared_ptr<LevelData> level = allocWithJson(JsonValue::allocWithJson(map), JsonValue::allocWithJson(tileset));
+    shared_ptr<BinaryWriter> writer = BinaryWriter::alloc(destination);
+    if (level == nullptr || writer == nullptr) return false;
+
+    level->_sourceHash = hashSource(map, tileset);
+    level->write(writer);
+    writer->close();
+    return true;
+}
+
+/**
+ * Returns the asset path of the compiled level for a Tiled map
+ */
+string LevelData::getCompiledPath(const string& file) {
+    size_t dot = file.find_last_of('.');
+    size_t slash = file.find_last_of('/');
+    if (dot == string::npos || (slash != string::npos && dot < slash)) {
+        return file + LEVEL_EXTENSION;
+    }
+    return file.substr(0, dot) + LEVEL_EXTENSION;
+}
+
+/**
+ * Returns the hash of the text of a Tiled map and the props tileset
+ *
+ * This is a 32 bit FNV-1a hash. Carriage returns are skipped, so that a
+ * checkout with Windows line endings matches the compiled levels.
+ */
+Uint32 LevelData::hashSource(const string& map, const string& tileset) {
+    Uint32 hash = FNV_OFFSET;
+    for (const string* text : { &map, &tileset }) {
+        for (char c : *text) {
+            if (c == '\r') continue;
+            hash = (hash ^ (Uint8)c) * FNV_PRIME;
+        }
+    }
+    return hash;
+}
+
+//  MARK: - Methods
+
+/**
+ * Writes this level in the compiled binary format
+ */
+void LevelData::write(const shared_ptr<BinaryWriter>& writer) const {
+    writer->writeUint32(LEVEL_MAGIC);
+    writer->writeUint32(LEVEL_VERSION);
+    writer->writeUint32(_sourceHash);
+
+    writer->writeFloat(_mapWidth);
+    writer->writeFloat(_mapHeight);
+    writer->writeFloat(_tileSize);
+    writer->writeSint32(_propFirstGid);
+
+    writer->writeFloat(_thiefSpawn.x);
+    writer->writeFloat(_thiefSpawn.y);
+    writer->writeUint32((Uint32)_copSpawns.size());
+    for (const Vec2& spawn : _copSpawns) {
+        writer->writeFloat(spawn.x);
+        writer->writeFloat(spawn.y);
+    }
+
+    writer->writeUint32((Uint32)_walls.size());
+    for (const Shape& wall : _walls) writeShape(writer, wall);
+
+    writer->writeUint32((Uint32)_tiles.size());
+    for (auto it = _tiles.begin(); it != _tiles.end(); it++) {
+        writer->writeSint32(it->first);
+        writeString(writer, it->second.assetName);
+        writer->writeFloat(it->second.imageWidth);
+        writer->writeFloat(it->second.imageHeight);
+        writer->writeUint8(it->second.animated ? 1 : 0);
+        writer->writeSint32(it->second.animRows);
+        writer->writeSint32(it->second.animCols);
+        writer->writeUint32((Uint32)it->second.hitboxes.size());
+        for (const Shape& hitbox : it->second.hitboxes) writeShape(writer, hitbox);
+    }
+
+    writer->writeUint32((Uint32)_props.size());
+    for (const Prop& p : _props) {
+        writer->writeSint32(p.tile);
+        writer->writeFloat(p.x);
+        writer->writeFloat(p.y);
+        writer->writeFloat(p.width);
+        writer->writeFloat(p.height);
+    }
+
+    writer->writeUint32((Uint32)_trapShapes.size());
+    for (auto it = _trapShapes.begin(); it != _trapShapes.end(); it++) {
+        writer->writeSint32(it->first);
+        writeShape(writer, it->second);
+    }
+
+    writer->writeUint32((Uint32)_traps.size());
+    for (const Trap& t : _traps) {
+        writer->writeFloat(t.position.x);
+        writer->writeFloat(t.position.y);
+        writer->writeUint8(t.activated ? 1 : 0);
+        writer->writeUint8(t.copCollide ? 1 : 0);
+        writer->writeUint8(t.thiefCollide ? 1 : 0);
+        writer->writeUint8(t.idleActivatedAnimation ? 1 : 0);
+        writer->writeUint8(t.idleDeactivatedAnimation ? 1 : 0);
+        writer->writeSint32(t.numUses);
+        writer->writeFloat(t.copLingerDuration);
+        writer->writeFloat(t.thiefLingerDuration);
+        writeString(writer, t.sfxKey);
+        writeString(writer, t.activationTexture);
+        writeString(writer, t.deactivationTexture);
+        writer->writeSint32(t.textureObject);
+        writer->writeSint32(t.triggerObject);
+        writer->writeSint32(t.deactivationObject);
+        writeEffect(writer, t.copEffect);
+        writeEffect(writer, t.thiefEffect);
+        writeEffect(writer, t.copLingerEffect);
+        writeEffect(writer, t.thiefLingerEffect);
+    }
+}
+
+//  MARK: - Helpers
+
+/**
+ * Reads a triangulated shape from a Tiled object
+ *
+ * The polygon is relative to the returned position, which is already
+ * converted to Box2D coordinates.
+ */
+LevelData::Shape LevelData::readJsonShape(const shared_ptr<JsonValue>& json) {
+    shared_ptr<JsonValue> polygon = json->get(POLYGON_FIELD);
+    bool ellipse = json->getBool(ELLIPSE_FIELD);
+    float x = json->getFloat(X_FIELD) / _tileSize;
+    float y = json->getFloat(Y_FIELD) / _tileSize;
+    float width = json->getFloat(WIDTH_FIELD) / _tileSize;
+    float height = json->getFloat(HEIGHT_FIELD) / _tileSize;
+    int gid = json->getInt(GID_FIELD);
+
+    Poly2 poly;
+
+    // The shape is an ellipse
+    if (ellipse) {
+        // Adjust the coordinates to match CUGL
+        x = x + width / 2;
+        y = _mapHeight - (height / 2) - y;
+        poly = PolyFactory(POLYFACTORY_TOLERANCE).makeEllipse(Vec2::ZERO, Vec2(width,height));
+    }
+
+    // The shape is a polygon
+    else if (polygon != nullptr) {
+        // Adjust the coordinates to match CUGL
+        y = _mapHeight - y;
+
+        // Gather all of the vertices scaled to Box2D coordinates
+        vector<Vec2> vertices;
+        for (int ii = 0; ii < polygon->size(); ii++) {
+            shared_ptr<JsonValue> vertex = polygon->get(ii);
+            float localx = vertex->getFloat(X_FIELD) / _tileSize;
+            float localy = -vertex->getFloat(Y_FIELD) / _tileSize;
+            vertices.push_back(Vec2(localx,localy));
+        }
+
+        // Create a path in the counter clockwise direction, give up if not valid
+        Path2 path(vertices);
+        if (path.orientation() == 0) throw runtime_error("non-closed path");
+        if (path.orientation() != -1) path.reverse();
+
+        // Create a polygon from that path
+        EarclipTriangulator triangulator;
+        triangulator.set(path);
+        triangulator.calculate();
+        poly = triangulator.getPolygon();
+    }
+
+    // The shape is a rectangle
+    else {
+        // Flip the y coordinate
+        y = _mapHeight - height - y;
+        poly = PolyFactory(POLYFACTORY_TOLERANCE).makeRect(Vec2::ZERO, Vec2(width, height));
+    }
+
+    return { poly, x, y, gid };
+}
+
+/**
+ * Reads the properties of every tile in the props tileset
+ */
+void LevelData::readJsonTiles(const shared_ptr<JsonValue>& tileset) {
+    shared_ptr<JsonValue> tiles = tileset->get("tiles");
+    int tilecount = tileset->getInt("tilecount");
+    for (int i = 0; i < tilecount; i++) {
+        shared_ptr<JsonValue> tile = tiles->get(i);
+        int id = tile->get("id")->asInt();
+        Tile& data = _tiles[id];
+        data.imageWidth = tile->getFloat("imagewidth");
+        data.imageHeight = tile->getFloat("imageheight");
+
+        // There are only 4 properties, so if/else is fine
+        shared_ptr<JsonValue> properties = tile->get("properties");
+        for (int j = 0; j < properties->size(); j++) {
+            shared_ptr<JsonValue> p = properties->get(j);
+            if (p == nullptr) break;
+            string pname = p->getString("name");
+            if (pname == "name") {
+                data.assetName = p->getString("value");
+            } else if (pname == "animated") {
+                data.animated = p->getBool("value");
+            } else if (pname == "anim_rows") {
+                data.animRows = p->getInt("value");
+            } else if (pname == "anim_cols") {
+                data.animCols = p->getInt("value");
+            }
+        }
+
+        if (tile->get("objectgroup") != nullptr) {
+            shared_ptr<JsonValue> hitboxes = tile->get("objectgroup")->get("objects");
+            for (int j = 0; j < hitboxes->size(); j++) {
+                data.hitboxes.push_back(readJsonShape(hitboxes->get(j)));
+            }
+        }
+    }
+}
+
+/**
+ * Reads the properties of a single trap
+ */
+LevelData::Trap LevelData::readJsonTrap(const shared_ptr<JsonValue>& json) {
+    Trap trap;
+    trap.position = Vec2(json->getFloat(X_FIELD) / _tileSize,
+                         _mapHeight - json->getFloat(Y_FIELD) / _tileSize);
+
+    // Read in the JSON values and match them to the proper property
+    vector<shared_ptr<JsonValue>> children = json->get(PROPERTIES_FIELD)->children();
+    for (int i = 0; i < children.size(); i++) {
+        shared_ptr<JsonValue> elem = children.at(i);
+        string name = elem->getString(NAME_FIELD, "NULL");
+        switch (_constants[name]) {
+            case ACTIVATED:
+                trap.activated = elem->getBool(VALUE_FIELD);
+                break;
+            case COLLISION_SOUND:
+                trap.sfxKey = elem->getString(VALUE_FIELD);
+                break;
+            case COP_COLLIDE:
+                trap.copCollide = elem->getBool(VALUE_FIELD);
+                break;
+            case COP_EFFECT:
+                trap.copEffect = readJsonEffect(elem);
+                break;
+            case COP_LINGER_DURATION:
+                trap.copLingerDuration = elem->getFloat(VALUE_FIELD);
+                break;
+            case COP_LINGER_EFFECT:
+                trap.copLingerEffect = readJsonEffect(elem);
+                break;
+            case IDLE_ACTIVATED_ANIMATION:
+                trap.idleActivatedAnimation = elem->getBool(VALUE_FIELD);
+                break;
+            case IDLE_DEACTIVATED_ANIMATION:
+                trap.idleDeactivatedAnimation = elem->getBool(VALUE_FIELD);
+                break;
+            case NUM_USAGES:
+                trap.numUses = elem->getInt(VALUE_FIELD);
+                break;
+            case THIEF_COLLIDE:
+                trap.thiefCollide = elem->getBool(VALUE_FIELD);
+                break;
+            case TEXTURE_ACTIVATION_TRIGGER:
+                trap.activationTexture = elem->getString(VALUE_FIELD);
+                break;
+            case TEXTURE_ASSET:
+                trap.textureObject = elem->getInt(VALUE_FIELD);
+                break;
+            case TEXTURE_DEACTIVATION_TRIGGER:
+                trap.deactivationTexture = elem->getString(VALUE_FIELD);
+                break;
+            case THIEF_EFFECT:
+                trap.thiefEffect = readJsonEffect(elem);
+                break;
+            case THIEF_LINGER_DURATION:
+                trap.thiefLingerDuration = elem->getFloat(VALUE_FIELD);
+                break;
+            case THIEF_LINGER_EFFECT:
+                trap.thiefLingerEffect = readJsonEffect(elem);
+                break;
+            case TRIGGER_AREA:
+                trap.triggerObject = elem->getInt(VALUE_FIELD);
+                break;
+            case TRIGGER_DEACTIVATION_AREA:
+                trap.deactivationObject = elem->getInt(VALUE_FIELD);
+                break;
+            case EFFECT_AREA:
+            case NIL:
+            default:
+                break;
+        }
+    }
+    return trap;
+}
+
+/**
+ * Reads a trap effect from a Tiled class property
+ */
+LevelData::Effect LevelData::readJsonEffect(const shared_ptr<JsonValue>& effect) {
+    Effect result;
+    shared_ptr<JsonValue> value = effect->get(VALUE_FIELD);
+    if (value->children().size() == 0) return result;
+
+    switch (_constants[value->getString(TRAP_TYPE, "NULL")]) {
+        case ESCALATOR:
+            result.type = TrapModel::TrapType::Moving_Platform;
+            if (value->get(ESCALATOR_VELOCITY) != nullptr) {
+                result.vec.x = value->get(ESCALATOR_VELOCITY)->getFloat(X_FIELD, 0);
+                result.vec.y = value->get(ESCALATOR_VELOCITY)->getFloat(Y_FIELD, 0);
+            }
+            break;
+        case TELEPORT:
+            result.type = TrapModel::TrapType::Teleport;
+            result.vec.x = value->get(TELEPORT_LOCATION)->getFloat(X_FIELD, 0) / _tileSize;
+            result.vec.y = _mapHeight - value->get(TELEPORT_LOCATION)->getFloat(Y_FIELD, 0) / _tileSize;
+            break;
+        case STAIRS:
+            result.type = TrapModel::TrapType::Directional_VelMod;
+            result.vec.x = value->get(STAIRCASE_VELOCITY)->getFloat(X_FIELD, 0);
+            result.vec.y = value->get(STAIRCASE_VELOCITY)->getFloat(Y_FIELD, 0);
+            break;
+        case VELOCITY_MODIFIER:
+            result.type = TrapModel::TrapType::VelMod;
+            result.vec.x = value->get(SPEED_MODIFIER)->getFloat(X_FIELD, 0);
+            result.vec.y = value->get(SPEED_MODIFIER)->getFloat(Y_FIELD, 0);
+            break;
+        case NIL:
+        default:
+            break;
+    }
+    return result;
+}
@@ -0,0 +1,282 @@
+//
+//  LCMPLevelData.h
+//  Low Control Mall Patrol
+//
+//  This class holds a fully resolved level: every wall, prop hitbox and trap
+//  area is already triangulated and converted to Box2D coordinates. It can be
+//  read from a Tiled map (the slow path) or from a compiled binary level.
+//
+//  A compiled level records a hash of the Tiled map and props tileset it was
+//  compiled from, and is only loaded while they still match. Recompile the
+//  levels (see COMPILE_LEVELS) whenever a map or the tileset changes.
+//
+//  Author: Kevin Games
+//  Version: 4/26/22
+//
+
+#ifndef __LCMP_LEVEL_DATA_H__
+#define __LCMP_LEVEL_DATA_H__
+#include <cugl/cugl.h>
+#include <map>
+#include "LCMPTrapModel.h"
+#include "LCMPConstants.h"
+
+class LevelData {
+public:
+//  MARK: - Structs
+
+    /** A triangulated shape from Tiled, in Box2D coordinates */
+    struct Shape {
+        /** The triangulated polygon, relative to the position */
+        cugl::Poly2 poly;
+        /** The x-coordinate of the shape */
+        float x;
+        /** The y-coordinate of the shape */
+        float y;
+        /** The tile gid of the shape, or 0 if it has none */
+        int gid;
+    };
+
+    /** The resolved properties of a tile in the props tileset */
+    struct Tile {
+        /** The key of the texture for this tile */
+        std::string assetName;
+        /** The width (in pixels) of the texture, so that hitboxes can be scaled without it */
+        float imageWidth = 0;
+        /** The height (in pixels) of the texture, so that hitboxes can be scaled without it */
+        float imageHeight = 0;
+        /** The hitboxes of this tile, in Tiled pixels scaled by the tile size */
+        std::vector<Shape> hitboxes;
+        /** Whether the texture is a sprite sheet */
+        bool animated = false;
+        /** The number of rows in the sprite sheet */
+        int animRows = 0;
+        /** The number of columns in the sprite sheet */
+        int animCols = 0;
+    };
+
+    /** A prop placed in the map */
+    struct Prop {
+        /** The id of the tile (in the props tileset) for this prop */
+        int tile;
+        /** The x-coordinate of the bottom left corner */
+        float x;
+        /** The y-coordinate of the bottom left corner */
+        float y;
+        /** The width of the prop */
+        float width;
+        /** The height of the prop */
+        float height;
+    };
+
+    /** The resolved parameters of a trap effect */
+    struct Effect {
+        /** The type of the effect */
+        TrapModel::TrapType type = TrapModel::TrapType::Moving_Platform;
+        /** The vector parameterizing the effect */
+        cugl::Vec2 vec;
+    };
+
+    /** The resolved properties of a single trap */
+    struct Trap {
+        /** The position of the trap trigger */
+        cugl::Vec2 position;
+        bool activated = false;
+        bool copCollide = false;
+        bool thiefCollide = false;
+        bool idleActivatedAnimation = false;
+        bool idleDeactivatedAnimation = false;
+        int numUses = -1;
+        float copLingerDuration = 0;
+        float thiefLingerDuration = 0;
+        /** The key of the collision sound, or empty for none */
+        std::string sfxKey;
+        /** The key of the activation trigger texture, or empty for none */
+        std::string activationTexture;
+        /** The key of the deactivation trigger texture, or empty for none */
+        std::string deactivationTexture;
+        /** The id of the trap shape holding the texture asset, or -1 */
+        int textureObject = -1;
+        /** The id of the trap shape that the thief triggers */
+        int triggerObject = -1;
+        /** The id of the trap shape that the cops deactivate */
+        int deactivationObject = -1;
+        Effect copEffect;
+        Effect thiefEffect;
+        Effect copLingerEffect;
+        Effect thiefLingerEffect;
+    };
+
+protected:
+//  MARK: - Properties
+
+    /** The width of the map in Box2D coordinates */
+    float _mapWidth;
+    /** The height of the map in Box2D coordinates */
+    float _mapHeight;
+    /** The size of a tile in Tiled coordinates */
+    float _tileSize;
+    /** The first gid of the props tileset, or 0 if the map does not use it */
+    int _propFirstGid;
+    /** The hash of the Tiled map and props tileset this level was read from */
+    Uint32 _sourceHash;
+    /** The spawn location of the thief */
+    cugl::Vec2 _thiefSpawn;
+    /** The spawn locations of the cops */
+    std::vector<cugl::Vec2> _copSpawns;
+    /** The walls of the map */
+    std::vector<Shape> _walls;
+    /** The tiles of the props tileset, by tile id */
+    std::map<int, Tile> _tiles;
+    /** The props placed in the map */
+    std::vector<Prop> _props;
+    /** The shapes referenced by traps, by Tiled object id */
+    std::map<int, Shape> _trapShapes;
+    /** The traps in the map */
+    std::vector<Trap> _traps;
+    /** Map to associate the json strings with the json enum values */
+    std::map<std::string, JsonConstants> _constants;
+
+public:
+//  MARK: - Constructors
+
+    /**
+     * Constructs an empty Level Data
+     */
+    LevelData() : _mapWidth(0), _mapHeight(0), _tileSize(1), _propFirstGid(0), _sourceHash(0) {}
+
+    /**
+     * Destructs a Level Data
+     */
+    ~LevelData() { dispose(); }
+
+    /**
+     * Disposes of all resources in this instance of Level Data
+     */
+    void dispose();
+
+    /**
+     * Initializes a Level Data from a Tiled map and the props tileset
+     */
+    bool initWithJson(const std::shared_ptr<cugl::JsonValue>& map,
+                      const std::shared_ptr<cugl::JsonValue>& tileset);
+
+    /**
+     * Initializes a Level Data from a compiled binary level
+     */
+    bool initWithBinary(const std::shared_ptr<cugl::BinaryReader>& reader);
+
+    /**
+     * Returns a newly allocated Level Data from a Tiled map and the props tileset
+     */
+    static std::shared_ptr<LevelData> allocWithJson(const std::shared_ptr<cugl::JsonValue>& map,
+                                                    const std::shared_ptr<cugl::JsonValue>& tileset) {
+        std::shared_ptr<LevelData> result = std::make_shared<LevelData>();
+        return (result->initWithJson(map, tileset) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated Level Data from a compiled binary level
+     */
+    static std::shared_ptr<LevelData> allocWithBinary(const std::shared_ptr<cugl::BinaryReader>& reader) {
+        std::shared_ptr<LevelData> result = std::make_shared<LevelData>();
+        return (result->initWithBinary(reader) ? result : nullptr);
+    }
+
+    /**
+     * Returns the level for the given Tiled map asset.
+     *
+     * This loads the compiled level next to the map (same name, with the
+     * extension LEVEL_EXTENSION) if there is one that was compiled from the
+     * current map and props tileset, and otherwise falls back to parsing them.
+     */
+    static std::shared_ptr<LevelData> load(const std::string& file);
+
+    /**
+     * Compiles a Tiled map and the props tileset into a binary level.
+     *
+     * The Tiled map is an asset path, while the destination is an absolute
+     * path (typically in the save directory). Copy the result next to the
+     * map in the assets folder to ship it.
+     */
+    static bool compile(const std::string& file, const std::string& destination);
+
+    /**
+     * Returns the asset path of the compiled level for a Tiled map
+     */
+    static std::string getCompiledPath(const std::string& file);
+
+    /**
+     * Returns the hash of the text of a Tiled map and the props tileset
+     */
+    static Uint32 hashSource(const std::string& map, const std::string& tileset);
+
+//  MARK: - Methods
+
+    /**
+     * Writes this level in the compiled binary format
+     */
+    void write(const std::shared_ptr<cugl::BinaryWriter>& writer) const;
+
+    /** Returns the width of the map in Box2D coordinates */
+    float getMapWidth() const { return _mapWidth; }
+
+    /** Returns the height of the map in Box2D coordinates */
+    float getMapHeight() const { return _mapHeight; }
+
+    /** Returns the size of a tile in Tiled coordinates */
+    float getTileSize() const { return _tileSize; }
+
+    /** Returns the first gid of the props tileset, or 0 if the map does not use it */
+    int getPropFirstGid() const { return _propFirstGid; }
+
+    /** Returns the hash of the Tiled map and props tileset this level was read from */
+    Uint32 getSourceHash() const { return _sourceHash; }
+
+    /** Returns the spawn location of the thief */
+    cugl::Vec2 getThiefSpawn() const { return _thiefSpawn; }
+
+    /** Returns the spawn location of a cop */
+    cugl::Vec2 getCopSpawn(int copID) const { return _copSpawns.at(copID); }
+
+    /** Returns the walls of the map */
+    const std::vector<Shape>& getWalls() const { return _walls; }
+
+    /** Returns the tiles of the props tileset, by tile id */
+    const std::map<int, Tile>& getTiles() const { return _tiles; }
+
+    /** Returns the props placed in the map */
+    const std::vector<Prop>& getProps() const { return _props; }
+
+    /** Returns the shapes referenced by traps, by Tiled object id */
+    const std::map<int, Shape>& getTrapShapes() const { return _trapShapes; }
+
+    /** Returns the traps in the map */
+    const std::vector<Trap>& getTraps() const { return _traps; }
+
+private:
+//  MARK: - Helpers
+
+    /**
+     * Reads a triangulated shape from a Tiled object
+     */
+    Shape readJsonShape(const std::shared_ptr<cugl::JsonValue>& json);
+
+    /**
+     * Reads the properties of every tile in the props tileset
+     */
+    void readJsonTiles(const std::shared_ptr<cugl::JsonValue>& tileset);
+
+    /**
+     * Reads the properties of a single trap
+     */
+    Trap readJsonTrap(const std::shared_ptr<cugl::JsonValue>& json);
+
+    /**
+     * Reads a trap effect from a Tiled class property
+     */
+    Effect readJsonEffect(const std::shared_ptr<cugl::JsonValue>& effect);
+
+};
+
+#endif /* __LCMP_LEVEL_DATA_H__ */
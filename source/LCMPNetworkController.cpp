@@ -27,7 +27,73 @@ using namespace std;
 /** The maximum number of players allowed in a single room */
 #define SERVER_MAX      5
 /** The version of the server */
-#define SERVER_VERSION  0
+#define SERVER_VERSION  1
+
+// Message Constants
+/** The default number of network ticks per second */
+#define TICK_RATE           30.0f
+/** The number of bits of a message signal */
+#define SIGNAL_BITS         8
+/** The number of bits of a player, cop or keyframe ID */
+#define ID_BITS             8
+/** The number of bits of a trap ID */
+#define TRAP_BITS           16
+/** The number of bits of a sender clock (in milliseconds, wrapping every minute or so) */
+#define CLOCK_BITS          16
+/** The number of bits of an input sequence number */
+#define SEQUENCE_BITS       16
+/** The number of bits of a ping or round clock (in milliseconds, wrapping after weeks) */
+#define PING_CLOCK_BITS     32
+/** The ordering channel of reliable events (trap activations, game start and game over) */
+#define EVENT_CHANNEL       1
+/** The ordering channel of the movement of player 0; each player sequences its own movement */
+#define MOVEMENT_CHANNEL    2
+/** The index of the thief in the movement streams (after the cops) */
+#define THIEF_STREAM        4
+/** The number of movement messages sent between keyframes */
+#define KEYFRAME_INTERVAL   30
+/** How far outside of the map (in Box2D units) a position may be sent */
+#define MAP_MARGIN          8.0f
+/** The number of bits per component of a position */
+#define POSITION_BITS       16
+/** The largest speed (in Box2D units per second) that may be sent */
+#define VELOCITY_RANGE      32.0f
+/** The number of bits per component of a velocity */
+#define VELOCITY_BITS       12
+/** The number of bits per component of a movement force (joystick) */
+#define FORCE_BITS          8
+/** The number of bits per component of a tackle direction */
+#define DIRECTION_BITS      10
+/** The number of bits of a tackle time */
+#define TACKLE_TIME_BITS    10
+
+// Interpolation Constants
+/** The default delay (in seconds) that remote players are shown behind their newest snapshot */
+#define INTERPOLATION_DELAY 0.1f
+/** The longest time (in seconds) a remote player is extrapolated past its newest snapshot */
+#define MAX_EXTRAPOLATION   0.25f
+/** The number of snapshots buffered for each remote player */
+#define SNAPSHOT_CAPACITY   32
+
+// Prediction Constants
+/** The number of local inputs kept for replay (a couple of seconds of frames) */
+#define PREDICTION_CAPACITY 128
+/** How far (in Box2D units) the local player may be from the host state before it is corrected */
+#define RECONCILE_THRESHOLD 0.1f
+/** The number of host ticks between sending the accepted states back to the clients */
+#define STATE_INTERVAL      3
+
+// Lag Compensation Constants
+/** The default time (in seconds) the host will rewind the thief to judge a cop */
+#define LAG_WINDOW          0.4f
+/** The number of thief positions the host keeps */
+#define HISTORY_CAPACITY    64
+/** How much further (in Box2D units) than touching a cop may be from the thief to catch it */
+#define CATCH_TOLERANCE     1.0f
+
+// Clock Constants
+/** The time (in seconds) between pings to the other peers */
+#define PING_INTERVAL       0.5f
 
 //  MARK: - Constructors
 
@@ -40,6 +106,33 @@ NetworkController::NetworkController() {
     _config.maxNumPlayers = SERVER_MAX;
     _config.apiVersion = SERVER_VERSION;
     _status = IDLE;
+    _tickRate = TICK_RATE;
+    _tickTime = 0;
+    _trafficTime = 0;
+    _sentTraffic = Traffic();
+    _receivedTraffic.fill(Traffic());
+    _pendingMovement.fill(false);
+    _clock = 0;
+    _receivedClock = 0;
+    _interpolationDelay = INTERPOLATION_DELAY;
+    for (SnapshotBuffer& snapshots : _snapshots) {
+        snapshots.init(MOVEMENT_VALUES, FORCE_Y + 1, SNAPSHOT_CAPACITY);
+    }
+    _prediction.init(PREDICTION_CAPACITY);
+    _receivedSequence = 0;
+    _receivedStreams = 0;
+    _ticksSinceState = 0;
+    _thiefHistory.init(HISTORY_CAPACITY);
+    _lagWindow = LAG_WINDOW;
+    _rejectedClaims = 0;
+    _clockSync.init(SERVER_MAX);
+    _pingTime = 0;
+    _receivedPlayer = 0;
+    _streamSenders.fill(0);
+    _round = 0;
+    _receivedRound = -1;
+    _roundStart = 0;
+    setMapBounds(Rect::ZERO);
 }
 
 /**
@@ -63,30 +156,42 @@ bool NetworkController::init() {
 //  MARK: - Methods
 
 /**
- * Establishes a host connection with the server
+ * Establishes a host connection with the server (or the loopback network, if there is one)
  */
 bool NetworkController::connect() {
-    _connection = NetworkConnection::alloc(_config);
+    _connection = _loopback == nullptr
+        ? NetworkConnection::alloc(_config)
+        : NetworkConnection::alloc(_config, _loopback);
     
     
     for (int playerID = 0; playerID < 5; playerID++) {
         _players[playerID] = {playerID, -2, "No Player"};
     }
     _players[0].username = "Player 1";
+    resetMovement();
+    _clockSync.clear();
+    _round = 0;
+    _receivedRound = -1;
     
     update();
     return _status != IDLE;
 }
 
 /**
- * Establishes a client connection with the server
+ * Establishes a client connection with the server (or the loopback network, if there is one)
  */
 bool NetworkController::connect(const std::string room) {
-    _connection = NetworkConnection::alloc(_config, room);
+    _connection = _loopback == nullptr
+        ? NetworkConnection::alloc(_config, room)
+        : NetworkConnection::alloc(_config, _loopback, room);
     
     for (int playerID = 0; playerID < 5; playerID++) {
         _players[playerID] = {playerID, -2, "No Player"};
     }
+    resetMovement();
+    _clockSync.clear();
+    _round = 0;
+    _receivedRound = -1;
     
     update();
     return _status != IDLE;
@@ -118,26 +223,30 @@ void NetworkController::update() {
     _connection->receive([this](const std::vector<uint8_t> msg) {
         // TODO: Add more functionality for getting client info, like names
         _deserializer.receive(msg);
-        vector<float> data = _deserializer.readFloatVector();
-        switch ((int) data.at(0)) {
-        case DISPLAY_NAME:
-            _players[data.at(1)].username = _deserializer.readString();
+        switch (_deserializer.readBits(SIGNAL_BITS)) {
+        case DISPLAY_NAME: {
+            int player = _deserializer.readBits(ID_BITS);
+            _players[player].username = _deserializer.readString();
             break;
+        }
         case START_GAME:
             _status = START;
-            int i = 2;
-            while (i < data.size()) {
-                int player = (int) data.at(i);
-                int role = (int) data.at(i+1);
+            // Roles are sent shifted by one, as the thief is -1
+            for (int i = 0; i < SERVER_MAX; i++) {
+                int player = _deserializer.readBits(ID_BITS);
+                int role = (int) _deserializer.readBits(ID_BITS) - 1;
                 if (player == this->getPlayerID()) _playerNumber = role;
                 _players[player].playerNumber = role;
-                i += 2;
             }
             for (int i = 0; i < 5; i++) {
                 _players[i].username = _deserializer.readString();
             }
             _level = _deserializer.readString();
             break;
+        case ROUND_START:
+            // The host starts the first round right after the game, so it may arrive before we leave the lobby
+            readRoundStart();
+            break;
         }
         _deserializer.reset();
     });
@@ -147,54 +256,72 @@ void NetworkController::update() {
  * Sends the updated name of a particular player
  */
 void NetworkController::sendDisplayName(string name) {
-    vector<float> data;
-    data.push_back(DISPLAY_NAME);
-    data.push_back(getPlayerID() ? *getPlayerID() : -1);
+    _serializer.writeBits(DISPLAY_NAME, SIGNAL_BITS);
+    _serializer.writeBits(getPlayerID() ? *getPlayerID() : UINT8_MAX, ID_BITS);
     _players[*getPlayerID()].username = name;
     
-    _serializer.writeFloatVector(data);
     _serializer.writeString(name);
-    _connection->send(_serializer.serialize());
-    _serializer.reset();
+    sendSerialized(RELIABLE_ORDERED, EVENT_CHANNEL);
 }
 
 /**
  * Sends a byte vector to start the game
  */
 void NetworkController::sendStartGame(string level, bool randomThief, int thiefChoice) {
-    vector<float> data;
-    data.push_back(START_GAME);
-    data.push_back(getNumPlayers());
+    _serializer.writeBits(START_GAME, SIGNAL_BITS);
     
     int count = 0;
     int thief = randomThief ? rand() % getNumPlayers() : thiefChoice;
     for (int playerID = 0; playerID < 5; playerID++) {
         _players[playerID].playerNumber = playerID == getPlayerID() ? -1 : count;
-        data.push_back(playerID);
+        _serializer.writeBits(playerID, ID_BITS);
         if (thief == playerID) {
             if (playerID == getPlayerID()) _playerNumber = -1;
-            data.push_back(-1);
+            _serializer.writeBits(0, ID_BITS);
         } else {
             if (playerID == getPlayerID()) _playerNumber = count;
-            data.push_back(count);
+            _serializer.writeBits(count + 1, ID_BITS);
             count++;
         }
     }
     
-    _serializer.writeFloatVector(data);
-    
     for (int i = 0; i < 5; i++) {
         _serializer.writeString(_players[i].username);
     }
     
     _serializer.writeString(level);
-    
-    _connection->send(_serializer.serialize());
-    _serializer.reset();
+    sendSerialized(RELIABLE_ORDERED, EVENT_CHANNEL);
 }
 
 //  MARK: - Gameplay
 
+/**
+ * Sets the bounds of the map, which positions in movement messages are quantized to
+ */
+void NetworkController::setMapBounds(Rect bounds) {
+    Vec2 min = bounds.origin - Vec2(MAP_MARGIN, MAP_MARGIN);
+    Vec2 max = bounds.origin + bounds.size + Vec2(MAP_MARGIN, MAP_MARGIN);
+    
+    // The state schema is a prefix of the thief schema, which is a prefix of the cop schema
+    vector<NetworkSchema::Field> fields = {
+        {2, POSITION_BITS, min, max},
+        NetworkSchema::makeSymmetric(2, VELOCITY_BITS, Vec2(VELOCITY_RANGE, VELOCITY_RANGE))
+    };
+    _stateSchema.init(fields);
+    fields.push_back(NetworkSchema::makeSymmetric(2, FORCE_BITS, Vec2::ONE));
+    _thiefSchema.init(fields);
+    fields.push_back(NetworkSchema::makeSymmetric(2, DIRECTION_BITS, Vec2::ONE));
+    fields.push_back({2, POSITION_BITS, min, max});
+    fields.push_back({1, TACKLE_TIME_BITS, Vec2::ZERO, Vec2(TACKLE_COOLDOWN_TIME, 0)});
+    fields.push_back({1, 1, Vec2::ZERO, Vec2::ONE});
+    fields.push_back({1, 1, Vec2::ZERO, Vec2::ONE});
+    fields.push_back({1, 1, Vec2::ZERO, Vec2::ONE});
+    _copSchema.init(fields);
+    
+    // Keyframes quantized with the old bounds are meaningless now
+    resetMovement();
+}
+
 /**
  * Checks the connection, updates the status accordingly, and updates the game (during game)
  */
@@ -210,128 +337,221 @@ void NetworkController::update(std::shared_ptr<GameModel>& game) {
     
     _connection->receive([this, game](const std::vector<uint8_t> msg) {
         _deserializer.receive(msg);
-        vector<float> data = _deserializer.readFloatVector();
-        _deserializer.reset();
-        
-        switch ((int) data.at(0)) {
-        case COP_MOVEMENT:
-            game->updateCop(Vec2(data.at(1), data.at(2)),
-                            Vec2(data.at(3), data.at(4)),
-                            Vec2(data.at(5), data.at(6)),
-                            Vec2(data.at(7), data.at(8)),
-                            Vec2(data.at(9), data.at(10)),
-                            (float) data.at(11),
-                            (bool) data.at(12),
-                            (bool) data.at(13),
-                            (bool) data.at(14),
-                            (int) data.at(15));
-            break;
-        case THIEF_MOVEMENT:
-            game->updateThief(Vec2(data.at(1), data.at(2)),
-                              Vec2(data.at(3), data.at(4)),
-                              Vec2(data.at(5), data.at(6)));
-            break;
-        case TRAP_ACTIVATION:
-            game->activateTrap((int) data.at(1));
-            break;
-        case GAME_OVER:
-            game->setGameOver(true);
-            break;
-        default:
-            break;
+        int signal = _deserializer.readBits(SIGNAL_BITS);
+        if (signal == TICK) {
+            int player = _deserializer.readBits(ID_BITS);
+            _receivedPlayer = player;
+            _receivedClock = readClock(player);
+            _receivedSequence = _deserializer.readBits(SEQUENCE_BITS);
+            int count = _deserializer.readBits(ID_BITS);
+            if (player < _receivedTraffic.size()) countTraffic(_receivedTraffic[player], msg.size());
+            _receivedStreams = 0;
+            bool valid = true;
+            for (int i = 0; i < count && valid; i++) {
+                valid = readMessage(game, _deserializer.readBits(SIGNAL_BITS));
+            }
+            if (valid && _isHost) acceptState(player);
+        } else {
+            readMessage(game, signal);
         }
+        _deserializer.reset();
     });
 }
 
 /**
- * Sends a byte vector to update thief movement
+ * Sends everything queued since the last tick, if it is time for a tick
+ *
+ * A tick carries the movement of every player this peer controls (its own player, and the
+ * disconnected cops if it is the host) and the traps activated since the last tick. A tick of
+ * deltas is sequenced, so a lost one is never waited for, but a tick with a keyframe is sent
+ * reliably and in order, as the deltas after it are read against it. Trap activations are sent
+ * reliably in a byte vector of their own. Every few ticks, the host also sends back the states it
+ * accepted from the clients, so that they can correct their predictions.
  */
-void NetworkController::sendThiefMovement(std::shared_ptr<GameModel>& game, Vec2 force) {
-    if (_connection == nullptr) return;
-    std::shared_ptr<ThiefModel> thief = game->getThief();
-    Vec2 position = thief->getPosition();
-    Vec2 velocity = thief->getVelocity();
-    vector<float> data;
+void NetworkController::sendTick(std::shared_ptr<GameModel>& game, float timestep) {
+    updateTraffic(timestep);
+    _clock += timestep;
+    if (_isHost && _pendingMovement[THIEF_STREAM]) _thiefHistory.record(_clock, game->getThief()->getPosition());
+    _pingTime += timestep;
+    if (_pingTime >= PING_INTERVAL) {
+        _pingTime = 0;
+        sendPing();
+    }
+    _tickTime += timestep;
+    float period = 1.0f / _tickRate;
+    if (_tickTime < period) return;
     
-    data.push_back(THIEF_MOVEMENT);
-    data.push_back(position.x);
-    data.push_back(position.y);
-    data.push_back(velocity.x);
-    data.push_back(velocity.y);
-    data.push_back(force.x);
-    data.push_back(force.y);
+    // Drop the backlog after a long frame rather than sending a burst of ticks
+    _tickTime = fmod(_tickTime, period);
     
-    _serializer.writeFloatVector(data);
-    _connection->send(_serializer.serialize());
-    _serializer.reset();
+    int count = 0;
+    for (bool pending : _pendingMovement) count += pending;
+    bool sendStates = _isHost && ++_ticksSinceState >= STATE_INTERVAL;
+    if (sendStates) {
+        _ticksSinceState = 0;
+        for (const AcceptedState& state : _acceptedStates) count += state.pending;
+    }
+    if (_connection != nullptr && _connection->getStatus() == NetworkConnection::NetStatus::Connected) {
+        int player = getPlayerID() ? *getPlayerID() : 0;
+        if (count > 0) {
+            _serializer.writeBits(TICK, SIGNAL_BITS);
+            _serializer.writeBits(player, ID_BITS);
+            _serializer.writeBits((Uint32)(_clock * 1000), CLOCK_BITS);
+            _serializer.writeBits(_prediction.getSequence(), SEQUENCE_BITS);
+            _serializer.writeBits(count, ID_BITS);
+            bool keyframe = false;
+            for (int copID = 0; copID < THIEF_STREAM; copID++) {
+                if (!_pendingMovement[copID]) continue;
+                keyframe |= writeCopMovement(game->getCop(copID), _pendingForce[copID], copID);
+            }
+            if (_pendingMovement[THIEF_STREAM]) {
+                keyframe |= writeThiefMovement(game->getThief(), _pendingForce[THIEF_STREAM]);
+            }
+            for (int client = 0; sendStates && client < _acceptedStates.size(); client++) {
+                AcceptedState& state = _acceptedStates[client];
+                if (!state.pending) continue;
+                float data[VELOCITY_Y + 1] = {
+                    state.position.x, state.position.y,
+                    state.velocity.x, state.velocity.y
+                };
+                _serializer.writeBits(PLAYER_STATE, SIGNAL_BITS);
+                _serializer.writeBits(client, ID_BITS);
+                _serializer.writeBits(state.sequence, SEQUENCE_BITS);
+                _stateSchema.write(_serializer, data, nullptr);
+                state.pending = false;
+            }
+            
+            // Deltas are superseded by the next tick, but every keyframe must arrive, as deltas need it
+            sendSerialized(keyframe ? RELIABLE_ORDERED : UNRELIABLE_SEQUENCED, MOVEMENT_CHANNEL + player);
+        }
+        if (!_pendingTraps.empty()) {
+            _serializer.writeBits(TICK, SIGNAL_BITS);
+            _serializer.writeBits(player, ID_BITS);
+            _serializer.writeBits((Uint32)(_clock * 1000), CLOCK_BITS);
+            _serializer.writeBits(_prediction.getSequence(), SEQUENCE_BITS);
+            _serializer.writeBits((Uint32)_pendingTraps.size(), ID_BITS);
+            for (int trapID : _pendingTraps) {
+                _serializer.writeBits(TRAP_ACTIVATION, SIGNAL_BITS);
+                _serializer.writeBits(trapID, TRAP_BITS);
+            }
+            sendSerialized(RELIABLE_ORDERED, EVENT_CHANNEL);
+        }
+    }
+    _pendingMovement.fill(false);
+    _pendingTraps.clear();
 }
 
 /**
- * Sends a byte vector to update cop movement
+ * Moves the remote players to their buffered snapshots, a short delay behind the newest
+ *
+ * Players that this peer controls never receive snapshots, so they are left alone. Once the clock
+ * of a sender is synced, its snapshots are played back against its clock rather than against
+ * when they happened to arrive.
  */
-void NetworkController::sendCopMovement(std::shared_ptr<GameModel>& game, Vec2 force, int copID) {
-    if (_connection == nullptr) return;
-    std::shared_ptr<CopModel> cop = game->getCop(copID);
-    Vec2 position = cop->getPosition();
-    Vec2 velocity = cop->getVelocity();
-    Vec2 tackleDirection = cop->getTackleDirection();
-    Vec2 tacklePosition = cop->getTacklePosition();
-    float tackleTime = cop->getTackleTime();
-    bool tackling = cop->getTackling();
-    bool caughtThief = cop->getCaughtThief();
-    bool tackleSucessful = cop->getTackleSuccessful();
-    
-    vector<float> data;
-    
-    data.push_back(COP_MOVEMENT);
-    data.push_back(position.x);
-    data.push_back(position.y);
-    data.push_back(velocity.x);
-    data.push_back(velocity.y);
-    data.push_back(force.x);
-    data.push_back(force.y);
-    data.push_back(tackleDirection.x);
-    data.push_back(tackleDirection.y);
-    data.push_back(tacklePosition.x);
-    data.push_back(tacklePosition.y);
-    data.push_back(tackleTime);
-    data.push_back(tackling);
-    data.push_back(caughtThief);
-    data.push_back(tackleSucessful);
-    data.push_back(copID);
-    
-    _serializer.writeFloatVector(data);
-    _connection->send(_serializer.serialize());
-    _serializer.reset();
+void NetworkController::interpolate(std::shared_ptr<GameModel>& game, float timestep) {
+    for (int stream = 0; stream <= THIEF_STREAM; stream++) {
+        int sender = _streamSenders[stream];
+        if (!_clockSync.isSynced(sender)) continue;
+        float now = _clock + _clockSync.getOffset(sender);
+        _snapshots[stream].setSenderTime(unwrapClock(fmod(now, (1 << CLOCK_BITS) / 1000.0f), _senderClock[sender]));
+    }
     
+    float data[MOVEMENT_VALUES];
+    for (int copID = 0; copID < THIEF_STREAM && copID < game->numberOfCops(); copID++) {
+        if (_snapshots[copID].sample(timestep, _interpolationDelay, MAX_EXTRAPOLATION, data) == SnapshotBuffer::Empty) continue;
+        game->updateCop(Vec2(data[POSITION_X], data[POSITION_Y]),
+                        Vec2(data[VELOCITY_X], data[VELOCITY_Y]),
+                        Vec2(data[FORCE_X], data[FORCE_Y]),
+                        Vec2(data[TACKLE_DIRECTION_X], data[TACKLE_DIRECTION_Y]),
+                        Vec2(data[TACKLE_POSITION_X], data[TACKLE_POSITION_Y]),
+                        data[TACKLE_TIME],
+                        data[TACKLING] != 0,
+                        data[CAUGHT_THIEF] != 0,
+                        data[TACKLE_SUCCESSFUL] != 0,
+                        copID);
+    }
+    if (_snapshots[THIEF_STREAM].sample(timestep, _interpolationDelay, MAX_EXTRAPOLATION, data) != SnapshotBuffer::Empty) {
+        game->updateThief(Vec2(data[POSITION_X], data[POSITION_Y]),
+                          Vec2(data[VELOCITY_X], data[VELOCITY_Y]),
+                          Vec2(data[FORCE_X], data[FORCE_Y]));
+    }
 }
 
 /**
- * Sends a byte vector to activate a trap
+ * Returns the clock shared by every peer (the clock of the host), or the local clock until it is synced
+ *
+ * The host is player 0, so the offset to player 0 turns the local clock into the match clock.
  */
-void NetworkController::sendTrapActivation(int trapID) {
+float NetworkController::getMatchTime() const {
+    if (_isHost || !_clockSync.isSynced(0)) return _clock;
+    return _clock + _clockSync.getOffset(0);
+}
+
+/**
+ * Starts a new round, which the host announces with its clock
+ *
+ * Every peer counts its rounds, so that a client never times a round against the start of the
+ * previous one while the announcement of the new one is in flight. The count wraps at ID_BITS,
+ * as that is all the announcement carries of it.
+ */
+void NetworkController::startRound() {
+    _round = (_round + 1) % (1 << ID_BITS);
+    if (!_isHost) return;
+    _receivedRound = _round;
+    _roundStart = _clock;
     if (_connection == nullptr) return;
-    vector<float> data;
-    data.push_back(TRAP_ACTIVATION);
-    data.push_back(trapID);
-    
-    _serializer.writeFloatVector(data);
-    _connection->send(_serializer.serialize());
-    _serializer.reset();
-    
+    _serializer.writeBits(ROUND_START, SIGNAL_BITS);
+    _serializer.writeBits(_round, ID_BITS);
+    _serializer.writeBits((Uint32)(_clock * 1000), PING_CLOCK_BITS);
+    sendSerialized(RELIABLE_ORDERED, EVENT_CHANNEL);
+}
+
+/**
+ * Records an input that was just applied to the local player, so that it can be replayed
+ *
+ * The host is the authority, so it never needs to replay its inputs.
+ */
+void NetworkController::recordInput(const std::shared_ptr<PlayerModel>& player, Vec2 movement,
+                                    bool tackling, float timestep) {
+    if (_isHost) return;
+    _prediction.record(movement, tackling, timestep, player->getPosition(), player->getVelocity());
+}
+
+/**
+ * Queues the thief movement to be sent with the next tick
+ *
+ * The thief is local from now on, so any snapshots of it are dropped.
+ */
+void NetworkController::sendThiefMovement(Vec2 force) {
+    _snapshots[THIEF_STREAM].clear();
+    _pendingMovement[THIEF_STREAM] = true;
+    _pendingForce[THIEF_STREAM] = force;
 }
 
+/**
+ * Queues a cop movement to be sent with the next tick
+ *
+ * The cop is local from now on, so any snapshots of it are dropped.
+ */
+void NetworkController::sendCopMovement(Vec2 force, int copID) {
+    _snapshots[copID].clear();
+    _pendingMovement[copID] = true;
+    _pendingForce[copID] = force;
+}
+
+/**
+ * Queues a trap activation to be sent with the next tick
+ */
+void NetworkController::sendTrapActivation(int trapID) {
+    _pendingTraps.push_back(trapID);
+}
 /**
  * Sends a byte vector to indicate game over
  */
 void NetworkController::sendGameOver() {
     if (_connection == nullptr) return;
-    vector<float> data;
-    data.push_back(GAME_OVER);
-    
-    _serializer.writeFloatVector(data);
-    _connection->send(_serializer.serialize());
-    _serializer.reset();
+    _serializer.writeBits(GAME_OVER, SIGNAL_BITS);
+    sendSerialized(RELIABLE_ORDERED, EVENT_CHANNEL);
 }
 
 //  MARK: - Server
@@ -420,6 +640,339 @@ shared_ptr<JsonValue> NetworkController::readResponse() {
 
 //  MARK: - Helpers
 
+/**
+ * Writes a movement message body, as a keyframe or as a delta from the last keyframe
+ *
+ * Keyframes are sent every few messages (reliably), and the other messages leave out the fields
+ * that still match the keyframe. A delta that arrives before its keyframe is dropped.
+ *
+ * Returns true iff the body is a keyframe.
+ */
+bool NetworkController::writeMovement(const NetworkSchema& schema, MovementStream& stream, const float* values) {
+    bool keyframe = !stream.hasKeyframe || stream.sinceKeyframe >= KEYFRAME_INTERVAL;
+    if (keyframe) {
+        stream.keyframeID++;
+        stream.hasKeyframe = true;
+        stream.sinceKeyframe = 0;
+        std::copy(values, values + schema.getWidth(), stream.keyframe);
+    } else {
+        stream.sinceKeyframe++;
+    }
+    
+    _serializer.writeBits(keyframe, 1);
+    _serializer.writeBits(stream.keyframeID, ID_BITS);
+    schema.write(_serializer, values, keyframe ? nullptr : stream.keyframe);
+    return keyframe;
+}
+
+/**
+ * Reads a movement message body, returning the values of the player after it
+ *
+ * A delta against a keyframe that has not arrived yet cannot be rebuilt, as the fields it
+ * leaves out are unknown. It is read and dropped (returning nullptr), so the last good state
+ * is held until the keyframe arrives.
+ */
+const float* NetworkController::readMovement(const NetworkSchema& schema, MovementStream& stream) {
+    bool keyframe = _deserializer.readBits(1);
+    uint8_t keyframeID = _deserializer.readBits(ID_BITS);
+    if (keyframe) {
+        schema.read(_deserializer, stream.keyframe);
+        stream.keyframeID = keyframeID;
+        stream.hasKeyframe = true;
+        std::copy(stream.keyframe, stream.keyframe + schema.getWidth(), stream.last);
+        return stream.last;
+    }
+    
+    if (!stream.hasKeyframe || stream.keyframeID != keyframeID) {
+        float skipped[MOVEMENT_VALUES];
+        schema.read(_deserializer, skipped);
+        return nullptr;
+    }
+    std::copy(stream.keyframe, stream.keyframe + schema.getWidth(), stream.last);
+    schema.read(_deserializer, stream.last);
+    return stream.last;
+}
+
+/**
+ * Writes a thief movement message, returning true iff it is a keyframe
+ */
+bool NetworkController::writeThiefMovement(const std::shared_ptr<ThiefModel>& thief, Vec2 force) {
+    Vec2 position = thief->getPosition();
+    Vec2 velocity = thief->getVelocity();
+    float data[MOVEMENT_VALUES] = {
+        position.x, position.y,
+        velocity.x, velocity.y,
+        force.x, force.y
+    };
+    
+    _serializer.writeBits(THIEF_MOVEMENT, SIGNAL_BITS);
+    return writeMovement(_thiefSchema, _sentMovement[THIEF_STREAM], data);
+}
+
+/**
+ * Writes a cop movement message, returning true iff it is a keyframe
+ */
+bool NetworkController::writeCopMovement(const std::shared_ptr<CopModel>& cop, Vec2 force, int copID) {
+    Vec2 position = cop->getPosition();
+    Vec2 velocity = cop->getVelocity();
+    // Only the direction of a tackle matters, so send it normalized
+    Vec2 tackleDirection = cop->getTackleDirection().getNormalization();
+    Vec2 tacklePosition = cop->getTacklePosition();
+    float tackleTime = cop->getTackleTime();
+    bool tackling = cop->getTackling();
+    bool caughtThief = cop->getCaughtThief();
+    bool tackleSucessful = cop->getTackleSuccessful();
+    
+    float data[MOVEMENT_VALUES] = {
+        position.x, position.y,
+        velocity.x, velocity.y,
+        force.x, force.y,
+        tackleDirection.x, tackleDirection.y,
+        tacklePosition.x, tacklePosition.y,
+        tackleTime,
+        (float) tackling,
+        (float) caughtThief,
+        (float) tackleSucessful
+    };
+    
+    _serializer.writeBits(COP_MOVEMENT, SIGNAL_BITS);
+    _serializer.writeBits(copID, ID_BITS);
+    bool keyframe = writeMovement(_copSchema, _sentMovement[copID], data);
+    
+    // A claim comes with the time (in the clock of the thief) that this peer is showing the thief at
+    bool claim = tackleSucessful || caughtThief;
+    _serializer.writeBits(claim, 1);
+    if (claim) {
+        const SnapshotBuffer& thief = _snapshots[THIEF_STREAM];
+        float view = thief.getDepth() > 0 ? thief.getPlaybackTime() : _clock;
+        _serializer.writeBits((Uint32)(view * 1000), CLOCK_BITS);
+    }
+    return keyframe;
+}
+
+/**
+ * Forgets the keyframes of every movement stream
+ */
+void NetworkController::resetMovement() {
+    _sentMovement.fill(MovementStream());
+    _receivedMovement.fill(MovementStream());
+    _senderClock.fill(0);
+    for (SnapshotBuffer& snapshots : _snapshots) snapshots.clear();
+    _prediction.clear();
+    _acceptedStates.fill(AcceptedState());
+    _thiefHistory.clear();
+}
+
+/**
+ * Remembers the state the host accepted from a client with the tick just read
+ *
+ * The state is the movement of the player the client controls, so a tick without it is ignored.
+ */
+void NetworkController::acceptState(int player) {
+    if (player >= _acceptedStates.size()) return;
+    int number = _players[player].playerNumber;
+    int stream = number == -1 ? THIEF_STREAM : number;
+    if (stream < 0 || stream > THIEF_STREAM || !(_receivedStreams & (1 << stream))) return;
+    const float* values = _receivedMovement[stream].last;
+    _acceptedStates[player] = {
+        _receivedSequence,
+        Vec2(values[POSITION_X], values[POSITION_Y]),
+        Vec2(values[VELOCITY_X], values[VELOCITY_Y]),
+        true
+    };
+}
+
+/**
+ * Reads a sender clock, unwrapping it against the last clock from that sender
+ *
+ * Clocks are sent in milliseconds modulo the clock bits, so the clock closest to the last one
+ * received is the right one.
+ */
+float NetworkController::readClock(int player) {
+    float clock = _deserializer.readBits(CLOCK_BITS) / 1000.0f;
+    if (player >= _senderClock.size()) return clock;
+    clock = unwrapClock(clock, _senderClock[player]);
+    _senderClock[player] = clock;
+    return clock;
+}
+
+/**
+ * Returns the clock (modulo the clock bits) that is closest to the reference clock
+ */
+float NetworkController::unwrapClock(float clock, float reference) {
+    float period = (1 << CLOCK_BITS) / 1000.0f;
+    return clock + floor((reference - clock) / period + 0.5f) * period;
+}
+
+/**
+ * Judges the tackle and catch claimed by a cop against where the thief was when the cop saw it
+ *
+ * The cop saw the thief a round trip (plus the interpolation delay) in the past, so the thief is
+ * rewound to that time rather than judged where the host sees it now. A claim made against a
+ * view older than the lag window is rejected, so that a laggy cop cannot catch a thief that
+ * has long since escaped.
+ */
+void NetworkController::compensate(const std::shared_ptr<GameModel>& game, int copID, float view, float* values) {
+    Vec2 thief;
+    bool known = _thiefHistory.sample(view, _lagWindow, thief);
+    if (values[TACKLE_SUCCESSFUL] != 0) {
+        bool hit = known && CopModel::judgeTackle(Vec2(values[TACKLE_POSITION_X], values[TACKLE_POSITION_Y]),
+                                                  Vec2(values[TACKLE_DIRECTION_X], values[TACKLE_DIRECTION_Y]),
+                                                  thief);
+        if (!hit) _rejectedClaims++;
+        values[TACKLE_SUCCESSFUL] = hit;
+    }
+    if (values[CAUGHT_THIEF] != 0) {
+        float reach = (game->getCop(copID)->getWidth() + game->getThief()->getWidth()) / 2 + CATCH_TOLERANCE;
+        bool caught = known && Vec2(values[POSITION_X], values[POSITION_Y]).distanceSquared(thief) <= reach * reach;
+        if (!caught) _rejectedClaims++;
+        values[CAUGHT_THIEF] = caught;
+    }
+}
+
+/**
+ * Sends a ping carrying the local clock to every peer
+ *
+ * Pings are unreliable, as a resent ping would measure the resend rather than the link.
+ */
+void NetworkController::sendPing() {
+    if (_connection == nullptr || _connection->getStatus() != NetworkConnection::NetStatus::Connected) return;
+    _serializer.writeBits(PING, SIGNAL_BITS);
+    _serializer.writeBits(getPlayerID() ? *getPlayerID() : 0, ID_BITS);
+    _serializer.writeBits((Uint32)(_clock * 1000), PING_CLOCK_BITS);
+    sendSerialized(UNRELIABLE, EVENT_CHANNEL);
+}
+
+/**
+ * Reads the round number and host clock of a round start
+ */
+void NetworkController::readRoundStart() {
+    _receivedRound = _deserializer.readBits(ID_BITS);
+    _roundStart = _deserializer.readBits(PING_CLOCK_BITS) / 1000.0f;
+}
+
+/**
+ * Sends the contents of the serializer with the given reliability and ordering channel
+ */
+void NetworkController::sendSerialized(PacketReliability reliability, uint8_t channel) {
+    const std::vector<uint8_t>& data = _serializer.serialize();
+    countTraffic(_sentTraffic, data.size());
+    _connection->send(data, reliability, channel);
+    _serializer.reset();
+}
+
+/**
+ * Applies a single gameplay message with the given signal to the game, buffering movement
+ *
+ * Returns false if the message is malformed, in which case the rest of the byte vector is unreadable.
+ */
+bool NetworkController::readMessage(const std::shared_ptr<GameModel>& game, int signal) {
+    switch (signal) {
+    case COP_MOVEMENT: {
+        int copID = _deserializer.readBits(ID_BITS);
+        if (copID >= THIEF_STREAM) return false;
+        float data[MOVEMENT_VALUES];
+        const float* values = readMovement(_copSchema, _receivedMovement[copID]);
+        if (values != nullptr) std::copy(values, values + MOVEMENT_VALUES, data);
+        bool claim = _deserializer.readBits(1);
+        float view = claim ? _deserializer.readBits(CLOCK_BITS) / 1000.0f : 0;
+        if (values == nullptr) break;
+        if (claim && _isHost && copID < game->numberOfCops()) {
+            compensate(game, copID, unwrapClock(view, _thiefHistory.getNewestTime()), data);
+        }
+        _snapshots[copID].push(_receivedClock, data);
+        _streamSenders[copID] = _receivedPlayer;
+        _receivedStreams |= 1 << copID;
+        break;
+    }
+    case THIEF_MOVEMENT: {
+        const float* data = readMovement(_thiefSchema, _receivedMovement[THIEF_STREAM]);
+        if (data == nullptr) break;
+        _snapshots[THIEF_STREAM].push(_receivedClock, data);
+        _streamSenders[THIEF_STREAM] = _receivedPlayer;
+        _receivedStreams |= 1 << THIEF_STREAM;
+        if (_isHost) _thiefHistory.record(_receivedClock, Vec2(data[POSITION_X], data[POSITION_Y]));
+        break;
+    }
+    case PLAYER_STATE: {
+        int player = _deserializer.readBits(ID_BITS);
+        Uint16 sequence = _deserializer.readBits(SEQUENCE_BITS);
+        float data[VELOCITY_Y + 1] = {};
+        _stateSchema.read(_deserializer, data);
+        
+        // Every client gets every state, but only its own one matters
+        if (_isHost || !getPlayerID() || player != *getPlayerID()) break;
+        if (_playerNumber >= game->numberOfCops()) break;
+        shared_ptr<PlayerModel> own = _playerNumber == -1
+            ? (shared_ptr<PlayerModel>) game->getThief()
+            : (shared_ptr<PlayerModel>) game->getCop(_playerNumber);
+        _prediction.reconcile(own, sequence, Vec2(data[POSITION_X], data[POSITION_Y]),
+                              Vec2(data[VELOCITY_X], data[VELOCITY_Y]), RECONCILE_THRESHOLD);
+        break;
+    }
+    case PING: {
+        // Answer at once, so that the round trip measures the link rather than our frame
+        int from = _deserializer.readBits(ID_BITS);
+        Uint32 sent = _deserializer.readBits(PING_CLOCK_BITS);
+        _serializer.writeBits(PONG, SIGNAL_BITS);
+        _serializer.writeBits(from, ID_BITS);
+        _serializer.writeBits(getPlayerID() ? *getPlayerID() : 0, ID_BITS);
+        _serializer.writeBits(sent, PING_CLOCK_BITS);
+        _serializer.writeBits((Uint32)(_clock * 1000), PING_CLOCK_BITS);
+        sendSerialized(UNRELIABLE, EVENT_CHANNEL);
+        break;
+    }
+    case PONG: {
+        int to = _deserializer.readBits(ID_BITS);
+        int from = _deserializer.readBits(ID_BITS);
+        float sent = _deserializer.readBits(PING_CLOCK_BITS) / 1000.0f;
+        float remote = _deserializer.readBits(PING_CLOCK_BITS) / 1000.0f;
+        
+        // Every peer gets every pong, but only the ones answering our pings matter
+        if (!getPlayerID() || to != *getPlayerID()) break;
+        _clockSync.sample(from, sent, remote, _clock);
+        break;
+    }
+    case ROUND_START:
+        readRoundStart();
+        break;
+    case TRAP_ACTIVATION:
+        game->activateTrap((int) _deserializer.readBits(TRAP_BITS));
+        break;
+    case GAME_OVER:
+        game->setGameOver(true);
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Counts a packet of the given size towards the traffic of a peer
+ */
+void NetworkController::countTraffic(Traffic& traffic, size_t bytes) {
+    traffic.packets++;
+    traffic.bytes += (int)bytes;
+}
+
+/**
+ * Publishes the traffic rates whenever a one second window completes
+ */
+void NetworkController::updateTraffic(float timestep) {
+    _trafficTime += timestep;
+    if (_trafficTime < 1) return;
+    auto publish = [this](Traffic& traffic) {
+        traffic.packetsPerSecond = traffic.packets / _trafficTime;
+        traffic.bytesPerSecond = traffic.bytes / _trafficTime;
+        traffic.packets = 0;
+        traffic.bytes = 0;
+    };
+    publish(_sentTraffic);
+    for (Traffic& traffic : _receivedTraffic) publish(traffic);
+    _trafficTime = 0;
+}
+
 /**
  * Makes an HTTP request using the given RakString
  */
@@ -465,4 +1018,3 @@ void NetworkController::makeDELETErequest(string endpoint) {
     );
     makeRequest(request);
 }
-
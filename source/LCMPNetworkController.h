@@ -12,6 +12,12 @@
 #include <slikenet/TCPInterface.h>
 #include <slikenet/HTTPConnection2.h>
 #include "LCMPGameModel.h"
+#include "LCMPNetworkSchema.h"
+#include "LCMPSnapshotBuffer.h"
+#include "LCMPPredictionBuffer.h"
+#include "LCMPPositionHistory.h"
+#include "LCMPClockSync.h"
+#include <array>
 
 /**
  * The controller that handles all communication between clients and the server
@@ -47,7 +53,38 @@ public:
         /** What follows is which trap to activate */
         TRAP_ACTIVATION,
         /** This indicates that the game is over (cops won) */
-        GAME_OVER
+        GAME_OVER,
+        /** What follows is the sending player, its clock, its input sequence, the number of messages, and the messages of one network tick */
+        TICK,
+        /** What follows is a player, the input sequence the host accepted, and the position and velocity it accepted */
+        PLAYER_STATE,
+        /** What follows is the sending player and its clock */
+        PING,
+        /** What follows is the player that sent the ping, the answering player, the ping clock, and the answering clock */
+        PONG,
+        /** What follows is the round number and the host clock the round started at */
+        ROUND_START
+    };
+    
+    /** The values of a movement message, in the order of the movement schemas */
+    enum MovementValue {
+        POSITION_X,
+        POSITION_Y,
+        VELOCITY_X,
+        VELOCITY_Y,
+        FORCE_X,
+        FORCE_Y,
+        /** The thief schema ends here, the remaining values are for cops */
+        TACKLE_DIRECTION_X,
+        TACKLE_DIRECTION_Y,
+        TACKLE_POSITION_X,
+        TACKLE_POSITION_Y,
+        TACKLE_TIME,
+        TACKLING,
+        CAUGHT_THIEF,
+        TACKLE_SUCCESSFUL,
+        /** The number of values in a cop movement message */
+        MOVEMENT_VALUES
     };
 
 //  MARK: - Structs
@@ -59,6 +96,44 @@ public:
         string username;
     };
     
+    /** The delta encoding state of the movement messages of one player */
+    struct MovementStream {
+        /** The values of the last keyframe (a message with every field) */
+        float keyframe[MOVEMENT_VALUES];
+        /** The values of the last message */
+        float last[MOVEMENT_VALUES];
+        /** The sequence number of the last keyframe */
+        uint8_t keyframeID;
+        /** Whether a keyframe has been sent or received yet */
+        bool hasKeyframe;
+        /** The number of messages sent since the last keyframe */
+        int sinceKeyframe;
+    };
+    
+    /** The last state the host accepted from a client */
+    struct AcceptedState {
+        /** The input sequence of the client when it sent the state */
+        Uint16 sequence;
+        /** The position of the client player */
+        cugl::Vec2 position;
+        /** The velocity of the client player */
+        cugl::Vec2 velocity;
+        /** Whether the state has not been sent back to the client yet */
+        bool pending;
+    };
+    
+    /** The network traffic of a peer, measured over one second windows */
+    struct Traffic {
+        /** The packets counted in the current window */
+        int packets;
+        /** The bytes counted in the current window */
+        int bytes;
+        /** The packets per second over the last complete window */
+        float packetsPerSecond;
+        /** The bytes per second over the last complete window */
+        float bytesPerSecond;
+    };
+    
 protected:
 //  MARK: - Properties
     
@@ -70,6 +145,8 @@ protected:
     cugl::NetworkConnection::ConnectionConfig _config;
     /** The network connection (as made by this scene) */
     std::shared_ptr<cugl::NetworkConnection> _connection;
+    /** The in-process network to connect through instead of the server, if any */
+    std::shared_ptr<cugl::LoopbackNetwork> _loopback;
     /** A reference to the HTTP Connection */
     SLNet::HTTPConnection2* _http;
     /** A reference to the TCP Interface */
@@ -86,6 +163,79 @@ protected:
     /** Whether the host decides this player is the thief or not */
     int _playerNumber;
     
+    /** The layout of a cop movement message */
+    NetworkSchema _copSchema;
+    /** The layout of a thief movement message */
+    NetworkSchema _thiefSchema;
+    /** The movement messages sent for each cop (by cop ID), and then the thief */
+    std::array<MovementStream, 5> _sentMovement;
+    /** The movement messages received for each cop (by cop ID), and then the thief */
+    std::array<MovementStream, 5> _receivedMovement;
+    
+    /** The number of network ticks per second */
+    float _tickRate;
+    /** The time since the last network tick */
+    float _tickTime;
+    /** Whether each movement stream (cops by ID, then the thief) is sent with the next tick */
+    std::array<bool, 5> _pendingMovement;
+    /** The movement force of each movement stream to send with the next tick */
+    std::array<cugl::Vec2, 5> _pendingForce;
+    /** The traps activated since the last tick */
+    std::vector<int> _pendingTraps;
+    
+    /** The traffic sent by this peer */
+    Traffic _sentTraffic;
+    /** The traffic received from each peer (by player ID) */
+    std::array<Traffic, 5> _receivedTraffic;
+    /** The time since the start of the current traffic window */
+    float _trafficTime;
+    
+    /** The time since this peer connected, sent with every tick */
+    float _clock;
+    /** The clock of the tick being read */
+    float _receivedClock;
+    /** The last clock received from each peer (by player ID), used to unwrap the clocks */
+    std::array<float, 5> _senderClock;
+    /** The buffered snapshots of each remote cop (by cop ID), and then the thief */
+    std::array<SnapshotBuffer, 5> _snapshots;
+    /** How far (in seconds) remote players are shown behind their newest snapshot */
+    float _interpolationDelay;
+    
+    /** The layout of a player state message (a position and a velocity) */
+    NetworkSchema _stateSchema;
+    /** The inputs of the local player that the host has not accepted yet */
+    PredictionBuffer _prediction;
+    /** The input sequence of the tick being read */
+    Uint16 _receivedSequence;
+    /** The movement streams (as bits) found in the tick being read */
+    int _receivedStreams;
+    /** The last state accepted from each client (by player ID) */
+    std::array<AcceptedState, 5> _acceptedStates;
+    /** The number of ticks since the accepted states were last sent back */
+    int _ticksSinceState;
+    
+    /** The recent positions of the thief, by the clock of the peer controlling it (host only) */
+    PositionHistory _thiefHistory;
+    /** How far back (in seconds) the host will rewind the thief to judge a cop */
+    float _lagWindow;
+    /** The number of tackles and catches the host has rejected */
+    int _rejectedClaims;
+    
+    /** The clock offset and round trip time to every peer (by player ID) */
+    ClockSync _clockSync;
+    /** The time since the last ping */
+    float _pingTime;
+    /** The player that sent the tick being read */
+    int _receivedPlayer;
+    /** The player that last sent each movement stream (cops by ID, then the thief) */
+    std::array<int, 5> _streamSenders;
+    /** The number of rounds started since connecting, wrapped to the bits a round start sends */
+    int _round;
+    /** The last round started by the host, or -1 if there is none */
+    int _receivedRound;
+    /** The host clock that the last round started at */
+    float _roundStart;
+    
 public:
 //  MARK: - Constructors
     
@@ -166,6 +316,16 @@ public:
      */
     std::string getLevel() { return _level; }
     
+    /**
+     * Returns the in-process network that connections are made through instead of the server, if any
+     */
+    const std::shared_ptr<cugl::LoopbackNetwork>& getLoopback() const { return _loopback; }
+    
+    /**
+     * Sets the in-process network that connections are made through instead of the server
+     */
+    void setLoopback(const std::shared_ptr<cugl::LoopbackNetwork>& loopback) { _loopback = loopback; }
+    
     /**
      * Establishes a host connection with the server
      */
@@ -201,22 +361,128 @@ public:
     
 //  MARK: - Gameplay
 
+    /**
+     * Sets the bounds of the map, which positions in movement messages are quantized to
+     */
+    void setMapBounds(cugl::Rect bounds);
+    
+    /**
+     * Returns the number of network ticks per second
+     */
+    float getTickRate() const { return _tickRate; }
+    
+    /**
+     * Sets the number of network ticks per second
+     */
+    void setTickRate(float value) { _tickRate = value; }
+    
+    /**
+     * Returns the traffic sent by this peer
+     */
+    const Traffic& getSentTraffic() const { return _sentTraffic; }
+    
+    /**
+     * Returns the traffic received from the peer with the given player ID
+     */
+    const Traffic& getReceivedTraffic(int playerID) const { return _receivedTraffic[playerID]; }
+    
+    /**
+     * Returns how far (in seconds) remote players are shown behind their newest snapshot
+     */
+    float getInterpolationDelay() const { return _interpolationDelay; }
+    
+    /**
+     * Sets how far (in seconds) remote players are shown behind their newest snapshot
+     */
+    void setInterpolationDelay(float value) { _interpolationDelay = value; }
+    
+    /**
+     * Returns the snapshot buffer of a cop (by cop ID), or of the thief after the cops
+     */
+    const SnapshotBuffer& getSnapshots(int stream) const { return _snapshots[stream]; }
+    
     /**
      * Checks the connection, updates the status accordingly, and updates the game (during game)
      */
     void update(std::shared_ptr<GameModel>& game);
+    
+    /**
+     * Moves the remote players to their buffered snapshots, a short delay behind the newest
+     */
+    void interpolate(std::shared_ptr<GameModel>& game, float timestep);
+    
+    /**
+     * Records an input that was just applied to the local player, so that it can be replayed
+     */
+    void recordInput(const std::shared_ptr<PlayerModel>& player, cugl::Vec2 movement, bool tackling, float timestep);
+    
+    /**
+     * Returns the inputs of the local player that the host has not accepted yet
+     */
+    const PredictionBuffer& getPrediction() const { return _prediction; }
+    
+    /**
+     * Returns how far back (in seconds) the host will rewind the thief to judge a cop
+     */
+    float getLagWindow() const { return _lagWindow; }
+    
+    /**
+     * Sets how far back (in seconds) the host will rewind the thief to judge a cop
+     */
+    void setLagWindow(float value) { _lagWindow = value; }
+    
+    /**
+     * Returns the number of tackles and catches the host has rejected
+     */
+    int getRejectedClaims() const { return _rejectedClaims; }
+    
+    /**
+     * Returns the clock shared by every peer (the clock of the host), or the local clock until it is synced
+     */
+    float getMatchTime() const;
+    
+    /**
+     * Returns true iff the offset to the host clock is known (always true for the host)
+     */
+    bool isClockSynced() const { return _isHost || _clockSync.isSynced(0); }
+    
+    /**
+     * Returns the smoothed round trip time (in seconds) to the peer with the given player ID
+     */
+    float getRTT(int playerID) const { return _clockSync.isSynced(playerID) ? _clockSync.getRTT(playerID) : 0; }
+    
+    /**
+     * Starts a new round, which the host announces with its clock
+     */
+    void startRound();
+    
     /**
-     * Sends a byte vector to update thief movement
+     * Returns true iff the round being played has a start time on the match clock
      */
-    void sendThiefMovement(std::shared_ptr<GameModel>& game, cugl::Vec2 force);
+    bool hasRoundClock() const { return isClockSynced() && _receivedRound == _round; }
     
     /**
-     * Sends a byte vector to update thief movement
+     * Returns the time (in seconds) since the round started, on the match clock
      */
-    void sendCopMovement(std::shared_ptr<GameModel>& game, cugl::Vec2 force, int copID);
+    float getRoundTime() const { return getMatchTime() - _roundStart; }
     
     /**
-     * Sends a byte vector to activate a trap
+     * Sends everything queued since the last tick as one byte vector, if it is time for a tick
+     */
+    void sendTick(std::shared_ptr<GameModel>& game, float timestep);
+    
+    /**
+     * Queues the thief movement to be sent with the next tick
+     */
+    void sendThiefMovement(cugl::Vec2 force);
+    
+    /**
+     * Queues a cop movement to be sent with the next tick
+     */
+    void sendCopMovement(cugl::Vec2 force, int copID);
+    
+    /**
+     * Queues a trap activation to be sent with the next tick
      */
     void sendTrapActivation(int trapID);
     
@@ -255,6 +521,86 @@ public:
 private:
 //  MARK: - Helpers
     
+    /**
+     * Writes a movement message body, as a keyframe or as a delta from the last keyframe
+     *
+     * Returns true iff the body is a keyframe.
+     */
+    bool writeMovement(const NetworkSchema& schema, MovementStream& stream, const float* values);
+    
+    /**
+     * Reads a movement message body, returning the values of the player after it (or nullptr if
+     * it is a delta against a keyframe that has not arrived)
+     */
+    const float* readMovement(const NetworkSchema& schema, MovementStream& stream);
+    
+    /**
+     * Forgets the keyframes of every movement stream
+     */
+    void resetMovement();
+    
+    /**
+     * Remembers the state the host accepted from a client with the tick just read
+     */
+    void acceptState(int player);
+    
+    /**
+     * Judges the tackle and catch claimed by a cop against where the thief was when the cop saw it
+     */
+    void compensate(const std::shared_ptr<GameModel>& game, int copID, float view, float* values);
+    
+    /**
+     * Returns the clock (modulo the clock bits) that is closest to the reference clock
+     */
+    static float unwrapClock(float clock, float reference);
+    
+    /**
+     * Reads a sender clock, unwrapping it against the last clock from that sender
+     */
+    float readClock(int player);
+    
+    /**
+     * Sends a ping carrying the local clock to every peer
+     */
+    void sendPing();
+    
+    /**
+     * Reads the round number and host clock of a round start
+     */
+    void readRoundStart();
+    
+    /**
+     * Sends the contents of the serializer with the given reliability and ordering channel
+     */
+    void sendSerialized(PacketReliability reliability, uint8_t channel);
+    
+    /**
+     * Writes a thief movement message, returning true iff it is a keyframe
+     */
+    bool writeThiefMovement(const std::shared_ptr<ThiefModel>& thief, cugl::Vec2 force);
+    
+    /**
+     * Writes a cop movement message, returning true iff it is a keyframe
+     */
+    bool writeCopMovement(const std::shared_ptr<CopModel>& cop, cugl::Vec2 force, int copID);
+    
+    /**
+     * Applies a single gameplay message with the given signal to the game, buffering movement
+     *
+     * Returns false if the message is malformed, in which case the rest of the byte vector is unreadable.
+     */
+    bool readMessage(const std::shared_ptr<GameModel>& game, int signal);
+    
+    /**
+     * Counts a packet of the given size towards the traffic of a peer
+     */
+    void countTraffic(Traffic& traffic, size_t bytes);
+    
+    /**
+     * Publishes the traffic rates whenever a one second window completes
+     */
+    void updateTraffic(float timestep);
+    
     /**
      * Makes an HTTP request using the given RakString
      */
@@ -0,0 +1,103 @@
+//
+//  LCMPNetworkSchema.cpp
+//  Low Control Mall Patrol
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#include "LCMPNetworkSchema.h"
+
+using namespace cugl;
+
+//  MARK: - Constructors
+
+/**
+ * Initializes a Network Schema with the given fields
+ */
+bool NetworkSchema::init(const std::vector<Field>& fields) {
+    _fields = fields;
+    _offsets.clear();
+    _width = 0;
+    for (const Field& field : _fields) {
+        CUAssertLog(field.components == 1 || field.components == 2, "Fields have one or two components");
+        _offsets.push_back(_width);
+        _width += field.components;
+    }
+    return true;
+}
+
+/**
+ * Returns a field whose range is centered on zero, nudged so that zero is a quantized value
+ */
+NetworkSchema::Field NetworkSchema::makeSymmetric(int components, int bits, Vec2 range) {
+    // An odd number of levels puts one on zero, so spread the even count over a slightly larger range
+    float levels = (float)((1u << bits) - 1);
+    Vec2 step = range * 2 / (levels - 1);
+    return {components, bits, -range, -range + step * levels};
+}
+
+//  MARK: - Methods
+
+/**
+ * Writes the values to the serializer, leaving out the fields that are unchanged from the baseline
+ *
+ * If the baseline is nullptr, every field is written.
+ */
+void NetworkSchema::write(NetworkSerializer& serializer, const float* values, const float* baseline) const {
+    // The presence mask comes first so the reader knows which fields follow
+    bool present[32];
+    CUAssertLog(_fields.size() <= 32, "Too many fields in schema");
+    for (int ii = 0; ii < _fields.size(); ii++) {
+        present[ii] = baseline == nullptr || !isUnchanged(ii, values, baseline);
+        serializer.writeBits(present[ii], 1);
+    }
+
+    for (int ii = 0; ii < _fields.size(); ii++) {
+        if (!present[ii]) continue;
+        const Field& field = _fields[ii];
+        const float* value = values + _offsets[ii];
+        serializer.writeQuantized(value[0], field.min.x, field.max.x, field.bits);
+        if (field.components == 2) serializer.writeQuantized(value[1], field.min.y, field.max.y, field.bits);
+    }
+}
+
+/**
+ * Reads a message from the deserializer, overwriting only the values of the fields it contains
+ *
+ * The level nearest zero always reads back as exactly zero, so that idle players stay idle.
+ */
+void NetworkSchema::read(NetworkDeserializer& deserializer, float* values) const {
+    Uint32 mask = deserializer.readBits((int)_fields.size());
+    for (int ii = 0; ii < _fields.size(); ii++) {
+        if (!(mask & (1 << ii))) continue;
+        const Field& field = _fields[ii];
+        float* value = values + _offsets[ii];
+        value[0] = readComponent(deserializer, field.min.x, field.max.x, field.bits);
+        if (field.components == 2) value[1] = readComponent(deserializer, field.min.y, field.max.y, field.bits);
+    }
+}
+
+//  MARK: - Helpers
+
+/**
+ * Returns true iff a field has the same quantized value in both value arrays
+ */
+bool NetworkSchema::isUnchanged(int field, const float* values, const float* baseline) const {
+    const Field& f = _fields[field];
+    int offset = _offsets[field];
+    if (NetworkSerializer::quantize(values[offset], f.min.x, f.max.x, f.bits) !=
+        NetworkSerializer::quantize(baseline[offset], f.min.x, f.max.x, f.bits)) return false;
+    return f.components == 1 ||
+        NetworkSerializer::quantize(values[offset + 1], f.min.y, f.max.y, f.bits) ==
+        NetworkSerializer::quantize(baseline[offset + 1], f.min.y, f.max.y, f.bits);
+}
+
+/**
+ * Returns a component read from the deserializer, where the level nearest zero reads as exactly zero
+ */
+float NetworkSchema::readComponent(NetworkDeserializer& deserializer, float min, float max, int bits) {
+    Uint32 value = deserializer.readBits(bits);
+    if (value == NetworkSerializer::quantize(0, min, max, bits)) return 0;
+    return NetworkDeserializer::dequantize(value, min, max, bits);
+}
@@ -0,0 +1,103 @@
+//
+//  LCMPNetworkSchema.h
+//  Low Control Mall Patrol
+//
+//  This class describes the layout of a packed network message as a list of
+//  quantized fields. A message starts with one bit per field saying whether
+//  the field is present, and a field is left out when it has not changed
+//  (at the precision it is sent with) since a baseline the receiver has.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#ifndef __LCMP_NETWORK_SCHEMA_H__
+#define __LCMP_NETWORK_SCHEMA_H__
+#include <cugl/cugl.h>
+
+class NetworkSchema {
+public:
+//  MARK: - Structs
+
+    /** A quantized field of one or two components (such as a position) */
+    struct Field {
+        /** The number of values in the field (1 or 2) */
+        int components;
+        /** The number of bits per component */
+        int bits;
+        /** The minimum value of each component (only x is used for scalars) */
+        cugl::Vec2 min;
+        /** The maximum value of each component (only x is used for scalars) */
+        cugl::Vec2 max;
+    };
+
+protected:
+//  MARK: - Properties
+
+    /** The fields of the message, in order */
+    std::vector<Field> _fields;
+    /** The index of the first value of each field */
+    std::vector<int> _offsets;
+    /** The total number of values in a message */
+    int _width;
+
+public:
+//  MARK: - Constructors
+
+    /**
+     * Constructs a Network Schema
+     */
+    NetworkSchema() : _width(0) {}
+
+    /**
+     * Initializes a Network Schema with the given fields
+     */
+    bool init(const std::vector<Field>& fields);
+
+    /**
+     * Returns a field whose range is centered on zero, nudged so that zero is a quantized value
+     */
+    static Field makeSymmetric(int components, int bits, cugl::Vec2 range);
+
+//  MARK: - Methods
+
+    /**
+     * Returns the total number of values in a message
+     */
+    int getWidth() const { return _width; }
+
+    /**
+     * Returns the number of fields in a message
+     */
+    int getFieldCount() const { return (int)_fields.size(); }
+
+    /**
+     * Writes the values to the serializer, leaving out the fields that are unchanged from the baseline
+     *
+     * If the baseline is nullptr, every field is written.
+     */
+    void write(cugl::NetworkSerializer& serializer, const float* values, const float* baseline) const;
+
+    /**
+     * Reads a message from the deserializer, overwriting only the values of the fields it contains
+     *
+     * The level nearest zero always reads back as exactly zero, so that idle players stay idle.
+     */
+    void read(cugl::NetworkDeserializer& deserializer, float* values) const;
+
+private:
+//  MARK: - Helpers
+
+    /**
+     * Returns true iff a field has the same quantized value in both value arrays
+     */
+    bool isUnchanged(int field, const float* values, const float* baseline) const;
+
+    /**
+     * Returns a component read from the deserializer, where the level nearest zero reads as exactly zero
+     */
+    static float readComponent(cugl::NetworkDeserializer& deserializer, float min, float max, int bits);
+
+};
+
+#endif /* __LCMP_NETWORK_SCHEMA_H__ */
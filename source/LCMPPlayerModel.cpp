@@ -7,6 +7,7 @@
 //
 
 #include "LCMPPlayerModel.h"
+#include "LCMPEntityTag.h"
 
 /** The density of this player */
 #define DEFAULT_DENSITY 1.0f
@@ -14,6 +15,10 @@
 #define DEFAULT_FRICTION 0.4f
 /** The restitution of this player */
 #define DEFAULT_RESTITUTION 0.4f
+/** How quickly (per second) a proxy closes the distance to its network position */
+#define PROXY_GAIN 10.0f
+/** How far (in Box2D units) a proxy may be from its network position before it jumps there */
+#define PROXY_SNAP 2.0f
 
 using namespace cugl;
 
@@ -39,6 +44,10 @@ bool PlayerModel::init(int playerNumber, const Vec2 pos, const Size size, float
     // Save the player number
     _playerNumber = playerNumber;
     
+    // Tag the fixtures so collisions can identify this player
+    setUserData(playerNumber < 0 ? EntityTag::encode(EntityTag::Thief)
+                                 : EntityTag::encode(EntityTag::Cop, playerNumber));
+    
     // Set collision sound
     _collisionSound  = "";
     
@@ -51,14 +60,16 @@ bool PlayerModel::init(int playerNumber, const Vec2 pos, const Size size, float
     // Save action manager
     _actions = actions;
     
-    // Add a dropshadow node
-    PolyFactory pf;
-    Poly2 shadow = pf.makeCapsule(pos * scale, size * scale);
-    _dropshadow = scene2::PolygonNode::allocWithPoly(shadow);
-    _dropshadow->setAnchor(Vec2::ANCHOR_CENTER);
-    _dropshadow->setPosition(Vec2::ZERO);
-    _dropshadow->setColor(Color4(Vec4(0,0,0,0.25f)));
-    _node->addChild(_dropshadow);
+    // Add a dropshadow node (unless the player is headless)
+    if (_node != nullptr) {
+        PolyFactory pf;
+        Poly2 shadow = pf.makeCapsule(pos * scale, size * scale);
+        _dropshadow = scene2::PolygonNode::allocWithPoly(shadow);
+        _dropshadow->setAnchor(Vec2::ANCHOR_CENTER);
+        _dropshadow->setPosition(Vec2::ZERO);
+        _dropshadow->setColor(Color4(Vec4(0,0,0,0.25f)));
+        _node->addChild(_dropshadow);
+    }
     
     // Create animations
     for (int i = 0; i < _animFrames.size(); i++) {
@@ -93,6 +104,9 @@ void PlayerModel::dispose() {
  * Sets the username of this player
  */
 void PlayerModel::setName(string name, const shared_ptr<Font>& font) {
+    // Replace the old username node if there is one
+    if (_username != nullptr) _username->removeFromParent();
+    
     // Add a username node
     // TODO: clean this up
     _username = scene2::Label::allocWithText(name, font);
@@ -143,6 +157,7 @@ void PlayerModel::applyForce(cugl::Vec2 force) {
                 break;
             case TrapModel::TrapType::Teleport:
                 setPosition(Vec2(std::get<1>(elem)->x, std::get<1>(elem)->y));
+                _snapPosition = true;
                 break;
             case TrapModel::TrapType::Moving_Platform:
                 _realbody->SetLinearVelocity(b2Vec2(b2velocity.x + std::get<1>(elem)->x, b2velocity.y + std::get<1>(elem)->y));
@@ -162,6 +177,7 @@ void PlayerModel::applyForce(cugl::Vec2 force) {
 
     if (std::get<0>(teleportFlag)) {
         setPosition(Vec2(std::get<1>(teleportFlag)));
+        _snapPosition = true;
     }
 
     if (std::get<0>(stairsFlag)) {
@@ -254,13 +270,62 @@ void PlayerModel::unact(int trapID, std::shared_ptr<TrapModel::Effect> effect) {
     //TODO: Apply any lingering effects on the player
 }
 
+/**
+ * Sets whether this player is a kinematic proxy driven by network updates
+ *
+ * A proxy ignores forces, but still collides with the dynamic players of this peer, so that
+ * the local tackles and catches against it are still detected.
+ */
+void PlayerModel::setProxy(bool value) {
+    // Compare with the body itself, as restoring a snapshot puts back the body type of the round start
+    b2BodyType type = value ? b2_kinematicBody : b2_dynamicBody;
+    _proxy = value;
+    if (getBodyType() == type) return;
+    setBodyType(type);
+}
+
 /**
  * Updates the position and velocity of the player (most likely for network updates)
+ *
+ * A proxy is steered towards the position with its velocity rather than moved there, so that
+ * its broadphase proxies and contacts are left alone. Only a large jump (such as a teleport)
+ * moves it directly.
  */
 void PlayerModel::applyNetwork(cugl::Vec2 position, cugl::Vec2 velocity, cugl::Vec2 force) {
-    setLinearVelocity(velocity);
-    setPosition(position);
-    applyForce(force);
+    if (!_proxy) {
+        setLinearVelocity(velocity);
+        setPosition(position);
+        applyForce(force);
+        _snapPosition = true;
+        return;
+    }
+    
+    Vec2 error = position - getPosition();
+    if (error.lengthSquared() > PROXY_SNAP * PROXY_SNAP) {
+        setPosition(position);
+        error = Vec2::ZERO;
+        _snapPosition = true;
+    }
+    setLinearVelocity(velocity + error * PROXY_GAIN);
+    
+    // Save the force for animations later
+    _movement = force;
+}
+
+/**
+ * Advances a position and velocity of this player by one step under a force, ignoring collisions
+ *
+ * This mirrors {@link applyForce} followed by a physics step, so that inputs can be replayed.
+ */
+void PlayerModel::predict(Vec2& position, Vec2& velocity, Vec2 force, float timestep) {
+    Vec2 push = force * getAcceleration() - velocity * getDamping();
+    velocity += push * (timestep / getMass());
+    position += velocity * timestep;
+    
+    // The next force clamps the speed before it is integrated
+    if (velocity.lengthSquared() >= getMaxSpeed() * getMaxSpeed()) {
+        velocity = velocity.getNormalization() * getMaxSpeed();
+    }
 }
 
 /**
@@ -269,12 +334,43 @@ void PlayerModel::applyNetwork(cugl::Vec2 position, cugl::Vec2 velocity, cugl::V
 void PlayerModel::update(float timestep) {
     cugl::physics2::SimpleObstacle::update(timestep);
     
+    Vec2 position(_drawbody->GetPosition().x, _drawbody->GetPosition().y);
+    _lastPosition = _snapPosition ? position : _nextPosition;
+    _nextPosition = position;
+    _snapPosition = false;
     if (_node != nullptr) {
-        Vec2 position(_drawbody->GetPosition().x, _drawbody->GetPosition().y);
         _node->setPosition(position * _scale);
     }
 }
 
+/**
+ * Draws the player the given fraction of the way from its last position to its current one
+ *
+ * The game is simulated in fixed steps, so a frame usually falls between two of them.
+ */
+void PlayerModel::interpolate(float alpha) {
+    if (_node != nullptr) {
+        _node->setPosition(_lastPosition.getLerp(_nextPosition, alpha) * _scale);
+    }
+}
+
+/**
+ * Clears all trap effects and movement so the player can start a new round
+ *
+ * The body itself is restored by the physics world snapshot.
+ */
+void PlayerModel::reset() {
+    playerEffects.clear();
+    _dampingMultiplier = Vec2(1.0f, 1.0f);
+    _maxSpeedMultiplier = 1.0f;
+    _accelerationMultiplier = Vec2(1.0f, 1.0f);
+    _movement = Vec2::ZERO;
+    teleportFlag = make_tuple(false, Vec2::ZERO);
+    stairsFlag = make_tuple(false, Vec2::ZERO);
+    escalatorFlag = make_tuple(false, Vec2::ZERO);
+    _snapPosition = true;
+}
+
 /** Returns player animation key */
 int PlayerModel::findDirection(Vec2 movement) {
     if (abs(movement.x) >= abs(movement.y)) {
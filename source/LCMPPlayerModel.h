@@ -62,6 +62,14 @@ protected:
     cugl::Vec2 _accelerationMultiplier  = cugl::Vec2(1.0f, 1.0f);
     /** The last force applied to this player */
     cugl::Vec2 _movement;
+    /** Whether this player is a kinematic proxy driven by network updates */
+    bool _proxy = false;
+    /** The body position before the last physics step, which drawing starts from */
+    cugl::Vec2 _lastPosition;
+    /** The body position after the last physics step, which drawing ends at */
+    cugl::Vec2 _nextPosition;
+    /** Whether the last position should be skipped, as the player jumped there */
+    bool _snapPosition = true;
     
     /** The ratio to scale the textures. (SCENE UNITS / WORLD UNITS) */
     float _scale;
@@ -209,15 +217,40 @@ public:
      */
     void applyForce(cugl::Vec2 force);
     
+    /**
+     * Returns true iff this player is a kinematic proxy driven by network updates
+     */
+    bool isProxy() const { return _proxy; }
+    
+    /**
+     * Sets whether this player is a kinematic proxy driven by network updates
+     */
+    void setProxy(bool value);
+    
     /**
      * Updates the position and velocity of the player (most likely for network updates)
      */
     void applyNetwork(cugl::Vec2 position, cugl::Vec2 velocity, cugl::Vec2 force);
     
+    /**
+     * Advances a position and velocity of this player by one step under a force, ignoring collisions
+     */
+    void predict(cugl::Vec2& position, cugl::Vec2& velocity, cugl::Vec2 force, float timestep);
+    
     /**
      * Updates the player node based on this player's body
      */
     void update(float timestep) override;
+
+    /**
+     * Draws the player the given fraction of the way from its last position to its current one
+     */
+    void interpolate(float alpha);
+    
+    /**
+     * Clears all trap effects and movement so the player can start a new round
+     */
+    virtual void reset();
     
     /**
      * Performs a film strip action
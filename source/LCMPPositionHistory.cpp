@@ -0,0 +1,65 @@
+//
+//  LCMPPositionHistory.cpp
+//  Low Control Mall Patrol
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#include "LCMPPositionHistory.h"
+
+using namespace cugl;
+
+//  MARK: - Constructors
+
+/**
+ * Initializes a Position History holding up to the given number of positions
+ */
+bool PositionHistory::init(int capacity) {
+    _times.assign(capacity, 0);
+    _positions.assign(capacity, Vec2::ZERO);
+    clear();
+    return capacity > 0;
+}
+
+//  MARK: - Methods
+
+/**
+ * Adds a position at the given time, ignoring it if it is older than the newest
+ */
+void PositionHistory::record(float time, Vec2 position) {
+    if (_times.empty()) return;
+    if (_count > 0 && time <= getNewestTime()) return;
+    if (_count == _times.size()) {
+        _head = slot(1);
+        _count--;
+    }
+    int index = slot(_count);
+    _times[index] = time;
+    _positions[index] = position;
+    _count++;
+}
+
+/**
+ * Returns true iff there is a position at the given time, storing it in position
+ *
+ * Times between two positions are interpolated, and times after the newest position are
+ * clamped to it. Times more than window seconds before the newest position are too old to
+ * be judged, and so are times before the oldest position.
+ */
+bool PositionHistory::sample(float time, float window, Vec2& position) const {
+    if (_count == 0 || time < getNewestTime() - window || time < _times[_head]) return false;
+    if (time >= getNewestTime()) {
+        position = _positions[slot(_count - 1)];
+        return true;
+    }
+
+    // Search back from the newest, as recent times are the common case
+    int ii = _count - 2;
+    while (_times[slot(ii)] > time) ii--;
+    int from = slot(ii);
+    int to = slot(ii + 1);
+    float alpha = (time - _times[from]) / (_times[to] - _times[from]);
+    position = _positions[from] + (_positions[to] - _positions[from]) * alpha;
+    return true;
+}
@@ -0,0 +1,85 @@
+//
+//  LCMPPositionHistory.h
+//  Low Control Mall Patrol
+//
+//  This class keeps the recent positions of a player, keyed by the clock of
+//  the peer that controls it. The host uses the history of the thief to see
+//  where the thief was when a cop saw it, so that claims made against a view
+//  that is a round trip stale can still be judged fairly.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#ifndef __LCMP_POSITION_HISTORY_H__
+#define __LCMP_POSITION_HISTORY_H__
+#include <cugl/cugl.h>
+
+class PositionHistory {
+protected:
+//  MARK: - Properties
+
+    /** The time of each position in the ring */
+    std::vector<float> _times;
+    /** The positions, as a ring */
+    std::vector<cugl::Vec2> _positions;
+    /** The index of the oldest position in the ring */
+    int _head;
+    /** The number of positions in the ring */
+    int _count;
+
+public:
+//  MARK: - Constructors
+
+    /**
+     * Constructs a Position History
+     */
+    PositionHistory() : _head(0), _count(0) {}
+
+    /**
+     * Initializes a Position History holding up to the given number of positions
+     */
+    bool init(int capacity);
+
+//  MARK: - Methods
+
+    /**
+     * Forgets every position
+     */
+    void clear() { _head = 0; _count = 0; }
+
+    /**
+     * Adds a position at the given time, ignoring it if it is older than the newest
+     */
+    void record(float time, cugl::Vec2 position);
+
+    /**
+     * Returns true iff there is a position at the given time, storing it in position
+     *
+     * Times between two positions are interpolated, and times after the newest position are
+     * clamped to it. Times more than window seconds before the newest position are too old to
+     * be judged, and so are times before the oldest position.
+     */
+    bool sample(float time, float window, cugl::Vec2& position) const;
+
+    /**
+     * Returns the time of the newest position, or 0 if there are none
+     */
+    float getNewestTime() const { return _count == 0 ? 0 : _times[slot(_count - 1)]; }
+
+    /**
+     * Returns the number of positions in the history
+     */
+    int getDepth() const { return _count; }
+
+private:
+//  MARK: - Helpers
+
+    /**
+     * Returns the ring index of the position that is the given number of positions after the oldest
+     */
+    int slot(int offset) const { return (_head + offset) % (int)_times.size(); }
+
+};
+
+#endif /* __LCMP_POSITION_HISTORY_H__ */
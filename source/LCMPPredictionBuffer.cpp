@@ -0,0 +1,77 @@
+//
+//  LCMPPredictionBuffer.cpp
+//  Low Control Mall Patrol
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#include "LCMPPredictionBuffer.h"
+
+using namespace cugl;
+
+//  MARK: - Constructors
+
+/**
+ * Initializes a Prediction Buffer holding up to the given number of inputs
+ */
+bool PredictionBuffer::init(int capacity) {
+    _inputs.assign(capacity, Input());
+    _next = 0;
+    _corrections = 0;
+    clear();
+    return capacity > 0;
+}
+
+//  MARK: - Methods
+
+/**
+ * Records an input applied in the given state, returning its sequence number
+ *
+ * When the host falls too far behind, the oldest input is forgotten and can no longer be reconciled.
+ */
+Uint16 PredictionBuffer::record(Vec2 movement, bool tackling, float timestep, Vec2 position, Vec2 velocity) {
+    if (_inputs.empty()) return _next++;
+    if (_count == _inputs.size()) {
+        _head = (_head + 1) % _inputs.size();
+        _count--;
+    }
+    _count++;
+    at(_count - 1) = {_next, movement, tackling, timestep, position, velocity};
+    return _next++;
+}
+
+/**
+ * Compares the host state for an input with the prediction, rewinding and replaying on a mismatch
+ *
+ * The inputs before the acknowledged one are dropped. Tackles are scripted motion rather than
+ * forces, so while one is pending the prediction is trusted instead.
+ *
+ * Returns true iff the player was corrected.
+ */
+bool PredictionBuffer::reconcile(const std::shared_ptr<PlayerModel>& player, Uint16 sequence,
+                                 Vec2 position, Vec2 velocity, float threshold) {
+    // Sequence numbers wrap, so compare them by their difference
+    while (_count > 0 && (Sint16)(at(0).sequence - sequence) < 0) {
+        _head = (_head + 1) % _inputs.size();
+        _count--;
+    }
+    if (_count == 0 || at(0).sequence != sequence) return false;
+    _lastError = at(0).position.distance(position);
+    if (_lastError <= threshold) return false;
+    for (int ii = 0; ii < _count; ii++) {
+        if (at(ii).tackling) return false;
+    }
+
+    // Rewind to the host state, and replay every input since to get back to the present
+    for (int ii = 0; ii < _count; ii++) {
+        Input& input = at(ii);
+        input.position = position;
+        input.velocity = velocity;
+        if (ii < _count - 1) player->predict(position, velocity, input.movement, input.timestep);
+    }
+    player->setPosition(position);
+    player->setLinearVelocity(velocity);
+    _corrections++;
+    return true;
+}
@@ -0,0 +1,120 @@
+//
+//  LCMPPredictionBuffer.h
+//  Low Control Mall Patrol
+//
+//  This class keeps the recent inputs of the local player, numbered in
+//  sequence, together with the state the player was in when each was applied.
+//  Inputs are applied immediately, so the player never waits on the network.
+//  When the host reports the state it accepted for an input, the buffer
+//  compares it with the prediction; if they disagree, the player is rewound to
+//  the host state and the inputs since are replayed.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#ifndef __LCMP_PREDICTION_BUFFER_H__
+#define __LCMP_PREDICTION_BUFFER_H__
+#include <cugl/cugl.h>
+#include "LCMPPlayerModel.h"
+
+class PredictionBuffer {
+public:
+//  MARK: - Structs
+
+    /** An input of the local player, and the state it was applied in */
+    struct Input {
+        /** The sequence number of the input */
+        Uint16 sequence;
+        /** The movement force (joystick) */
+        cugl::Vec2 movement;
+        /** Whether the player swiped or was mid tackle, which is not replayed */
+        bool tackling;
+        /** The length of the frame the input was applied for */
+        float timestep;
+        /** The position of the player when the input was applied */
+        cugl::Vec2 position;
+        /** The velocity of the player when the input was applied */
+        cugl::Vec2 velocity;
+    };
+
+protected:
+//  MARK: - Properties
+
+    /** The inputs not yet acknowledged by the host, as a ring */
+    std::vector<Input> _inputs;
+    /** The index of the oldest input in the ring */
+    int _head;
+    /** The number of inputs in the ring */
+    int _count;
+    /** The sequence number of the next input */
+    Uint16 _next;
+    /** The number of times the player was corrected */
+    int _corrections;
+    /** The distance between the host state and the prediction for the last acknowledged input */
+    float _lastError;
+
+public:
+//  MARK: - Constructors
+
+    /**
+     * Constructs a Prediction Buffer
+     */
+    PredictionBuffer() : _head(0), _count(0), _next(0), _corrections(0), _lastError(0) {}
+
+    /**
+     * Initializes a Prediction Buffer holding up to the given number of inputs
+     */
+    bool init(int capacity);
+
+//  MARK: - Methods
+
+    /**
+     * Forgets every input, keeping the sequence numbers and the correction count
+     */
+    void clear() { _head = 0; _count = 0; }
+
+    /**
+     * Records an input applied in the given state, returning its sequence number
+     */
+    Uint16 record(cugl::Vec2 movement, bool tackling, float timestep, cugl::Vec2 position, cugl::Vec2 velocity);
+
+    /**
+     * Returns the sequence number of the last recorded input
+     */
+    Uint16 getSequence() const { return _next - 1; }
+
+    /**
+     * Compares the host state for an input with the prediction, rewinding and replaying on a mismatch
+     *
+     * Returns true iff the player was corrected.
+     */
+    bool reconcile(const std::shared_ptr<PlayerModel>& player, Uint16 sequence,
+                   cugl::Vec2 position, cugl::Vec2 velocity, float threshold);
+
+    /**
+     * Returns the number of inputs not yet acknowledged by the host
+     */
+    int getPendingCount() const { return _count; }
+
+    /**
+     * Returns the number of times the player was corrected
+     */
+    int getCorrectionCount() const { return _corrections; }
+
+    /**
+     * Returns the distance between the host state and the prediction for the last acknowledged input
+     */
+    float getLastError() const { return _lastError; }
+
+private:
+//  MARK: - Helpers
+
+    /**
+     * Returns the input that is the given number of inputs after the oldest
+     */
+    Input& at(int offset) { return _inputs[(_head + offset) % _inputs.size()]; }
+
+};
+
+#endif /* __LCMP_PREDICTION_BUFFER_H__ */
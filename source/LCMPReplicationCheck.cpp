@@ -0,0 +1,147 @@
+//
+//  LCMPReplicationCheck.cpp
+//  Low Control Mall Patrol
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#include "LCMPReplicationCheck.h"
+#include "LCMPConstants.h"
+
+using namespace cugl;
+using namespace std;
+
+//  MARK: - Constructors
+
+/**
+ * Disposes of all resources in this instance of Replication Check
+ */
+void ReplicationCheck::dispose() {
+    _source = nullptr;
+    _sourceWorld = nullptr;
+    _mirror = nullptr;
+    _mirrorWorld = nullptr;
+    _serializer.reset();
+}
+
+/**
+ * Initializes a Replication Check for a live game of the given level
+ *
+ * Both copies add the same obstacles in the same order as the live game, so they share its
+ * slots, which replication and the state of the live world rely on.
+ */
+bool ReplicationCheck::init(const shared_ptr<GameModel>& game, const string& level, Uint32 seed) {
+    dispose();
+    Rect bounds(0, 0, game->getMapWidth(), game->getMapHeight());
+    _sourceWorld = physics2::ObstacleWorld::alloc(bounds, Vec2::ZERO);
+    _mirrorWorld = physics2::ObstacleWorld::alloc(bounds, Vec2::ZERO);
+    _source = buildCopy(_sourceWorld, level);
+    _mirror = buildCopy(_mirrorWorld, level);
+    if (_source == nullptr || _mirror == nullptr) {
+        CULogError("Could not check the replication of level %s", level.c_str());
+        dispose();
+        return false;
+    }
+
+    for (auto& world : { _sourceWorld, _mirrorWorld }) {
+        world->setStatePrecision(REPLICATION_SPEED, REPLICATION_POSITION_BITS,
+                                 REPLICATION_ANGLE_BITS, REPLICATION_VELOCITY_BITS);
+    }
+    _random.seed(seed);
+    reset();
+    resetStats();
+    return true;
+}
+
+//  MARK: - Methods
+
+/**
+ * Restarts the replication with a keyframe, as at the start of a round
+ */
+void ReplicationCheck::reset() {
+    if (_sourceWorld == nullptr) return;
+    _sourceWorld->resetState();
+    _keyframeLost = false;
+    _messages = 0;
+}
+
+/**
+ * Replicates the state of the live world, and measures the copy against the live game
+ *
+ * Every REPLICATION_KEYFRAMES messages is a keyframe, and any message may be lost. A delta
+ * must be applied iff the last keyframe arrived, and the players of an applied message must
+ * be within a quantization step or so of the live ones.
+ */
+void ReplicationCheck::check(const shared_ptr<GameModel>& game, const shared_ptr<physics2::ObstacleWorld>& world) {
+    if (_sourceWorld == nullptr) return;
+    _sourceWorld->updateFromState(world->getState());
+
+    _serializer.reset();
+    bool keyframe = _sourceWorld->writeState(_serializer, _messages % REPLICATION_KEYFRAMES == 0);
+    const vector<uint8_t>& message = _serializer.serialize();
+    _bytes += message.size();
+    _messages++;
+    _sent++;
+
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    if (unit(_random) < REPLICATION_LOSS) {
+        _lost++;
+        _keyframeLost = _keyframeLost || keyframe;
+        return;
+    }
+    if (keyframe) _keyframeLost = false;
+
+    _deserializer.receive(message);
+    bool applied = _mirrorWorld->readState(_deserializer);
+    if (!applied) _dropped++;
+    if (applied == _keyframeLost) _mismatches++;
+    if (!applied) return;
+
+    float error = (_mirror->getThief()->getPosition() - game->getThief()->getPosition()).length();
+    for (int i = 0; i < game->numberOfCops(); i++) {
+        error = max(error, (_mirror->getCop(i)->getPosition() - game->getCop(i)->getPosition()).length());
+    }
+    _maxError = max(_maxError, error);
+}
+
+/**
+ * Resets the stats
+ */
+void ReplicationCheck::resetStats() {
+    _lost = 0;
+    _dropped = 0;
+    _mismatches = 0;
+    _bytes = 0;
+    _sent = 0;
+    _maxError = 0;
+}
+
+/**
+ * Logs the stats on a single line
+ *
+ * The error is logged next to the quantization step of a position, which it should not
+ * exceed by much.
+ */
+void ReplicationCheck::logStats() const {
+    if (_sourceWorld == nullptr) return;
+    Size size = _sourceWorld->getBounds().size;
+    float step = max(size.width, size.height) / ((1UL << REPLICATION_POSITION_BITS) - 1);
+    CULog("Replication: %d messages (avg %.1f bytes), %d lost, %d deltas dropped, %d mismatched, error %.4f (step %.4f)",
+          _sent, _sent == 0 ? 0.0f : (float)_bytes / _sent, _lost, _dropped, _mismatches, _maxError, step);
+}
+
+//  MARK: - Helpers
+
+/**
+ * Returns a headless copy of the level in a world that spans the map, or nullptr if it could not be built
+ */
+shared_ptr<GameModel> ReplicationCheck::buildCopy(const shared_ptr<physics2::ObstacleWorld>& world,
+                                                  const string& level) {
+    shared_ptr<physics2::ObstacleWorld> target = world;
+    shared_ptr<scene2::SceneNode> none = nullptr;
+    shared_ptr<scene2::ActionManager> actions = nullptr;
+    shared_ptr<GameModel> copy = make_shared<GameModel>();
+    if (!copy->init(target, none, none, none, nullptr, 1.0f, level, actions, "")) return nullptr;
+    return copy;
+}
@@ -0,0 +1,118 @@
+//
+//  LCMPReplicationCheck.h
+//  Low Control Mall Patrol
+//
+//  This class checks the state replication of the physics world against a live
+//  game. It builds two headless copies of the level, each in a world that spans
+//  the whole map (the game world is only as large as the screen, and positions
+//  are quantized over the bounds). Every frame the first copy takes on the state
+//  of the live world and writes it as a keyframe or a delta, and the second copy
+//  reads it back, unless the message is lost on the way.
+//
+//  The check measures how far the players of the second copy are from the live
+//  ones, and that a delta is dropped exactly when its keyframe was lost.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#ifndef __LCMP_REPLICATION_CHECK_H__
+#define __LCMP_REPLICATION_CHECK_H__
+#include <cugl/cugl.h>
+#include <random>
+#include "LCMPGameModel.h"
+
+class ReplicationCheck {
+protected:
+//  MARK: - Properties
+
+    /** The copy of the game that writes the state */
+    std::shared_ptr<GameModel> _source;
+    /** The world of the copy that writes the state */
+    std::shared_ptr<cugl::physics2::ObstacleWorld> _sourceWorld;
+    /** The copy of the game that reads the state */
+    std::shared_ptr<GameModel> _mirror;
+    /** The world of the copy that reads the state */
+    std::shared_ptr<cugl::physics2::ObstacleWorld> _mirrorWorld;
+    /** The serializer of the state messages */
+    cugl::NetworkSerializer _serializer;
+    /** The deserializer of the state messages */
+    cugl::NetworkDeserializer _deserializer;
+    /** The random number generator of the losses */
+    std::mt19937 _random;
+    /** Whether the last keyframe was lost */
+    bool _keyframeLost;
+
+    /** The number of messages written since the round started */
+    int _messages;
+    /** The number of messages lost since the stats were reset */
+    int _lost;
+    /** The number of deltas dropped since the stats were reset */
+    int _dropped;
+    /** The number of messages applied (or dropped) when they should not have been */
+    int _mismatches;
+    /** The total size (in bytes) of the messages since the stats were reset */
+    size_t _bytes;
+    /** The number of messages since the stats were reset */
+    int _sent;
+    /** The largest distance between a live player and its copy since the stats were reset */
+    float _maxError;
+
+public:
+//  MARK: - Constructors
+
+    /**
+     * Constructs a Replication Check
+     */
+    ReplicationCheck() : _keyframeLost(false), _messages(0), _lost(0), _dropped(0), _mismatches(0),
+    _bytes(0), _sent(0), _maxError(0) {}
+
+    /**
+     * Destructs a Replication Check
+     */
+    ~ReplicationCheck() { dispose(); }
+
+    /**
+     * Disposes of all resources in this instance of Replication Check
+     */
+    void dispose();
+
+    /**
+     * Initializes a Replication Check for a live game of the given level
+     */
+    bool init(const std::shared_ptr<GameModel>& game, const std::string& level, Uint32 seed);
+
+//  MARK: - Methods
+
+    /**
+     * Restarts the replication with a keyframe, as at the start of a round
+     */
+    void reset();
+
+    /**
+     * Replicates the state of the live world, and measures the copy against the live game
+     */
+    void check(const std::shared_ptr<GameModel>& game, const std::shared_ptr<cugl::physics2::ObstacleWorld>& world);
+
+    /**
+     * Resets the stats
+     */
+    void resetStats();
+
+    /**
+     * Logs the stats on a single line
+     */
+    void logStats() const;
+
+private:
+//  MARK: - Helpers
+
+    /**
+     * Returns a headless copy of the level in a world that spans the map, or nullptr if it could not be built
+     */
+    std::shared_ptr<GameModel> buildCopy(const std::shared_ptr<cugl::physics2::ObstacleWorld>& world,
+                                         const std::string& level);
+
+};
+
+#endif /* __LCMP_REPLICATION_CHECK_H__ */
@@ -0,0 +1,210 @@
+//
+//  LCMPSimulationController.cpp
+//  Low Control Mall Patrol
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#include "LCMPSimulationController.h"
+#include "LCMPConstants.h"
+
+using namespace cugl;
+using namespace std;
+
+//  MARK: - Constructors
+
+/**
+ * Disposes of all resources in this instance of Simulation Controller
+ */
+void SimulationController::dispose() {
+    _game = nullptr;
+    _world = nullptr;
+    _network = nullptr;
+}
+
+/**
+ * Initializes a Simulation Controller for a game that was just built, and starts the round
+ */
+bool SimulationController::init(const shared_ptr<GameModel>& game,
+                                const shared_ptr<physics2::ObstacleWorld>& world,
+                                const shared_ptr<NetworkController>& network, bool host) {
+    _game = game;
+    _world = world;
+    _network = network;
+    _isHost = host;
+    _playerNumber = _network->getPlayerNumber();
+    _gameTime = 0;
+    _accumulator = 0;
+    _pendingActivate = false;
+    _pendingSwipe = false;
+    _pendingTackle = Vec2::ZERO;
+
+    _network->setMapBounds(Rect(0, 0, _game->getMapWidth(), _game->getMapHeight()));
+    _network->startRound();
+    return true;
+}
+
+//  MARK: - Methods
+
+/**
+ * Rewinds the game to the start of a new round
+ */
+void SimulationController::reset() {
+    _gameTime = 0;
+    _accumulator = 0;
+    _pendingActivate = false;
+    _pendingSwipe = false;
+    _pendingTackle = Vec2::ZERO;
+
+    _game->restore();
+    _network->startRound();
+}
+
+/**
+ * Advances the round clock, returning true iff the round has run out of time
+ *
+ * The clock follows the host once it is known, so that every peer ends the round together.
+ */
+bool SimulationController::updateClock(float timestep) {
+    _gameTime = _network->hasRoundClock() ? _network->getRoundTime() : _gameTime + timestep;
+    return _gameTime > GAME_LENGTH;
+}
+
+/**
+ * Runs the simulation steps that fit in the time accumulated so far, returning how many ran
+ *
+ * Every step has the same length, whatever the frame rate, so that the physics (and the
+ * predictions replayed from recorded inputs) behave the same on every device. A switch or
+ * swipe is held until a step runs, so that a fast frame with no step cannot lose it. The
+ * players are then drawn part of the way between the last two steps.
+ */
+int SimulationController::step(float timestep, Vec2 movement, bool activate, bool swipe, Vec2 tackle) {
+    _pendingActivate = _pendingActivate || activate;
+    if (swipe) {
+        _pendingSwipe = true;
+        _pendingTackle = tackle;
+    }
+
+    _accumulator += timestep;
+    int steps = 0;
+    while (_accumulator >= SIMULATION_STEP && steps < MAX_SUBSTEPS) {
+        updateLocal(SIMULATION_STEP, movement, _pendingActivate, _pendingSwipe, _pendingTackle);
+        updateNetwork(SIMULATION_STEP);
+        _world->update(SIMULATION_STEP);
+        _game->update(SIMULATION_STEP);
+        _pendingActivate = false;
+        _pendingSwipe = false;
+        _pendingTackle = Vec2::ZERO;
+        _accumulator -= SIMULATION_STEP;
+        steps++;
+    }
+
+    // Drop the time the step budget did not cover, so that the game slows down instead
+    if (_accumulator >= SIMULATION_STEP) {
+        _accumulator = fmodf(_accumulator, SIMULATION_STEP);
+    }
+    _game->interpolate(_accumulator / SIMULATION_STEP);
+    return steps;
+}
+
+/**
+ * Ends the round, telling the other players if this is the host
+ */
+void SimulationController::endRound() {
+    _game->setGameOver(true);
+    if (_isHost) _network->sendGameOver();
+}
+
+/**
+ * Returns true iff the round is over, ending it if the host sees a catch
+ *
+ * Only the host decides catches. The other players learn of them over the network.
+ */
+bool SimulationController::checkGameOver() {
+    for (int i = 0; i < _game->numberOfCops(); i++) {
+        if (_game->getCop(i)->getCaughtThief() && _isHost) _game->setGameOver(true);
+    }
+    if (_game->isGameOver() && _isHost) _network->sendGameOver();
+    return _game->isGameOver();
+}
+
+//  MARK: - Helpers
+
+/**
+ * Updates local players (own player and non-playing players)
+ */
+void SimulationController::updateLocal(float timestep, Vec2 movement, bool dtap, bool swipe, Vec2 tackle) {
+    // Update non-playing players if host
+    if (_isHost) {
+        for (int i = 0; i < 5; i++) {
+            int copID = _network->getPlayer(i).playerNumber;
+            if (!_network->isPlayerConnected(i) && copID != -1 && copID != _playerNumber) {
+                updateCop(timestep, copID, Vec2::ZERO, false, Vec2::ZERO, dtap);
+            }
+        }
+    }
+
+    // Update own player
+    bool isThief = _playerNumber == -1;
+    if (isThief) updateThief(timestep, movement, dtap);
+    else updateCop(timestep, _playerNumber, movement, swipe, tackle, dtap);
+
+    // Record the input so it can be replayed if the host disagrees with it
+    shared_ptr<PlayerModel> player = isThief
+        ? (shared_ptr<PlayerModel>) _game->getThief()
+        : (shared_ptr<PlayerModel>) _game->getCop(_playerNumber);
+    bool tackling = !isThief && (swipe || _game->getCop(_playerNumber)->getTackling());
+    _network->recordInput(player, movement, tackling, timestep);
+}
+
+/**
+ * Updates and networks the thief and any actions it can perform
+ */
+void SimulationController::updateThief(float timestep, Vec2 movement, bool dtap) {
+    // Update and network thief movement
+    _game->updateThief(movement);
+    _network->sendThiefMovement(movement);
+
+    // Activate and network traps
+    int trapID = _game->getThief()->trapActivationFlag;
+    if (dtap && trapID != -1) {
+        _game->activateTrap(trapID);
+        _network->sendTrapActivation(trapID);
+    }
+}
+
+/**
+ * Updates and networks a cop and any actions it can perform
+ */
+void SimulationController::updateCop(float timestep, int copID, Vec2 movement, bool swipe, Vec2 tackle, bool dtap) {
+    // Get some reusable variables
+    shared_ptr<CopModel> cop = _game->getCop(copID);
+    Vec2 thiefPosition = _game->getThief()->getPosition();
+
+    int trapID = cop->trapDeactivationFlag;
+    if (dtap && trapID != -1) {
+        _game->deactivateTrap(trapID);
+        //TODO: JUDE PLEASE FIX THIS NETWORK THING IDK HOW - Tony
+        //_network->sendTrapActivation(trapID);
+    }
+
+    // Update, animate, and network cop movement
+    _game->updateCop(movement, thiefPosition, copID, timestep);
+    _network->sendCopMovement(movement, copID);
+
+    // Attempt tackle if appropriate
+    if (swipe && !cop->getTackling()) {
+        cop->attemptTackle(thiefPosition, tackle);
+    }
+}
+
+/**
+ * Updates based on data received over the network
+ */
+void SimulationController::updateNetwork(float timestep) {
+    _network->update(_game);
+    _network->interpolate(_game, timestep);
+    _network->sendTick(_game, timestep);
+    // TODO: Add stuff here for migrating host, connection status, etc.
+}
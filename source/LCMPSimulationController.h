@@ -0,0 +1,130 @@
+//
+//  LCMPSimulationController.h
+//  Low Control Mall Patrol
+//
+//  This class runs the simulation of a game, without any view. It keeps the
+//  round clock, advances the game in fixed steps (applying the own player's
+//  input, the cops the host drives, and the network), and decides when the
+//  round is over. The game scene and the headless bots both play through it,
+//  so that bots step and predict exactly as players do.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#ifndef __LCMP_SIMULATION_CONTROLLER_H__
+#define __LCMP_SIMULATION_CONTROLLER_H__
+#include <cugl/cugl.h>
+#include "LCMPNetworkController.h"
+#include "LCMPGameModel.h"
+
+class SimulationController {
+protected:
+//  MARK: - Properties
+
+    /** The game being simulated */
+    std::shared_ptr<GameModel> _game;
+    /** The physics world of the game */
+    std::shared_ptr<cugl::physics2::ObstacleWorld> _world;
+    /** The network controller of this player */
+    std::shared_ptr<NetworkController> _network;
+
+    /** Whether this player is the host */
+    bool _isHost;
+    /** The player number of this player (-1 for the thief) */
+    int _playerNumber;
+    /** The time (in seconds) since the round started */
+    float _gameTime;
+    /** The frame time not yet simulated, always less than one simulation step */
+    float _accumulator;
+    /** Whether a switch was pressed since the last simulation step */
+    bool _pendingActivate;
+    /** Whether a swipe was made since the last simulation step */
+    bool _pendingSwipe;
+    /** The direction of the swipe made since the last simulation step */
+    cugl::Vec2 _pendingTackle;
+
+public:
+//  MARK: - Constructors
+
+    /**
+     * Constructs a Simulation Controller
+     */
+    SimulationController() : _isHost(false), _playerNumber(0), _gameTime(0), _accumulator(0),
+    _pendingActivate(false), _pendingSwipe(false) {}
+
+    /**
+     * Destructs a Simulation Controller
+     */
+    ~SimulationController() { dispose(); }
+
+    /**
+     * Disposes of all resources in this instance of Simulation Controller
+     */
+    void dispose();
+
+    /**
+     * Initializes a Simulation Controller for a game that was just built, and starts the round
+     */
+    bool init(const std::shared_ptr<GameModel>& game,
+              const std::shared_ptr<cugl::physics2::ObstacleWorld>& world,
+              const std::shared_ptr<NetworkController>& network, bool host);
+
+//  MARK: - Methods
+
+    /**
+     * Rewinds the game to the start of a new round
+     */
+    void reset();
+
+    /**
+     * Returns the time (in seconds) since the round started
+     */
+    float getGameTime() const { return _gameTime; }
+
+    /**
+     * Advances the round clock, returning true iff the round has run out of time
+     */
+    bool updateClock(float timestep);
+
+    /**
+     * Runs the simulation steps that fit in the time accumulated so far
+     */
+    int step(float timestep, cugl::Vec2 movement, bool activate, bool swipe, cugl::Vec2 tackle);
+
+    /**
+     * Ends the round, telling the other players if this is the host
+     */
+    void endRound();
+
+    /**
+     * Returns true iff the round is over, ending it if the host sees a catch
+     */
+    bool checkGameOver();
+
+private:
+//  MARK: - Helpers
+
+    /**
+     * Updates local players (own player and non-playing players)
+     */
+    void updateLocal(float timestep, cugl::Vec2 movement, bool dtap, bool swipe, cugl::Vec2 tackle);
+
+    /**
+     * Updates and networks the thief and any actions it can perform
+     */
+    void updateThief(float timestep, cugl::Vec2 movement, bool dtap);
+
+    /**
+     * Updates and networks a cop and any actions it can perform
+     */
+    void updateCop(float timestep, int copID, cugl::Vec2 movement, bool swipe, cugl::Vec2 tackle, bool dtap);
+
+    /**
+     * Updates based on data received over the network
+     */
+    void updateNetwork(float timestep);
+
+};
+
+#endif /* __LCMP_SIMULATION_CONTROLLER_H__ */
@@ -0,0 +1,131 @@
+//
+//  LCMPSnapshotBuffer.cpp
+//  Low Control Mall Patrol
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#include "LCMPSnapshotBuffer.h"
+
+/** How far (in seconds) the playback may drift from its target before it jumps there */
+#define PLAYBACK_SNAP       0.25f
+/** How quickly (per second) the playback is pulled towards its target */
+#define PLAYBACK_CATCHUP    2.0f
+
+using namespace cugl;
+
+//  MARK: - Constructors
+
+/**
+ * Initializes a Snapshot Buffer for snapshots of the given width
+ */
+bool SnapshotBuffer::init(int width, int interpolated, int capacity) {
+    CUAssertLog(width >= 4 && interpolated <= width, "Snapshots start with a position and a velocity");
+    _width = width;
+    _interpolated = interpolated;
+    _values.assign(capacity * width, 0);
+    _times.assign(capacity, 0);
+    resetCounts();
+    clear();
+    return true;
+}
+
+//  MARK: - Methods
+
+/**
+ * Removes every snapshot and restarts the playback, keeping the counts
+ */
+void SnapshotBuffer::clear() {
+    _head = 0;
+    _count = 0;
+    _playback = 0;
+    _sinceNewest = 0;
+    _playing = false;
+    _hasSenderTime = false;
+}
+
+/**
+ * Adds a snapshot taken at the given sender time, ignoring it if it is older than the newest
+ */
+void SnapshotBuffer::push(float time, const float* values) {
+    if (_times.empty()) return;
+    if (_count > 0 && time <= _times[slot(_count - 1)]) return;
+
+    // Overwrite the oldest snapshot when full
+    if (_count == _times.size()) {
+        _head = slot(1);
+        _count--;
+    }
+    int index = slot(_count);
+    _times[index] = time;
+    std::copy(values, values + _width, _values.begin() + index * _width);
+    _count++;
+    _sinceNewest = 0;
+}
+
+/**
+ * Advances the playback by the timestep and samples the snapshots at the playback time
+ *
+ * The playback time trails the sender time by the given delay, and is slowly pulled
+ * towards it so that jitter is absorbed. Without a synchronized clock, the sender time is
+ * estimated as the time of the newest snapshot plus the time since it arrived.
+ */
+SnapshotBuffer::Sample SnapshotBuffer::sample(float timestep, float delay, float maxExtrapolation,
+                                              float* values) {
+    if (_count == 0) return Empty;
+
+    // The sender is about as far past its newest snapshot as we are past receiving it
+    _sinceNewest += timestep;
+    float now = _hasSenderTime ? _senderTime : _times[slot(_count - 1)] + _sinceNewest;
+    float target = now - delay;
+    if (!_playing) {
+        _playback = target;
+        _playing = true;
+    } else {
+        _playback += timestep;
+        float error = target - _playback;
+        if (fabsf(error) > PLAYBACK_SNAP) _playback = target;
+        else _playback += error * std::min(1.0f, PLAYBACK_CATCHUP * timestep);
+    }
+
+    // Drop the snapshots that playback has moved past
+    while (_count >= 2 && _times[slot(1)] <= _playback) {
+        _head = slot(1);
+        _count--;
+    }
+
+    const float* from = valuesAt(_head);
+    float fromTime = _times[_head];
+    std::copy(from, from + _width, values);
+    if (_playback < fromTime) {
+        _extrapolations++;
+        return Held;
+    }
+
+    if (_count >= 2) {
+        const float* to = valuesAt(slot(1));
+        float alpha = (_playback - fromTime) / (_times[slot(1)] - fromTime);
+        for (int ii = 0; ii < _interpolated; ii++) {
+            values[ii] += (to[ii] - from[ii]) * alpha;
+        }
+        _interpolations++;
+        return Interpolated;
+    }
+
+    // Packets are late, so carry on from the newest snapshot for a little while
+    float ahead = _playback - fromTime;
+    Sample result = Extrapolated;
+    if (ahead > maxExtrapolation) {
+        ahead = maxExtrapolation;
+        result = Held;
+    }
+    values[0] += values[2] * ahead;
+    values[1] += values[3] * ahead;
+    if (result == Held) {
+        values[2] = 0;
+        values[3] = 0;
+    }
+    _extrapolations++;
+    return result;
+}
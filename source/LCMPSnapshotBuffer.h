@@ -0,0 +1,152 @@
+//
+//  LCMPSnapshotBuffer.h
+//  Low Control Mall Patrol
+//
+//  This class buffers the snapshots of a remote player, keyed by the time the
+//  sender took them. The player is shown a short delay behind the newest
+//  snapshot, interpolating between the two snapshots around that time, so that
+//  jitter in packet spacing never shows. When packets are late, the player is
+//  extrapolated from the newest snapshot for a bounded time.
+//
+//  A snapshot is an array of values whose first four values are a position and
+//  a velocity; the leading values are interpolated, and the rest are held from
+//  the older of the two snapshots.
+//
+//  Author: Kevin Games
+//  Version: 4/28/22
+//
+
+#ifndef __LCMP_SNAPSHOT_BUFFER_H__
+#define __LCMP_SNAPSHOT_BUFFER_H__
+#include <cugl/cugl.h>
+
+class SnapshotBuffer {
+public:
+    /** How a sampled snapshot was produced */
+    enum Sample {
+        /** There are no snapshots to sample */
+        Empty,
+        /** Interpolated between two snapshots */
+        Interpolated,
+        /** Extrapolated past the newest snapshot */
+        Extrapolated,
+        /** Held at the end of the extrapolation bound, or before the oldest snapshot */
+        Held
+    };
+
+protected:
+//  MARK: - Properties
+
+    /** The snapshot values, stored as a ring of capacity * width floats */
+    std::vector<float> _values;
+    /** The sender time of each snapshot in the ring */
+    std::vector<float> _times;
+    /** The number of values in a snapshot */
+    int _width;
+    /** The number of leading values that are interpolated */
+    int _interpolated;
+    /** The index of the oldest snapshot in the ring */
+    int _head;
+    /** The number of snapshots in the ring */
+    int _count;
+    /** The sender time being displayed */
+    float _playback;
+    /** The time since the newest snapshot arrived */
+    float _sinceNewest;
+    /** Whether the playback time has been set by a first sample */
+    bool _playing;
+    /** The sender time now, if it is known from a synchronized clock */
+    float _senderTime;
+    /** Whether the sender time is known, rather than estimated from arrivals */
+    bool _hasSenderTime;
+    /** The number of samples that were interpolated */
+    int _interpolations;
+    /** The number of samples that were extrapolated (or held) */
+    int _extrapolations;
+
+public:
+//  MARK: - Constructors
+
+    /**
+     * Constructs a Snapshot Buffer
+     */
+    SnapshotBuffer() : _width(0), _interpolated(0), _head(0), _count(0), _playback(0),
+    _sinceNewest(0), _playing(false), _senderTime(0), _hasSenderTime(false),
+    _interpolations(0), _extrapolations(0) {}
+
+    /**
+     * Initializes a Snapshot Buffer for snapshots of the given width
+     */
+    bool init(int width, int interpolated, int capacity);
+
+//  MARK: - Methods
+
+    /**
+     * Removes every snapshot and restarts the playback, keeping the counts
+     */
+    void clear();
+
+    /**
+     * Adds a snapshot taken at the given sender time, ignoring it if it is older than the newest
+     */
+    void push(float time, const float* values);
+
+    /**
+     * Sets the sender time now, from a synchronized clock, instead of estimating it from arrivals
+     */
+    void setSenderTime(float time) { _senderTime = time; _hasSenderTime = true; }
+
+    /**
+     * Advances the playback by the timestep and samples the snapshots at the playback time
+     *
+     * The playback time trails the sender time by the given delay, and is slowly pulled
+     * towards it so that jitter is absorbed.
+     */
+    Sample sample(float timestep, float delay, float maxExtrapolation, float* values);
+
+    /**
+     * Returns the number of buffered snapshots (the one being left, and the ones ahead of it)
+     */
+    int getDepth() const { return _count; }
+
+    /**
+     * Returns the maximum number of buffered snapshots
+     */
+    int getCapacity() const { return (int)_times.size(); }
+
+    /**
+     * Returns the number of samples that were interpolated
+     */
+    int getInterpolationCount() const { return _interpolations; }
+
+    /**
+     * Returns the number of samples that were extrapolated (or held)
+     */
+    int getExtrapolationCount() const { return _extrapolations; }
+
+    /**
+     * Returns the sender time being displayed
+     */
+    float getPlaybackTime() const { return _playback; }
+
+    /**
+     * Resets the interpolation and extrapolation counts
+     */
+    void resetCounts() { _interpolations = 0; _extrapolations = 0; }
+
+private:
+//  MARK: - Helpers
+
+    /**
+     * Returns the ring index of the snapshot that is the given number of snapshots after the oldest
+     */
+    int slot(int offset) const { return (_head + offset) % (int)_times.size(); }
+
+    /**
+     * Returns the values of the snapshot in the given ring slot
+     */
+    const float* valuesAt(int slot) const { return _values.data() + slot * _width; }
+
+};
+
+#endif /* __LCMP_SNAPSHOT_BUFFER_H__ */
@@ -52,22 +52,25 @@ bool ThiefModel::init(float scale,
     // Call the parent's initializer
     PlayerModel::init(-1, Vec2::ZERO, size, scale, node, actions);
     
-    // Set up the textures for all directions
-    bool female = (skinKey.back() == 'F');
+    // A headless thief (as for a bot client) has no textures or sprites
+    if (assets != nullptr) {
+        // Set up the textures for all directions
+        bool female = (skinKey.back() == 'F');
 //    skinKey == "THIEF_RUN_RIGHT_F" ? female = true : female = false;
 //    female = (skinKey.back() == 'F') ? true : false;
 //    skinKey = (skinKey != "THIEF_RUN_RIGHT") ? "MALE_HATLESS" : "THIEF_RUN_RIGHT";
     
-    _spriteSheets.push_back(assets->get<Texture>(skinKey));
-    _spriteSheets.push_back(assets->get<Texture>(THIEF_RUN_BACK));
-    !female ? _spriteSheets.push_back(assets->get<Texture>(THIEF_RUN_LEFT)) : _spriteSheets.push_back(assets->get<Texture>(THIEF_RUN_LEFT_F));
-    _spriteSheets.push_back(assets->get<Texture>(THIEF_RUN_FRONT));
-    !female ? _spriteSheets.push_back(assets->get<Texture>(THIEF_IDLE_RIGHT)) :  _spriteSheets.push_back(assets->get<Texture>(THIEF_IDLE_RIGHT_F));
-    !female ? _spriteSheets.push_back(assets->get<Texture>(THIEF_IDLE_LEFT)) : _spriteSheets.push_back(assets->get<Texture>(THIEF_IDLE_LEFT_F));
+        _spriteSheets.push_back(assets->get<Texture>(skinKey));
+        _spriteSheets.push_back(assets->get<Texture>(THIEF_RUN_BACK));
+        !female ? _spriteSheets.push_back(assets->get<Texture>(THIEF_RUN_LEFT)) : _spriteSheets.push_back(assets->get<Texture>(THIEF_RUN_LEFT_F));
+        _spriteSheets.push_back(assets->get<Texture>(THIEF_RUN_FRONT));
+        !female ? _spriteSheets.push_back(assets->get<Texture>(THIEF_IDLE_RIGHT)) :  _spriteSheets.push_back(assets->get<Texture>(THIEF_IDLE_RIGHT_F));
+        !female ? _spriteSheets.push_back(assets->get<Texture>(THIEF_IDLE_LEFT)) : _spriteSheets.push_back(assets->get<Texture>(THIEF_IDLE_LEFT_F));
     
-    // Initialize the first texture. Note: width is in screen coordinates
-    float width = size.width * scale * 1.5f;
-    setSpriteNodes(width); 
+        // Initialize the first texture. Note: width is in screen coordinates
+        float width = size.width * scale * 1.5f;
+        setSpriteNodes(width); 
+    }
     // TODO: Get rid of the magic numbers in the lines above.
 
     b2Filter fitler = b2Filter();
@@ -60,6 +60,11 @@ public:
      */
     cugl::Vec2 getAcceleration() override { return cugl::Vec2( THIEF_ACCELERATION_DEFAULT * _accelerationMultiplier.x, THIEF_ACCELERATION_DEFAULT * _accelerationMultiplier.y); }
     
+    /**
+     * Clears the trap activation so the thief can start a new round
+     */
+    void reset() override { PlayerModel::reset(); trapActivationFlag = -1; }
+    
 };
 
 #endif /* __LCMP_THIEF_MODEL_H__ */
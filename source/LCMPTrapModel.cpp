@@ -7,6 +7,7 @@
 //
 
 #include "LCMPTrapModel.h"
+#include "LCMPEntityTag.h"
 #include <cugl/cugl.h>
 
 using namespace std;
@@ -35,6 +36,8 @@ bool TrapModel::init(int trapID,
                      bool sfxOn, std::string sfxKey) {
     _trapID = trapID;
     activated = activated_;
+    _initialActivated = activated_;
+    _initialUses = numUses;
     thiefEffectArea = thiefArea;
     copEffectArea = copArea;
     triggerArea = triggerArea_;
@@ -75,6 +78,12 @@ bool TrapModel::init(int trapID,
     deactivationFilter.categoryBits = 0b01000;
     deactivationArea->setFilterData(deactivationFilter);
 
+    // Tag the fixtures so collisions can identify this trap
+    thiefEffectArea->setUserData(EntityTag::encode(EntityTag::Trap, 0, trapID, EntityTag::ThiefEffect));
+    copEffectArea->setUserData(EntityTag::encode(EntityTag::Trap, 0, trapID, EntityTag::CopEffect));
+    triggerArea->setUserData(EntityTag::encode(EntityTag::Trap, 0, trapID, EntityTag::Trigger));
+    deactivationArea->setUserData(EntityTag::encode(EntityTag::Trap, 0, trapID, EntityTag::Deactivation));
+
     return true;
 }
 /**
@@ -148,6 +157,11 @@ void TrapModel::setAssets(Vec2 position, Vec2 dims,
     // Set the nodes' scales
     _activationTriggerNode->setScale(PROP_SCALE*2);
     _deactivationTriggerNode->setScale(PROP_SCALE*2);
+    
+    // Skip the nodes when they are off camera
+    _assetNode->setCullable(true);
+    _activationTriggerNode->setCullable(true);
+    _deactivationTriggerNode->setCullable(true);
     //
 
 
@@ -194,6 +208,30 @@ bool TrapModel::use() {
     return true;
 }
 
+/**
+ * Returns this trap to the state it started the round in
+ */
+void TrapModel::reset() {
+    activated = _initialActivated;
+    usesRemaining = _initialUses;
+    activating = false;
+    prevTime = 0;
+    thiefEffectArea->setSensor(true);
+    copEffectArea->setSensor(true);
+    
+    // Show the same nodes as setAssets
+    _activationTriggerNode->removeFromParent();
+    _deactivationTriggerNode->removeFromParent();
+    if (!activated) {
+        _assetNode->setFrame(0);
+        _node->addChild(_activationTriggerNode);
+    }
+    else {
+        _node->addChild(_deactivationTriggerNode);
+        _assetNode->setFrame(_assetNodeFrameCount-1);
+    }
+}
+
 /**
  * Begins the activate animation for traps
  */
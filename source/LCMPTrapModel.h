@@ -80,6 +80,10 @@ protected:
 	bool thiefCollide;
 	/** Number of times this trap can be used on a player. -1 to indicate infinite uses*/
 	int usesRemaining;
+    /** Whether the trap starts the round activated */
+    bool _initialActivated;
+    /** Number of times this trap can be used at the start of the round */
+    int _initialUses;
 	/** Thief Effect */
 	std::shared_ptr<Effect> thiefEffect;
     /** Cop Effect */
@@ -293,6 +297,11 @@ public:
      */
     bool use();
     
+    /**
+     * Returns this trap to the state it started the round in
+     */
+    void reset();
+    
     /**
      * Activates this trap.
      */